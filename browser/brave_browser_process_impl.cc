@@ -162,6 +162,8 @@ void BraveBrowserProcessImpl::Init() {
 
 #if !BUILDFLAG(IS_ANDROID)
 void BraveBrowserProcessImpl::StartTearDown() {
+  if (brave_p3a_service_)
+    brave_p3a_service_->OnShutdown();
   ad_block_service_.reset();
   brave_stats_updater_.reset();
   brave_referrals_service_.reset();
@@ -20,6 +20,10 @@
 
 namespace brave_news {
 
+namespace {
+constexpr char kResponseCacheDirName[] = "Brave News Cache";
+}  // namespace
+
 // static
 BraveNewsControllerFactory* BraveNewsControllerFactory::GetInstance() {
   return base::Singleton<BraveNewsControllerFactory>::get();
@@ -72,9 +76,10 @@ KeyedService* BraveNewsControllerFactory::BuildServiceInstanceFor(
   auto* ads_service = brave_ads::AdsServiceFactory::GetForProfile(profile);
   auto* history_service = HistoryServiceFactory::GetForProfile(
       profile, ServiceAccessType::EXPLICIT_ACCESS);
-  return new BraveNewsController(profile->GetPrefs(), favicon_service,
-                                 ads_service, history_service,
-                                 profile->GetURLLoaderFactory());
+  return new BraveNewsController(
+      profile->GetPrefs(), favicon_service, ads_service, history_service,
+      profile->GetURLLoaderFactory(),
+      profile->GetPath().AppendASCII(kResponseCacheDirName));
 }
 
 content::BrowserContext* BraveNewsControllerFactory::GetBrowserContextToUse(
@@ -289,10 +289,15 @@ bool AdBlockServiceTest::InstallRegionalAdBlockExtension(
 
     EXPECT_EQ(regional_filters_providers.size(), 1ULL);
 
-    auto* regional_engine = g_brave_browser_process->ad_block_service()
-                                ->additional_filters_engine_.get();
-    EngineTestObserver regional_engine_observer(regional_engine);
     auto regional_filters_provider = regional_filters_providers.find(uuid);
+    auto* regional_engine =
+        g_brave_browser_process->ad_block_service()
+            ->GetAdditionalFiltersEngineForTest(
+                regional_filters_provider->second.get());
+    EXPECT_TRUE(regional_engine);
+    if (!regional_engine)
+      return false;
+    EngineTestObserver regional_engine_observer(regional_engine);
     regional_filters_provider->second->OnComponentReady(
         ad_block_extension->path());
     regional_engine_observer.Wait();
@@ -13,6 +13,7 @@
 #include "brave/components/brave_today/common/features.h"
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 #include "brave/components/content_settings/core/browser/brave_content_settings_utils.h"
+#include "brave/components/speedreader/common/buildflags/buildflags.h"
 #include "build/build_config.h"
 #include "chrome/browser/browsing_data/chrome_browsing_data_remover_constants.h"
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
@@ -20,6 +21,12 @@
 #include "chrome/common/buildflags.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 
+#if BUILDFLAG(ENABLE_SPEEDREADER)
+#include "brave/browser/speedreader/speedreader_service_factory.h"
+#include "brave/components/speedreader/speedreader_distilled_cache.h"
+#include "brave/components/speedreader/speedreader_service.h"
+#endif
+
 #if BUILDFLAG(ENABLE_IPFS)
 #include "base/command_line.h"
 #include "base/files/file_path.h"
@@ -65,6 +72,14 @@ void BraveBrowsingDataRemoverDelegate::RemoveEmbedderData(
 #if BUILDFLAG(ENABLE_IPFS)
   if (remove_mask & content::BrowsingDataRemover::DATA_TYPE_CACHE)
     ClearIPFSCache();
+#endif
+#if BUILDFLAG(ENABLE_SPEEDREADER)
+  // Distilled pages reveal the visited articles, and have no timestamps to
+  // clear a time range by.
+  if (remove_mask & (content::BrowsingDataRemover::DATA_TYPE_CACHE |
+                     chrome_browsing_data_remover::DATA_TYPE_HISTORY)) {
+    ClearSpeedreaderCache();
+  }
 #endif
   if (base::FeatureList::IsEnabled(brave_today::features::kBraveNewsFeature)) {
     // Brave News feed cache
@@ -104,6 +119,15 @@ void BraveBrowsingDataRemoverDelegate::ClearShieldsSettings(
   }
 }
 
+#if BUILDFLAG(ENABLE_SPEEDREADER)
+void BraveBrowsingDataRemoverDelegate::ClearSpeedreaderCache() {
+  auto* service =
+      speedreader::SpeedreaderServiceFactory::GetForProfile(profile_);
+  if (service && service->distilled_cache())
+    service->distilled_cache()->Clear();
+}
+#endif  // BUILDFLAG(ENABLE_SPEEDREADER)
+
 #if BUILDFLAG(ENABLE_IPFS)
 void BraveBrowsingDataRemoverDelegate::WaitForIPFSRepoGC(
     base::Process process) {
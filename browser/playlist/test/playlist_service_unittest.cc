@@ -5,9 +5,14 @@
 
 #include "brave/components/playlist/playlist_service.h"
 
+#include <atomic>
+
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/bind.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/timer/timer.h"
@@ -15,6 +20,8 @@
 #include "brave/components/playlist/features.h"
 #include "brave/components/playlist/media_detector_component_manager.h"
 #include "brave/components/playlist/playlist_constants.h"
+#include "brave/components/playlist/playlist_media_file_download_manager.h"
+#include "brave/components/playlist/playlist_media_file_downloader.h"
 #include "brave/components/playlist/playlist_service_helper.h"
 #include "brave/components/playlist/playlist_service_observer.h"
 #include "brave/components/playlist/pref_names.h"
@@ -31,6 +38,7 @@
 #include "content/public/test/browser_task_environment.h"
 #include "content/public/test/test_host_resolver.h"
 #include "net/dns/mock_host_resolver.h"
+#include "net/http/http_request_headers.h"
 #include "net/test/embedded_test_server/embedded_test_server.h"
 #include "net/test/embedded_test_server/http_request.h"
 #include "net/test/embedded_test_server/http_response.h"
@@ -40,8 +48,80 @@
 
 namespace {
 
+constexpr char kLargeMediaFileETag[] = "\"large-media-file\"";
+
+std::atomic<int> g_large_media_file_range_requests{0};
+
+std::string GetLargeMediaFileContent() {
+  return std::string(64 * 1024, 'a') + std::string(64 * 1024, 'b');
+}
+
+// Drops the connection halfway through unless the request asks for a range,
+// in which case the rest of the file is sent.
+std::unique_ptr<net::test_server::HttpResponse> HandleLargeMediaFileRequest(
+    const net::test_server::HttpRequest& request) {
+  const std::string content = GetLargeMediaFileContent();
+  auto range = request.headers.find(net::HttpRequestHeaders::kRange);
+  if (range == request.headers.end()) {
+    return std::make_unique<net::test_server::RawHttpResponse>(
+        base::StringPrintf("HTTP/1.1 200 OK\n"
+                           "Content-Type: video/mp4\n"
+                           "Content-Length: %zu\n"
+                           "Accept-Ranges: bytes\n"
+                           "ETag: %s",
+                           content.size(), kLargeMediaFileETag),
+        content.substr(0, content.size() / 2));
+  }
+
+  size_t offset = 0;
+  auto http_response = std::make_unique<net::test_server::BasicHttpResponse>();
+  if (!base::StartsWith(range->second, "bytes=") ||
+      !base::StringToSizeT(
+          base::TrimString(range->second.substr(6), "-", base::TRIM_TRAILING),
+          &offset) ||
+      offset >= content.size()) {
+    http_response->set_code(net::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+    return http_response;
+  }
+
+  g_large_media_file_range_requests++;
+  http_response->set_code(net::HTTP_PARTIAL_CONTENT);
+  http_response->set_content_type("video/mp4");
+  http_response->AddCustomHeader("ETag", kLargeMediaFileETag);
+  http_response->AddCustomHeader(
+      "Content-Range", base::StringPrintf("bytes %zu-%zu/%zu", offset,
+                                         content.size() - 1, content.size()));
+  http_response->set_content(content.substr(offset));
+  return http_response;
+}
+
+// Sends the first half of the large media file and then keeps the connection
+// open, so the download stays in progress.
+class StalledMediaFileResponse : public net::test_server::HttpResponse {
+ public:
+  void SendResponse(
+      base::WeakPtr<net::test_server::HttpResponseDelegate> delegate) override {
+    const std::string content = GetLargeMediaFileContent();
+    delegate->SendResponseHeaders(
+        net::HTTP_OK, "OK",
+        {{"Content-Type", "video/mp4"},
+         {"Content-Length", base::NumberToString(content.size())},
+         {"Accept-Ranges", "bytes"},
+         {"ETag", kLargeMediaFileETag}});
+    delegate->SendContents(content.substr(0, content.size() / 2));
+  }
+};
+
 std::unique_ptr<net::test_server::HttpResponse> HandleRequest(
     const net::test_server::HttpRequest& request) {
+  if (request.relative_url == "/large_media_file")
+    return HandleLargeMediaFileRequest(request);
+  if (request.relative_url == "/stalled_media_file") {
+    if (request.headers.count(net::HttpRequestHeaders::kRange))
+      return HandleLargeMediaFileRequest(request);
+    return std::make_unique<StalledMediaFileResponse>();
+  }
+
   auto http_response = std::make_unique<net::test_server::BasicHttpResponse>();
   if (request.relative_url == "/valid_thumbnail" ||
       request.relative_url == "/valid_media_file_1" ||
@@ -82,6 +162,27 @@ class MockObserver : public PlaylistServiceObserver {
               (override));
 };
 
+class MockMediaFileDownloaderDelegate
+    : public PlaylistMediaFileDownloader::Delegate {
+ public:
+  MOCK_METHOD(void,
+              OnMediaFileDownloadProgressed,
+              (const std::string& id,
+               int64_t total_bytes,
+               int64_t received_bytes,
+               int percent_complete,
+               base::TimeDelta time_remaining),
+              (override));
+  MOCK_METHOD(void,
+              OnMediaFileReady,
+              (const std::string& id, const std::string& media_file_path),
+              (override));
+  MOCK_METHOD(void,
+              OnMediaFileGenerationFailed,
+              (const std::string& id),
+              (override));
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // PlaylistServiceUnitTest fixture
 class PlaylistServiceUnitTest : public testing::Test {
@@ -99,6 +200,8 @@ class PlaylistServiceUnitTest : public testing::Test {
 
   PrefService* prefs() { return profile_->GetPrefs(); }
 
+  TestingProfile* profile() { return profile_.get(); }
+
   void WaitUntil(base::RepeatingCallback<bool()> condition) {
     if (condition.Run())
       return;
@@ -338,6 +441,116 @@ TEST_F(PlaylistServiceUnitTest, MediaDownloadFailed) {
   service->RemoveObserver(&observer);
 }
 
+TEST_F(PlaylistServiceUnitTest, MediaDownloadResumesAfterDisconnect) {
+  auto* service = playlist_service();
+  g_large_media_file_range_requests = 0;
+
+  auto id = base::Token::CreateRandom().ToString();
+  bool cached = false;
+  bool aborted = false;
+  testing::NiceMock<MockObserver> observer;
+  EXPECT_CALL(observer,
+              OnPlaylistStatusChanged(PlaylistChangeParams(
+                  PlaylistChangeParams::Type::kItemCached, id)))
+      .WillOnce([&]() { cached = true; });
+  EXPECT_CALL(observer,
+              OnPlaylistStatusChanged(PlaylistChangeParams(
+                  PlaylistChangeParams::Type::kItemAborted, id)))
+      .WillRepeatedly([&]() { aborted = true; });
+  service->AddObserver(&observer);
+
+  auto params = GetValidCreateParams();
+  params.id = id;
+  params.media_src = params.media_file_path =
+      https_server()->GetURL("/large_media_file").spec();
+  service->CreatePlaylistItem(params, /* cache = */ true);
+
+  WaitUntil(base::BindLambdaForTesting([&]() { return cached || aborted; }));
+  EXPECT_TRUE(cached);
+  EXPECT_FALSE(aborted);
+
+  // The second half was fetched with a range request instead of starting over.
+  EXPECT_GE(g_large_media_file_range_requests, 1);
+  base::FilePath media_path;
+  ASSERT_TRUE(service->GetMediaPath(id, &media_path));
+  std::string media_file;
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    ASSERT_TRUE(base::ReadFileToString(media_path, &media_file));
+  }
+  EXPECT_EQ(GetLargeMediaFileContent(), media_file);
+
+  service->RemoveObserver(&observer);
+}
+
+TEST_F(PlaylistServiceUnitTest, MediaDownloadResumesAfterDownloaderDestroyed) {
+  g_large_media_file_range_requests = 0;
+  const std::string content = GetLargeMediaFileContent();
+
+  auto item = GetValidCreateParams();
+  item.id = base::Token::CreateRandom().ToString();
+  item.media_src = item.media_file_path =
+      https_server()->GetURL("/stalled_media_file").spec();
+  const base::FilePath base_dir = profile()->GetPath().AppendASCII("media");
+  const base::FilePath media_path =
+      base_dir.AppendASCII(item.id).Append(
+          PlaylistMediaFileDownloadManager::kMediaFileName);
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    ASSERT_TRUE(base::CreateDirectory(media_path.DirName()));
+  }
+
+  int64_t received_bytes = 0;
+  std::string ready_path;
+  bool failed = false;
+  testing::NiceMock<MockMediaFileDownloaderDelegate> delegate;
+  ON_CALL(delegate, OnMediaFileDownloadProgressed)
+      .WillByDefault(
+          [&](const std::string&, int64_t, int64_t received, int,
+              base::TimeDelta) { received_bytes = received; });
+  ON_CALL(delegate, OnMediaFileReady)
+      .WillByDefault([&](const std::string&, const std::string& path) {
+        ready_path = path;
+      });
+  ON_CALL(delegate, OnMediaFileGenerationFailed)
+      .WillByDefault([&](const std::string&) { failed = true; });
+
+  auto downloader = std::make_unique<PlaylistMediaFileDownloader>(
+      &delegate, profile(), PlaylistMediaFileDownloadManager::kMediaFileName);
+  downloader->DownloadMediaFileForPlaylistItem(item, base_dir);
+  WaitUntil(base::BindLambdaForTesting([&]() {
+    return received_bytes >= static_cast<int64_t>(content.size() / 2);
+  }));
+
+  // Destroying the downloader mid-download, as on shutdown, keeps the partial
+  // file and its resume state.
+  downloader.reset();
+  WaitUntil(base::BindLambdaForTesting([&]() {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    int64_t size = 0;
+    return base::PathExists(media_path.AddExtensionASCII("resume")) &&
+           base::GetFileSize(media_path, &size) &&
+           size == static_cast<int64_t>(content.size() / 2);
+  }));
+  EXPECT_FALSE(failed);
+
+  downloader = std::make_unique<PlaylistMediaFileDownloader>(
+      &delegate, profile(), PlaylistMediaFileDownloadManager::kMediaFileName);
+  downloader->DownloadMediaFileForPlaylistItem(item, base_dir);
+  WaitUntil(base::BindLambdaForTesting(
+      [&]() { return !ready_path.empty() || failed; }));
+  EXPECT_FALSE(failed);
+
+  // Only the second half was fetched, with a range request.
+  EXPECT_EQ(1, g_large_media_file_range_requests);
+  std::string media_file;
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    ASSERT_TRUE(base::ReadFileToString(media_path, &media_file));
+  }
+  EXPECT_EQ(content, media_file);
+}
+
 TEST_F(PlaylistServiceUnitTest, MediaRecoverTest) {
   auto* service = playlist_service();
 
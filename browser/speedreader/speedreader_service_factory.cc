@@ -5,6 +5,7 @@
 
 #include "brave/browser/speedreader/speedreader_service_factory.h"
 
+#include "base/files/file_path.h"
 #include "brave/components/speedreader/speedreader_service.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
 #include "chrome/browser/profiles/profile.h"
@@ -12,6 +13,13 @@
 
 namespace speedreader {
 
+namespace {
+
+constexpr base::FilePath::CharType kDistilledCacheDirName[] =
+    FILE_PATH_LITERAL("Speedreader Cache");
+
+}  // namespace
+
 // static
 SpeedreaderServiceFactory* SpeedreaderServiceFactory::GetInstance() {
   return base::Singleton<SpeedreaderServiceFactory>::get();
@@ -38,8 +46,13 @@ SpeedreaderServiceFactory::GetBrowserContextToUse(
 
 KeyedService* SpeedreaderServiceFactory::BuildServiceInstanceFor(
     content::BrowserContext* context) const {
+  Profile* profile = Profile::FromBrowserContext(context);
+  // Off-the-record profiles only keep distilled pages in memory.
   return new SpeedreaderService(
-      Profile::FromBrowserContext(context)->GetPrefs());
+      profile->GetPrefs(),
+      profile->IsOffTheRecord()
+          ? base::FilePath()
+          : profile->GetPath().Append(kDistilledCacheDirName));
 }
 
 bool SpeedreaderServiceFactory::ServiceIsCreatedWithBrowserContext() const {
@@ -0,0 +1,142 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "net/cookies/cookie_monster.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_access_result.h"
+#include "net/cookies/cookie_deletion_info.h"
+#include "net/cookies/cookie_options.h"
+#include "net/cookies/cookie_partition_key_collection.h"
+#include "net/cookies/cookie_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace net {
+
+namespace {
+
+constexpr char kThirdPartyUrl[] = "https://third-party.com/";
+
+CookieOptions EphemeralOptions(const std::string& top_frame_host) {
+  CookieOptions options = CookieOptions::MakeAllInclusive();
+  options.set_should_use_ephemeral_storage(true);
+  options.set_top_frame_origin(url::Origin::Create(
+      GURL(base::StrCat({"https://", top_frame_host, "/"}))));
+  return options;
+}
+
+std::string TopFrameHost(size_t index) {
+  return base::StrCat({"site", base::NumberToString(index), ".com"});
+}
+
+}  // namespace
+
+class BraveCookieMonsterTest : public testing::Test {
+ public:
+  BraveCookieMonsterTest()
+      : cookie_monster_(
+            std::make_unique<CookieMonster>(nullptr /* store */,
+                                            nullptr /* net_log */)) {}
+
+  bool SetEphemeralCookie(const std::string& cookie_line,
+                          const std::string& top_frame_host) {
+    const GURL url(kThirdPartyUrl);
+    auto cookie = CanonicalCookie::Create(
+        url, cookie_line, base::Time::Now(), /*server_time=*/absl::nullopt,
+        /*cookie_partition_key=*/absl::nullopt);
+    bool included = false;
+    base::RunLoop run_loop;
+    cookie_monster_->SetCanonicalCookieAsync(
+        std::move(cookie), url, EphemeralOptions(top_frame_host),
+        base::BindOnce(
+            [](bool* included, base::OnceClosure quit,
+               CookieAccessResult result) {
+              *included = result.status.IsInclude();
+              std::move(quit).Run();
+            },
+            &included, run_loop.QuitClosure()));
+    run_loop.Run();
+    return included;
+  }
+
+  CookieList GetEphemeralCookies(const std::string& top_frame_host) {
+    CookieList cookies;
+    base::RunLoop run_loop;
+    cookie_monster_->GetCookieListWithOptionsAsync(
+        GURL(kThirdPartyUrl), EphemeralOptions(top_frame_host),
+        CookiePartitionKeyCollection(),
+        base::BindOnce(
+            [](CookieList* cookies, base::OnceClosure quit,
+               const CookieAccessResultList& included,
+               const CookieAccessResultList& excluded) {
+              *cookies = cookie_util::StripAccessResults(included);
+              std::move(quit).Run();
+            },
+            &cookies, run_loop.QuitClosure()));
+    run_loop.Run();
+    return cookies;
+  }
+
+  void DropEphemeralPartition(const std::string& domain) {
+    CookieDeletionInfo delete_info;
+    delete_info.ephemeral_storage_domain = domain;
+    base::RunLoop run_loop;
+    cookie_monster_->DeleteAllMatchingInfoAsync(
+        std::move(delete_info),
+        base::BindOnce([](base::OnceClosure quit,
+                          uint32_t) { std::move(quit).Run(); },
+                       run_loop.QuitClosure()));
+    run_loop.Run();
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<CookieMonster> cookie_monster_;
+};
+
+TEST_F(BraveCookieMonsterTest, ReadsDoNotCreatePartitions) {
+  EXPECT_TRUE(GetEphemeralCookies("a.com").empty());
+  EXPECT_EQ(0u, cookie_monster_->ephemeral_cookie_store_count_for_testing());
+
+  ASSERT_TRUE(SetEphemeralCookie("name=a", "a.com"));
+  EXPECT_EQ(1u, cookie_monster_->ephemeral_cookie_store_count_for_testing());
+  // Subdomains of the top frame site share its partition.
+  EXPECT_EQ(1u, GetEphemeralCookies("www.a.com").size());
+  EXPECT_EQ(1u, cookie_monster_->ephemeral_cookie_store_count_for_testing());
+}
+
+TEST_F(BraveCookieMonsterTest, PartitionsAreIsolatedAndDroppedAsAWhole) {
+  constexpr size_t kPartitionCount = 500;
+  for (size_t i = 0; i < kPartitionCount; ++i) {
+    ASSERT_TRUE(SetEphemeralCookie(
+        base::StrCat({"name=", base::NumberToString(i)}), TopFrameHost(i)));
+  }
+  EXPECT_EQ(kPartitionCount,
+            cookie_monster_->ephemeral_cookie_store_count_for_testing());
+
+  CookieList cookies = GetEphemeralCookies(TopFrameHost(42));
+  ASSERT_EQ(1u, cookies.size());
+  EXPECT_EQ("42", cookies[0].Value());
+
+  DropEphemeralPartition(TopFrameHost(42));
+  EXPECT_EQ(kPartitionCount - 1,
+            cookie_monster_->ephemeral_cookie_store_count_for_testing());
+  EXPECT_TRUE(GetEphemeralCookies(TopFrameHost(42)).empty());
+  EXPECT_EQ(1u, GetEphemeralCookies(TopFrameHost(43)).size());
+}
+
+}  // namespace net
@@ -6,6 +6,8 @@
 #include "net/cookies/cookie_monster.h"
 
 #include <memory>
+#include <utility>
+
 #include "net/base/url_util.h"
 
 #define CookieMonster ChromiumCookieMonster
@@ -14,6 +16,14 @@
 
 namespace net {
 
+namespace {
+
+// Upper bound for the memoized top frame origin to ephemeral storage domain
+// mappings.
+constexpr size_t kMaxEphemeralStorageDomains = 1000;
+
+}  // namespace
+
 CookieMonster::CookieMonster(scoped_refptr<PersistentCookieStore> store,
                              NetLog* net_log)
     : ChromiumCookieMonster(store, net_log),
@@ -29,17 +39,38 @@ CookieMonster::CookieMonster(scoped_refptr<PersistentCookieStore> store,
 
 CookieMonster::~CookieMonster() {}
 
-ChromiumCookieMonster*
-CookieMonster::GetOrCreateEphemeralCookieStoreForTopFrameURL(
-    const GURL& top_frame_url) {
-  std::string domain = URLToEphemeralStorageDomain(top_frame_url);
+const std::string& CookieMonster::GetEphemeralStorageDomain(
+    const url::Origin& top_frame_origin) {
+  auto it = ephemeral_storage_domains_.find(top_frame_origin);
+  if (it != ephemeral_storage_domains_.end())
+    return it->second;
+
+  // Keep the memo bounded, resolving a domain again is cheap enough.
+  if (ephemeral_storage_domains_.size() >= kMaxEphemeralStorageDomains)
+    ephemeral_storage_domains_.clear();
+  return ephemeral_storage_domains_
+      .emplace(top_frame_origin,
+               URLToEphemeralStorageDomain(top_frame_origin.GetURL()))
+      .first->second;
+}
+
+ChromiumCookieMonster* CookieMonster::GetEphemeralCookieStore(
+    const url::Origin& top_frame_origin) {
+  auto it = ephemeral_cookie_stores_.find(
+      GetEphemeralStorageDomain(top_frame_origin));
+  return it != ephemeral_cookie_stores_.end() ? it->second.get() : nullptr;
+}
+
+ChromiumCookieMonster* CookieMonster::GetOrCreateEphemeralCookieStore(
+    const url::Origin& top_frame_origin) {
+  const std::string& domain = GetEphemeralStorageDomain(top_frame_origin);
   auto it = ephemeral_cookie_stores_.find(domain);
   if (it != ephemeral_cookie_stores_.end())
     return it->second.get();
 
   return ephemeral_cookie_stores_
-      .emplace(domain, new ChromiumCookieMonster(nullptr /* store */,
-                                                 net_log_.net_log()))
+      .emplace(domain, std::make_unique<ChromiumCookieMonster>(
+                           nullptr /* store */, net_log_.net_log()))
       .first->second.get();
 }
 
@@ -66,6 +97,7 @@ void CookieMonster::DeleteAllCreatedInTimeRangeAsync(
 void CookieMonster::DeleteAllMatchingInfoAsync(CookieDeletionInfo delete_info,
                                                DeleteCallback callback) {
   if (delete_info.ephemeral_storage_domain.has_value()) {
+    // Dropping the partition's monster takes all of its cookies with it.
     ephemeral_cookie_stores_.erase(*delete_info.ephemeral_storage_domain);
     std::move(callback).Run(0);
     return;
@@ -111,8 +143,7 @@ void CookieMonster::SetCanonicalCookieAsync(
       return;
     }
     ChromiumCookieMonster* ephemeral_monster =
-        GetOrCreateEphemeralCookieStoreForTopFrameURL(
-            options.top_frame_origin()->GetURL());
+        GetOrCreateEphemeralCookieStore(*options.top_frame_origin());
     ephemeral_monster->SetCanonicalCookieAsync(std::move(cookie), source_url,
                                                options, std::move(callback),
                                                std::move(cookie_access_result));
@@ -138,8 +169,13 @@ void CookieMonster::GetCookieListWithOptionsAsync(
       return;
     }
     ChromiumCookieMonster* ephemeral_monster =
-        GetOrCreateEphemeralCookieStoreForTopFrameURL(
-            options.top_frame_origin()->GetURL());
+        GetEphemeralCookieStore(*options.top_frame_origin());
+    if (!ephemeral_monster) {
+      // Nothing was stored in this partition, no need to create it for reads.
+      MaybeRunCookieCallback(std::move(callback), CookieAccessResultList(),
+                             CookieAccessResultList());
+      return;
+    }
     ephemeral_monster->GetCookieListWithOptionsAsync(
         url, options, cookie_partition_key_collection, std::move(callback));
     return;
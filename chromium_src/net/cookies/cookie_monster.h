@@ -6,6 +6,13 @@
 #ifndef BRAVE_CHROMIUM_SRC_NET_COOKIES_COOKIE_MONSTER_H_
 #define BRAVE_CHROMIUM_SRC_NET_COOKIES_COOKIE_MONSTER_H_
 
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "url/origin.h"
+
 #define CookieMonster ChromiumCookieMonster
 #include "src/net/cookies/cookie_monster.h"
 #undef CookieMonster
@@ -50,12 +57,28 @@ class NET_EXPORT CookieMonster : public ChromiumCookieMonster {
       const CookiePartitionKeyCollection& cookie_partition_key_collection,
       GetCookieListCallback callback) override;
 
+  size_t ephemeral_cookie_store_count_for_testing() const {
+    return ephemeral_cookie_stores_.size();
+  }
+
  private:
+  // Returns the ephemeral storage domain |top_frame_origin| is partitioned
+  // by. Resolving it needs a registry lookup, so the result is memoized.
+  const std::string& GetEphemeralStorageDomain(
+      const url::Origin& top_frame_origin);
+  // Returns nullptr if nothing was stored for |top_frame_origin| yet.
+  ChromiumCookieMonster* GetEphemeralCookieStore(
+      const url::Origin& top_frame_origin);
+  ChromiumCookieMonster* GetOrCreateEphemeralCookieStore(
+      const url::Origin& top_frame_origin);
+
   NetLogWithSource net_log_;
-  std::map<std::string, std::unique_ptr<ChromiumCookieMonster>>
+  // Ephemeral monsters are only created once a cookie is set in their
+  // partition and are dropped as a whole when the partition's lifetime ends.
+  std::unordered_map<std::string, std::unique_ptr<ChromiumCookieMonster>>
       ephemeral_cookie_stores_;
-  ChromiumCookieMonster* GetOrCreateEphemeralCookieStoreForTopFrameURL(
-      const GURL& top_frame_url);
+  // Does not depend on the stored cookies, so it survives partition drops.
+  std::map<url::Origin, std::string> ephemeral_storage_domains_;
 };
 
 }  // namespace net
@@ -32,6 +32,33 @@ Response InspectorPageAgent::generatePageGraph(String* data) {
 #endif  // BUILDFLAG(ENABLE_BRAVE_PAGE_GRAPH)
 }
 
+Response InspectorPageAgent::generatePageGraphBinary(
+    protocol::Maybe<bool> compress,
+    protocol::Binary* data) {
+#if BUILDFLAG(ENABLE_BRAVE_PAGE_GRAPH)
+  LocalFrame* main_frame = inspected_frames_->Root();
+  if (!main_frame) {
+    return Response::ServerError("No main frame found");
+  }
+
+  PageGraph* page_graph = blink::PageGraph::From(*main_frame);
+  if (!page_graph) {
+    return Response::ServerError("No Page Graph for main frame");
+  }
+
+  const std::string recording = page_graph->ToBinary(compress.fromMaybe(true));
+  if (recording.empty()) {
+    return Response::ServerError("Could not compress the Page Graph");
+  }
+
+  *data = protocol::Binary::fromSpan(
+      reinterpret_cast<const uint8_t*>(recording.data()), recording.size());
+  return Response::Success();
+#else
+  return Response::ServerError("Page Graph buildflag is disabled");
+#endif  // BUILDFLAG(ENABLE_BRAVE_PAGE_GRAPH)
+}
+
 Response InspectorPageAgent::generatePageGraphNodeReport(
     int node_id,
     std::unique_ptr<protocol::Array<String>>* report) {
@@ -143,6 +143,20 @@ bool engine_deserialize(struct C_Engine* engine,
                         const char* data,
                         size_t data_size);
 
+/**
+ * Serializes the engine into a buffer that `engine_deserialize` can load. The
+ * buffer is put into `data` and must be released with
+ * `serialized_buffer_destroy`. Returns `true` on success.
+ */
+bool engine_serialize(struct C_Engine* engine,
+                      uint8_t** data,
+                      size_t* data_size);
+
+/**
+ * Destroy a buffer returned by `engine_serialize`.
+ */
+void serialized_buffer_destroy(uint8_t* data, size_t data_size);
+
 /**
  * Destroy a `Engine` once you are done with it.
  */
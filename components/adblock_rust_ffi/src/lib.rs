@@ -282,6 +282,39 @@ pub unsafe extern "C" fn engine_deserialize(
     ok
 }
 
+/// Serializes the engine into a buffer that `engine_deserialize` can load. The buffer is put into
+/// `data` and must be released with `serialized_buffer_destroy`. Returns `true` on success.
+#[no_mangle]
+pub unsafe extern "C" fn engine_serialize(
+    engine: *mut Engine,
+    data: *mut *mut u8,
+    data_size: *mut size_t,
+) -> bool {
+    assert!(!engine.is_null());
+    let engine = Box::leak(Box::from_raw(engine));
+    match engine.serialize_raw() {
+        Ok(serialized) => {
+            let mut serialized = serialized.into_boxed_slice();
+            *data_size = serialized.len();
+            *data = serialized.as_mut_ptr();
+            std::mem::forget(serialized);
+            true
+        }
+        Err(_) => {
+            eprintln!("Error serializing adblock engine");
+            false
+        }
+    }
+}
+
+/// Destroy a buffer returned by `engine_serialize`.
+#[no_mangle]
+pub unsafe extern "C" fn serialized_buffer_destroy(data: *mut u8, data_size: size_t) {
+    if !data.is_null() {
+        drop(Box::from_raw(std::slice::from_raw_parts_mut(data, data_size)));
+    }
+}
+
 /// Destroy a `Engine` once you are done with it.
 #[no_mangle]
 pub unsafe extern "C" fn engine_destroy(engine: *mut Engine) {
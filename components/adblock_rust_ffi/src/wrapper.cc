@@ -130,6 +130,17 @@ bool Engine::deserialize(const char* data, size_t data_size) {
   return engine_deserialize(raw, data, data_size);
 }
 
+std::vector<uint8_t> Engine::serialize() {
+  uint8_t* data = nullptr;
+  size_t data_size = 0;
+  if (!engine_serialize(raw, &data, &data_size))
+    return {};
+
+  std::vector<uint8_t> serialized(data, data + data_size);
+  serialized_buffer_destroy(data, data_size);
+  return serialized;
+}
+
 void Engine::addTag(const std::string& tag) {
   engine_add_tag(raw, tag.c_str());
 }
@@ -84,6 +84,8 @@ class ADBLOCK_EXPORT Engine {
                                bool is_third_party,
                                const std::string& resource_type);
   bool deserialize(const char* data, size_t data_size);
+  // Returns a buffer |deserialize| accepts, or an empty one on failure.
+  std::vector<uint8_t> serialize();
   void addTag(const std::string& tag);
   void addResource(const std::string& key,
                    const std::string& content_type,
@@ -0,0 +1,350 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/api_request_helper/api_request_cache.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash/sha1.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+
+namespace api_request_helper {
+
+namespace {
+
+constexpr char kEtagHeader[] = "etag";
+constexpr char kLastModifiedHeader[] = "last-modified";
+// Response headers are lowercased by APIRequestHelper, request headers are
+// sent as is.
+constexpr char kIfNoneMatchHeader[] = "If-None-Match";
+constexpr char kIfModifiedSinceHeader[] = "If-Modified-Since";
+
+// Don't keep bodies that would dominate the profile directory.
+constexpr size_t kMaxCachedBodySize = 32 * 1024 * 1024;
+// A single body may not take more than this share of the memory budget.
+constexpr size_t kMaxMemoryEntryShare = 2;
+// Entries that weren't used for this long are dropped on load.
+constexpr base::TimeDelta kMaxEntryAge = base::Days(30);
+
+// Cache files hold the url, the two validators and the body, separated by
+// newlines. Header values and url specs can't contain newlines.
+base::FilePath GetEntryPath(const base::FilePath& cache_dir, const GURL& url) {
+  return cache_dir.AppendASCII(
+      base::ToLowerASCII(base::HexEncode(base::SHA1HashString(url.spec()))));
+}
+
+std::string SerializeEntry(const GURL& url,
+                           const APIRequestCache::Entry& entry,
+                           const std::string& body) {
+  return base::StrCat({url.spec(), "\n", entry.etag, "\n", entry.last_modified,
+                       "\n", body});
+}
+
+bool DeserializeEntry(const std::string& contents,
+                      std::string* url,
+                      APIRequestCache::Entry* entry,
+                      std::string* body) {
+  std::string* fields[] = {url, &entry->etag, &entry->last_modified};
+  size_t pos = 0;
+  for (auto* field : fields) {
+    size_t end = contents.find('\n', pos);
+    if (end == std::string::npos)
+      return false;
+    *field = contents.substr(pos, end - pos);
+    pos = end + 1;
+  }
+  *body = contents.substr(pos);
+  entry->body_size = body->size();
+  return GURL(*url).is_valid() &&
+         (!entry->etag.empty() || !entry->last_modified.empty());
+}
+
+// Loads the validators of all entries, bodies are read when needed.
+base::flat_map<std::string, APIRequestCache::Entry> LoadEntries(
+    const base::FilePath& cache_dir) {
+  std::vector<std::pair<std::string, APIRequestCache::Entry>> entries;
+  const base::Time now = base::Time::Now();
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    std::string contents;
+    std::string url;
+    std::string body;
+    APIRequestCache::Entry entry;
+    entry.last_used = enumerator.GetInfo().GetLastModifiedTime();
+    if (now - entry.last_used > kMaxEntryAge ||
+        !base::ReadFileToStringWithMaxSize(path, &contents,
+                                           kMaxCachedBodySize) ||
+        !DeserializeEntry(contents, &url, &entry, &body)) {
+      base::DeleteFile(path);
+      continue;
+    }
+    entries.emplace_back(std::move(url), std::move(entry));
+  }
+  return base::flat_map<std::string, APIRequestCache::Entry>(
+      std::move(entries));
+}
+
+absl::optional<std::string> ReadEntryBody(const base::FilePath& path,
+                                          const std::string& url) {
+  std::string contents;
+  std::string entry_url;
+  std::string body;
+  APIRequestCache::Entry entry;
+  if (!base::ReadFileToStringWithMaxSize(path, &contents, kMaxCachedBodySize) ||
+      !DeserializeEntry(contents, &entry_url, &entry, &body) ||
+      entry_url != url) {
+    return absl::nullopt;
+  }
+  return body;
+}
+
+void WriteEntry(const base::FilePath& cache_dir,
+                const base::FilePath& path,
+                const std::string& contents) {
+  if (!base::CreateDirectory(cache_dir)) {
+    VLOG(1) << "Could not create response cache dir " << cache_dir;
+    return;
+  }
+  base::ImportantFileWriter::WriteFileAtomically(path, contents);
+}
+
+// The modification time keeps the use order across restarts.
+void TouchEntry(const base::FilePath& path) {
+  const base::Time now = base::Time::Now();
+  base::TouchFile(path, now, now);
+}
+
+}  // namespace
+
+APIRequestCache::Entry::Entry() = default;
+APIRequestCache::Entry::Entry(Entry&&) = default;
+APIRequestCache::Entry& APIRequestCache::Entry::operator=(Entry&&) = default;
+APIRequestCache::Entry::~Entry() = default;
+
+APIRequestCache::MemoryEntry::MemoryEntry() = default;
+APIRequestCache::MemoryEntry::MemoryEntry(MemoryEntry&&) = default;
+APIRequestCache::MemoryEntry& APIRequestCache::MemoryEntry::operator=(
+    MemoryEntry&&) = default;
+APIRequestCache::MemoryEntry::~MemoryEntry() = default;
+
+APIRequestCache::APIRequestCache(const base::FilePath& cache_dir,
+                                 const std::string& consumer_name,
+                                 size_t max_memory_bytes,
+                                 size_t max_disk_bytes)
+    : cache_dir_(cache_dir),
+      consumer_name_(consumer_name),
+      max_disk_bytes_(max_disk_bytes),
+      file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      memory_(max_memory_bytes, kMaxMemoryEntryShare) {
+  file_task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&LoadEntries, cache_dir_),
+      base::BindOnce(&APIRequestCache::OnEntriesLoaded,
+                     weak_ptr_factory_.GetWeakPtr(), memory_.generation()));
+}
+
+APIRequestCache::~APIRequestCache() = default;
+
+void APIRequestCache::OnEntriesLoaded(int generation, Entries entries) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (generation != memory_.generation())
+    return;
+  // Responses stored while loading are newer than what is on disk.
+  for (auto& it : entries) {
+    const size_t body_size = it.second.body_size;
+    if (entries_.emplace(it.first, std::move(it.second)).second)
+      disk_bytes_ += body_size;
+  }
+  EvictFromDisk(std::string());
+}
+
+void APIRequestCache::AddValidatorHeaders(
+    const GURL& url,
+    base::flat_map<std::string, std::string>* headers) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(headers);
+  auto it = entries_.find(url.spec());
+  if (it == entries_.end())
+    return;
+  if (!it->second.etag.empty())
+    (*headers)[kIfNoneMatchHeader] = it->second.etag;
+  if (!it->second.last_modified.empty())
+    (*headers)[kIfModifiedSinceHeader] = it->second.last_modified;
+}
+
+const APIRequestCache::Entry* APIRequestCache::GetEntry(const GURL& url) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = entries_.find(url.spec());
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+const base::Value* APIRequestCache::GetValue(const GURL& url) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const MemoryEntry* memory_entry = memory_.Get(url.spec());
+  if (!memory_entry || memory_entry->value.is_none())
+    return nullptr;
+  return &memory_entry->value;
+}
+
+void APIRequestCache::GetBody(const GURL& url, BodyCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const MemoryEntry* memory_entry = memory_.Get(url.spec());
+  if (memory_entry && memory_entry->value.is_none()) {
+    std::move(callback).Run(memory_entry->body);
+    return;
+  }
+
+  file_task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&ReadEntryBody, GetEntryPath(cache_dir_, url),
+                     url.spec()),
+      base::BindOnce(&APIRequestCache::OnBodyRead,
+                     weak_ptr_factory_.GetWeakPtr(), url.spec(),
+                     std::move(callback)));
+}
+
+void APIRequestCache::OnBodyRead(const std::string& url,
+                                 BodyCallback callback,
+                                 absl::optional<std::string> body) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!body)
+    Remove(url);
+  std::move(callback).Run(std::move(body));
+}
+
+bool APIRequestCache::Store(
+    const GURL& url,
+    const base::flat_map<std::string, std::string>& response_headers,
+    const std::string& body) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  Entry entry;
+  if (response_headers.contains(kEtagHeader))
+    entry.etag = response_headers.at(kEtagHeader);
+  if (response_headers.contains(kLastModifiedHeader))
+    entry.last_modified = response_headers.at(kLastModifiedHeader);
+  if ((entry.etag.empty() && entry.last_modified.empty()) ||
+      body.size() > kMaxCachedBodySize || body.size() > max_disk_bytes_) {
+    Remove(url.spec());
+    return false;
+  }
+  entry.body_size = body.size();
+  entry.last_used = base::Time::Now();
+
+  file_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&WriteEntry, cache_dir_,
+                                GetEntryPath(cache_dir_, url),
+                                SerializeEntry(url, entry, body)));
+  auto it = entries_.find(url.spec());
+  if (it != entries_.end())
+    disk_bytes_ -= it->second.body_size;
+  disk_bytes_ += entry.body_size;
+  entries_.insert_or_assign(url.spec(), std::move(entry));
+
+  if (memory_.Fits(body.size())) {
+    MemoryEntry memory_entry;
+    memory_entry.body = body;
+    memory_.Put(url.spec(), std::move(memory_entry), body.size());
+  } else {
+    memory_.Erase(url.spec());
+  }
+  EvictFromDisk(url.spec());
+  return true;
+}
+
+void APIRequestCache::StoreValue(const GURL& url, const base::Value& value) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const Entry* entry = GetEntry(url);
+  if (!entry)
+    return;
+  if (!memory_.Fits(entry->body_size)) {
+    memory_.Erase(url.spec());
+    return;
+  }
+  // The body stays on disk for the next session.
+  MemoryEntry memory_entry;
+  memory_entry.value = value.Clone();
+  memory_.Put(url.spec(), std::move(memory_entry), entry->body_size);
+}
+
+void APIRequestCache::Remove(const std::string& url) {
+  memory_.Erase(url);
+  auto it = entries_.find(url);
+  if (it == entries_.end())
+    return;
+  disk_bytes_ -= it->second.body_size;
+  entries_.erase(it);
+  file_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(base::GetDeleteFileCallback(),
+                                GetEntryPath(cache_dir_, GURL(url))));
+}
+
+void APIRequestCache::EvictFromDisk(const std::string& keep_url) {
+  // Consumers only request a handful of urls, so a scan is cheap enough.
+  while (disk_bytes_ > max_disk_bytes_) {
+    auto oldest = entries_.end();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->first != keep_url &&
+          (oldest == entries_.end() ||
+           it->second.last_used < oldest->second.last_used)) {
+        oldest = it;
+      }
+    }
+    if (oldest == entries_.end())
+      return;
+    Remove(std::string(oldest->first));
+  }
+}
+
+void APIRequestCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  memory_.Clear();
+  entries_.clear();
+  disk_bytes_ = 0;
+  // Runs after the writes that are already posted.
+  file_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(base::GetDeletePathRecursivelyCallback(),
+                                cache_dir_));
+}
+
+void APIRequestCache::RecordHit(const GURL& url) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = entries_.find(url.spec());
+  if (it == entries_.end())
+    return;
+  it->second.last_used = base::Time::Now();
+  file_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&TouchEntry, GetEntryPath(cache_dir_, url)));
+
+  const size_t body_size = it->second.body_size;
+  hits_++;
+  bytes_saved_ += body_size;
+  base::UmaHistogramBoolean("Brave.APIRequestCache.Hit." + consumer_name_,
+                            true);
+  base::UmaHistogramCounts10M(
+      "Brave.APIRequestCache.BytesSaved." + consumer_name_, body_size);
+}
+
+void APIRequestCache::RecordMiss() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  misses_++;
+  base::UmaHistogramBoolean("Brave.APIRequestCache.Hit." + consumer_name_,
+                            false);
+}
+
+}  // namespace api_request_helper
@@ -0,0 +1,151 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_API_REQUEST_HELPER_API_REQUEST_CACHE_H_
+#define BRAVE_COMPONENTS_API_REQUEST_HELPER_API_REQUEST_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/containers/flat_map.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "brave/components/sized_lru_cache/sized_lru_cache.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace api_request_helper {
+
+// Optional on-disk cache of json responses keyed by request url. It keeps the
+// ETag / Last-Modified validators of every cached response so that
+// APIRequestHelper can issue conditional requests and answer a 304 with the
+// previously parsed value instead of decoding the same payload again.
+//
+// Bodies are written to |cache_dir| so validators survive restarts. Recently
+// used bodies, or their decoded values, are also kept in memory; a 304 for any
+// other entry reads its body back from disk and decodes it once. Both tiers
+// evict the least recently used entries once they exceed their byte budget, and
+// entries unused for a month are dropped when the cache is loaded.
+class APIRequestCache {
+ public:
+  // Validators of a stored response.
+  struct Entry {
+    Entry();
+    Entry(Entry&&);
+    Entry& operator=(Entry&&);
+    ~Entry();
+
+    std::string etag;
+    std::string last_modified;
+    size_t body_size = 0;
+    base::Time last_used;
+  };
+
+  using BodyCallback =
+      base::OnceCallback<void(absl::optional<std::string> body)>;
+
+  static constexpr size_t kDefaultMaxMemoryBytes = 4 * 1024 * 1024;
+  static constexpr size_t kDefaultMaxDiskBytes = 32 * 1024 * 1024;
+
+  APIRequestCache(const base::FilePath& cache_dir,
+                  const std::string& consumer_name,
+                  size_t max_memory_bytes = kDefaultMaxMemoryBytes,
+                  size_t max_disk_bytes = kDefaultMaxDiskBytes);
+  ~APIRequestCache();
+  APIRequestCache(const APIRequestCache&) = delete;
+  APIRequestCache& operator=(const APIRequestCache&) = delete;
+
+  // Adds If-None-Match / If-Modified-Since for |url| if it has a cached
+  // response.
+  void AddValidatorHeaders(
+      const GURL& url,
+      base::flat_map<std::string, std::string>* headers) const;
+
+  // Returns the cached entry for |url| or nullptr.
+  const Entry* GetEntry(const GURL& url) const;
+  // Returns the decoded value of |url| if it is still in memory.
+  const base::Value* GetValue(const GURL& url);
+  // Runs |callback| with the stored body of |url|, from memory or disk. The
+  // entry is dropped if its body can't be read.
+  void GetBody(const GURL& url, BodyCallback callback);
+
+  // Remembers |body| for |url| if |response_headers| carry a validator.
+  // Returns false if the response can't be revalidated and was not stored.
+  bool Store(const GURL& url,
+             const base::flat_map<std::string, std::string>& response_headers,
+             const std::string& body);
+  // Keeps the decoded |value| of a stored response so 304s skip decoding.
+  void StoreValue(const GURL& url, const base::Value& value);
+
+  // Drops all entries from memory and disk.
+  void Clear();
+
+  // Also marks the entry of |url| as used.
+  void RecordHit(const GURL& url);
+  void RecordMiss();
+
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+  size_t bytes_saved() const { return bytes_saved_; }
+  size_t memory_bytes() const { return memory_.bytes(); }
+  size_t disk_bytes() const { return disk_bytes_; }
+
+  base::WeakPtr<APIRequestCache> AsWeakPtr() {
+    return weak_ptr_factory_.GetWeakPtr();
+  }
+
+ private:
+  using Entries = base::flat_map<std::string, Entry>;
+
+  // Body of a response, or its decoded value once known. Charged by the size
+  // of the body either way.
+  struct MemoryEntry {
+    MemoryEntry();
+    MemoryEntry(MemoryEntry&&);
+    MemoryEntry& operator=(MemoryEntry&&);
+    ~MemoryEntry();
+
+    std::string body;
+    base::Value value;
+  };
+
+  void OnEntriesLoaded(int generation, Entries entries);
+  void OnBodyRead(const std::string& url,
+                  BodyCallback callback,
+                  absl::optional<std::string> body);
+  // Forgets |url| and deletes its file.
+  void Remove(const std::string& url);
+  // Removes the least recently used entries other than |keep_url| until the
+  // stored bodies fit in |max_disk_bytes_|.
+  void EvictFromDisk(const std::string& keep_url);
+
+  const base::FilePath cache_dir_;
+  const std::string consumer_name_;
+  const size_t max_disk_bytes_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  Entries entries_;
+  size_t disk_bytes_ = 0;
+  // Entries loaded from disk before the last Clear() aren't added back.
+  brave::SizedLRUCache<std::string, MemoryEntry> memory_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+  size_t bytes_saved_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<APIRequestCache> weak_ptr_factory_{this};
+};
+
+}  // namespace api_request_helper
+
+#endif  // BRAVE_COMPONENTS_API_REQUEST_HELPER_API_REQUEST_CACHE_H_
@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "base/json/json_writer.h"
+#include "brave/components/api_request_helper/api_request_cache.h"
 #include "net/base/load_flags.h"
 #include "net/http/http_status_code.h"
 #include "services/data_decoder/public/cpp/data_decoder.h"
@@ -21,6 +22,7 @@ namespace api_request_helper {
 namespace {
 
 void OnParseJsonIsolated(
+    bool serialize_body,
     int http_code,
     const base::flat_map<std::string, std::string>& headers,
     int error_code,
@@ -43,8 +45,10 @@ void OnParseJsonIsolated(
     return;
   }
 
+  // Typed consumers read the value directly, so skip writing the whole tree
+  // back into a string.
   std::string safe_json;
-  if (!base::JSONWriter::Write(result.value(), &safe_json)) {
+  if (serialize_body && !base::JSONWriter::Write(result.value(), &safe_json)) {
     VLOG(1) << "Response validation error: Encoding error";
     std::move(result_callback)
         .Run(APIRequestResult(http_code, "", base::Value(), std::move(headers),
@@ -57,6 +61,15 @@ void OnParseJsonIsolated(
                             std::move(headers), error_code, final_url));
 }
 
+void StoreValueAndRun(base::WeakPtr<APIRequestCache> response_cache,
+                      const GURL& url,
+                      APIRequestHelper::ResultCallback callback,
+                      APIRequestResult result) {
+  if (response_cache && !result.value_body().is_none())
+    response_cache->StoreValue(url, result.value_body());
+  std::move(callback).Run(std::move(result));
+}
+
 const unsigned int kRetriesCountOnNetworkChange = 1;
 
 }  // namespace
@@ -117,23 +130,49 @@ APIRequestHelper::Ticket APIRequestHelper::Request(
     const base::flat_map<std::string, std::string>& headers,
     size_t max_body_size /* = -1u */,
     ResponseConversionCallback conversion_callback) {
+  return RequestInternal(method, url, payload, payload_content_type,
+                         auto_retry_on_network_change, std::move(callback),
+                         headers, max_body_size, std::move(conversion_callback),
+                         true /* serialize_body */);
+}
+
+APIRequestHelper::Ticket APIRequestHelper::RequestInternal(
+    const std::string& method,
+    const GURL& url,
+    const std::string& payload,
+    const std::string& payload_content_type,
+    bool auto_retry_on_network_change,
+    ResultCallback callback,
+    const base::flat_map<std::string, std::string>& headers,
+    size_t max_body_size,
+    ResponseConversionCallback conversion_callback,
+    bool serialize_body) {
+  GURL cache_url;
+  base::flat_map<std::string, std::string> request_headers = headers;
+  if (response_cache_ && method == "GET" && payload.empty()) {
+    cache_url = url;
+    response_cache_->AddValidatorHeaders(url, &request_headers);
+  }
+
   auto iter = url_loaders_.insert(
       url_loaders_.begin(),
       CreateLoader(method, url, payload, payload_content_type,
                    auto_retry_on_network_change,
-                   true /* allow_http_error_result*/, headers));
+                   true /* allow_http_error_result*/, request_headers));
   if (max_body_size == -1u) {
     iter->get()->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
         url_loader_factory_.get(),
         base::BindOnce(&APIRequestHelper::OnResponse,
-                       weak_ptr_factory_.GetWeakPtr(), iter,
-                       std::move(callback), std::move(conversion_callback)));
+                       weak_ptr_factory_.GetWeakPtr(), iter, cache_url,
+                       std::move(callback), std::move(conversion_callback),
+                       serialize_body));
   } else {
     iter->get()->DownloadToString(
         url_loader_factory_.get(),
         base::BindOnce(&APIRequestHelper::OnResponse,
-                       weak_ptr_factory_.GetWeakPtr(), iter,
-                       std::move(callback), std::move(conversion_callback)),
+                       weak_ptr_factory_.GetWeakPtr(), iter, cache_url,
+                       std::move(callback), std::move(conversion_callback),
+                       serialize_body),
         max_body_size);
   }
 
@@ -166,6 +205,18 @@ void APIRequestHelper::Cancel(const Ticket& ticket) {
   url_loaders_.erase(ticket);
 }
 
+void APIRequestHelper::EnableResponseCache(const base::FilePath& cache_dir,
+                                           const std::string& consumer_name,
+                                           size_t max_memory_bytes) {
+  response_cache_ = std::make_unique<APIRequestCache>(cache_dir, consumer_name,
+                                                      max_memory_bytes);
+}
+
+void APIRequestHelper::ClearResponseCache() {
+  if (response_cache_)
+    response_cache_->Clear();
+}
+
 std::unique_ptr<network::SimpleURLLoader> APIRequestHelper::CreateLoader(
     const std::string& method,
     const GURL& url,
@@ -203,8 +254,10 @@ std::unique_ptr<network::SimpleURLLoader> APIRequestHelper::CreateLoader(
 
 void APIRequestHelper::OnResponse(
     SimpleURLLoaderList::iterator iter,
+    const GURL& cache_url,
     ResultCallback callback,
     ResponseConversionCallback conversion_callback,
+    bool serialize_body,
     const std::unique_ptr<std::string> response_body) {
   auto* loader = iter->get();
   auto response_code = -1;
@@ -226,6 +279,29 @@ void APIRequestHelper::OnResponse(
   }
 
   url_loaders_.erase(iter);
+
+  if (response_cache_ && cache_url.is_valid()) {
+    const bool is_cached = response_code == net::HTTP_NOT_MODIFIED &&
+                           response_cache_->GetEntry(cache_url);
+    if (is_cached) {
+      if (const base::Value* value = response_cache_->GetValue(cache_url)) {
+        response_cache_->RecordHit(cache_url);
+        OnParseJsonIsolated(serialize_body, net::HTTP_OK, headers, error_code,
+                            final_url, std::move(callback), value->Clone());
+        return;
+      }
+      // Not decoded yet in this session, or evicted from memory since.
+      response_cache_->GetBody(
+          cache_url,
+          base::BindOnce(&APIRequestHelper::OnCachedBody,
+                         weak_ptr_factory_.GetWeakPtr(), cache_url,
+                         serialize_body, std::move(headers), error_code,
+                         final_url, std::move(callback)));
+      return;
+    }
+    response_cache_->RecordMiss();
+  }
+
   if (!response_body) {
     std::move(callback).Run(APIRequestResult(response_code, "", base::Value(),
                                              std::move(headers), error_code,
@@ -243,10 +319,45 @@ void APIRequestHelper::OnResponse(
     raw_body = converted_body.value();
   }
 
+  if (response_cache_ && cache_url.is_valid() && response_code >= 200 &&
+      response_code <= 299 &&
+      response_cache_->Store(cache_url, headers, raw_body)) {
+    callback = base::BindOnce(&StoreValueAndRun, response_cache_->AsWeakPtr(),
+                              cache_url, std::move(callback));
+  }
+
   data_decoder::DataDecoder::ParseJsonIsolated(
       raw_body,
-      base::BindOnce(&OnParseJsonIsolated, response_code, std::move(headers),
-                     error_code, final_url, std::move(callback)));
+      base::BindOnce(&OnParseJsonIsolated, serialize_body, response_code,
+                     std::move(headers), error_code, final_url,
+                     std::move(callback)));
+}
+
+void APIRequestHelper::OnCachedBody(
+    const GURL& cache_url,
+    bool serialize_body,
+    base::flat_map<std::string, std::string> headers,
+    int error_code,
+    const GURL& final_url,
+    ResultCallback callback,
+    absl::optional<std::string> body) {
+  if (!body) {
+    // The entry is gone now, so the next request is unconditional.
+    response_cache_->RecordMiss();
+    std::move(callback).Run(APIRequestResult(net::HTTP_NOT_MODIFIED, "",
+                                             base::Value(), std::move(headers),
+                                             error_code, final_url));
+    return;
+  }
+
+  response_cache_->RecordHit(cache_url);
+  data_decoder::DataDecoder::ParseJsonIsolated(
+      *body,
+      base::BindOnce(&OnParseJsonIsolated, serialize_body, net::HTTP_OK,
+                     std::move(headers), error_code, final_url,
+                     base::BindOnce(&StoreValueAndRun,
+                                    response_cache_->AsWeakPtr(), cache_url,
+                                    std::move(callback))));
 }
 
 void APIRequestHelper::OnDownload(SimpleURLLoaderList::iterator iter,
@@ -14,7 +14,9 @@
 #include "base/callback_helpers.h"
 #include "base/containers/flat_map.h"
 #include "base/files/file_path.h"
+#include "base/task/thread_pool.h"
 #include "base/values.h"
+#include "brave/components/api_request_helper/api_request_cache.h"
 #include "net/traffic_annotation/network_traffic_annotation.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
@@ -63,6 +65,9 @@ class APIRequestResult {
   // redirects happened.
   GURL final_url() const { return final_url_; }
 
+  // Moves the parsed json out of the result, leaving `value_body()` as none.
+  base::Value TakeValueBody() { return std::move(value_body_); }
+
  private:
   int response_code_ = -1;
   std::string body_;
@@ -104,6 +109,42 @@ class APIRequestHelper {
       size_t max_body_size = -1u,
       ResponseConversionCallback conversion_callback = base::NullCallback());
 
+  // Converts the sanitized json value into a typed result. It is run on a
+  // background sequence, so it must not touch state owned by the caller.
+  template <typename T>
+  using ValueConversionCallback =
+      base::OnceCallback<absl::optional<T>(const base::Value& value)>;
+  template <typename T>
+  using TypedResultCallback =
+      base::OnceCallback<void(APIRequestResult, absl::optional<T>)>;
+
+  // Opt-in variant of Request() for large responses (news feeds, token lists,
+  // fee histories) where the caller only needs a typed struct, e.g. one
+  // generated from an .idl. The body is capped at |max_body_size| and the
+  // sanitized value is handed to |value_conversion_callback| off the main
+  // thread instead of being written back into `body()`. The APIRequestResult
+  // passed to |callback| therefore only carries the response metadata.
+  template <typename T>
+  Ticket RequestTyped(
+      const std::string& method,
+      const GURL& url,
+      const std::string& payload,
+      const std::string& payload_content_type,
+      bool auto_retry_on_network_change,
+      size_t max_body_size,
+      ValueConversionCallback<T> value_conversion_callback,
+      TypedResultCallback<T> callback,
+      const base::flat_map<std::string, std::string>& headers = {}) {
+    return RequestInternal(
+        method, url, payload, payload_content_type,
+        auto_retry_on_network_change,
+        base::BindOnce(&APIRequestHelper::OnTypedResponse<T>,
+                       std::move(value_conversion_callback),
+                       std::move(callback)),
+        headers, max_body_size, base::NullCallback(),
+        false /* serialize_body */);
+  }
+
   using DownloadCallback = base::OnceCallback<void(
       base::FilePath,
       const base::flat_map<std::string, std::string>& /*response_headers*/)>;
@@ -117,10 +158,55 @@ class APIRequestHelper {
 
   void Cancel(const Ticket& ticket);
 
+  // Opts GET requests without payload into the on-disk response cache stored
+  // in |cache_dir|. |consumer_name| is used as the metrics suffix. Responses
+  // kept in memory may take up to half of |max_memory_bytes| each.
+  void EnableResponseCache(const base::FilePath& cache_dir,
+                           const std::string& consumer_name,
+                           size_t max_memory_bytes =
+                               APIRequestCache::kDefaultMaxMemoryBytes);
+  // Drops the responses stored by the response cache, if enabled.
+  void ClearResponseCache();
+  APIRequestCache* response_cache() { return response_cache_.get(); }
+
  private:
   APIRequestHelper(const APIRequestHelper&) = delete;
   APIRequestHelper& operator=(const APIRequestHelper&) = delete;
 
+  Ticket RequestInternal(const std::string& method,
+                         const GURL& url,
+                         const std::string& payload,
+                         const std::string& payload_content_type,
+                         bool auto_retry_on_network_change,
+                         ResultCallback callback,
+                         const base::flat_map<std::string, std::string>& headers,
+                         size_t max_body_size,
+                         ResponseConversionCallback conversion_callback,
+                         bool serialize_body);
+
+  template <typename T>
+  static void OnTypedResponse(
+      ValueConversionCallback<T> value_conversion_callback,
+      TypedResultCallback<T> callback,
+      APIRequestResult result) {
+    if (result.value_body().is_none()) {
+      std::move(callback).Run(std::move(result), absl::nullopt);
+      return;
+    }
+    base::Value value = result.TakeValueBody();
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        base::BindOnce(
+            [](ValueConversionCallback<T> value_conversion_callback,
+               base::Value value) {
+              return std::move(value_conversion_callback).Run(value);
+            },
+            std::move(value_conversion_callback), std::move(value)),
+        base::BindOnce(std::move(callback), std::move(result)));
+  }
+
   std::unique_ptr<network::SimpleURLLoader> CreateLoader(
       const std::string& method,
       const GURL& url,
@@ -133,9 +219,19 @@ class APIRequestHelper {
   using SimpleURLLoaderList =
       std::list<std::unique_ptr<network::SimpleURLLoader>>;
   void OnResponse(SimpleURLLoaderList::iterator iter,
+                  const GURL& cache_url,
                   ResultCallback callback,
                   ResponseConversionCallback conversion_callback,
+                  bool serialize_body,
                   const std::unique_ptr<std::string> response_body);
+  // Answers a 304 with the stored body of |cache_url|.
+  void OnCachedBody(const GURL& cache_url,
+                    bool serialize_body,
+                    base::flat_map<std::string, std::string> headers,
+                    int error_code,
+                    const GURL& final_url,
+                    ResultCallback callback,
+                    absl::optional<std::string> body);
   void OnDownload(SimpleURLLoaderList::iterator iter,
                   DownloadCallback callback,
                   base::FilePath path);
@@ -143,6 +239,7 @@ class APIRequestHelper {
   net::NetworkTrafficAnnotationTag annotation_tag_;
   SimpleURLLoaderList url_loaders_;
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
+  std::unique_ptr<APIRequestCache> response_cache_;
   base::WeakPtrFactory<APIRequestHelper> weak_ptr_factory_{this};
 };
 
@@ -9,14 +9,21 @@
 #include <utility>
 
 #include "base/callback.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/test/bind.h"
 #include "base/test/mock_callback.h"
 #include "base/test/task_environment.h"
+#include "base/test/test_future.h"
 #include "base/test/values_test_util.h"
 #include "base/values.h"
+#include "brave/components/api_request_helper/api_request_cache.h"
+#include "net/http/http_status_code.h"
 #include "net/traffic_annotation/network_traffic_annotation.h"
 #include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "services/data_decoder/public/cpp/test_support/in_process_data_decoder.h"
+#include "services/network/public/mojom/url_response_head.mojom.h"
+#include "services/network/test/test_utils.h"
 #include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
 #include "services/network/test/test_url_loader_factory.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -102,11 +109,11 @@ class ApiRequestHelperUnitTest : public testing::Test {
   }
 
  protected:
+  base::test::TaskEnvironment task_environment_;
   std::unique_ptr<APIRequestHelper> api_request_helper_;
+  network::TestURLLoaderFactory url_loader_factory_;
 
  private:
-  base::test::TaskEnvironment task_environment_;
-  network::TestURLLoaderFactory url_loader_factory_;
   scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
   data_decoder::test::InProcessDataDecoder in_process_data_decoder_;
 };
@@ -156,6 +163,193 @@ TEST_F(ApiRequestHelperUnitTest, RequestWithConversion) {
       base::BindOnce(&ConversionCallback, server_raw_response, absl::nullopt));
 }
 
+TEST_F(ApiRequestHelperUnitTest, RequestTyped) {
+  GURL network_url("http://localhost/");
+  auto to_list_size = base::BindRepeating(
+      [](const base::Value& value) -> absl::optional<size_t> {
+        if (!value.is_list())
+          return absl::nullopt;
+        return value.GetList().size();
+      });
+
+  bool callback_called = false;
+  SetInterceptor("GET", network_url, "[1, 2, 3]");
+  api_request_helper_->RequestTyped<size_t>(
+      "GET", network_url, "", "", false, 1024, to_list_size,
+      base::BindLambdaForTesting([&](APIRequestResult api_request_result,
+                                     absl::optional<size_t> list_size) {
+        callback_called = true;
+        EXPECT_EQ(200, api_request_result.response_code());
+        // The sanitized value is consumed by the conversion and the body is
+        // not re-serialized.
+        EXPECT_TRUE(api_request_result.body().empty());
+        EXPECT_TRUE(api_request_result.value_body().is_none());
+        EXPECT_EQ(3u, list_size);
+      }));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(callback_called);
+
+  // Conversion failure.
+  callback_called = false;
+  SetInterceptor("GET", network_url, "{}");
+  api_request_helper_->RequestTyped<size_t>(
+      "GET", network_url, "", "", false, 1024, to_list_size,
+      base::BindLambdaForTesting([&](APIRequestResult api_request_result,
+                                     absl::optional<size_t> list_size) {
+        callback_called = true;
+        EXPECT_EQ(200, api_request_result.response_code());
+        EXPECT_FALSE(list_size);
+      }));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(callback_called);
+
+  // Bodies over the size limit are never decoded.
+  callback_called = false;
+  SetInterceptor("GET", network_url, "[1, 2, 3]");
+  api_request_helper_->RequestTyped<size_t>(
+      "GET", network_url, "", "", false, 4, to_list_size,
+      base::BindLambdaForTesting([&](APIRequestResult api_request_result,
+                                     absl::optional<size_t> list_size) {
+        callback_called = true;
+        EXPECT_FALSE(list_size);
+      }));
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(callback_called);
+}
+
+TEST_F(ApiRequestHelperUnitTest, ResponseCache) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  api_request_helper_->EnableResponseCache(temp_dir.GetPath(), "Test");
+  task_environment_.RunUntilIdle();
+
+  GURL network_url("http://localhost/feed.json");
+  std::string if_none_match;
+  int response_code = net::HTTP_OK;
+  url_loader_factory_.SetInterceptor(
+      base::BindLambdaForTesting([&](const network::ResourceRequest& request) {
+        url_loader_factory_.ClearResponses();
+        if_none_match.clear();
+        request.headers.GetHeader("If-None-Match", &if_none_match);
+        auto head = network::CreateURLResponseHead(
+            static_cast<net::HttpStatusCode>(response_code));
+        head->headers->AddHeader("ETag", "\"v1\"");
+        url_loader_factory_.AddResponse(
+            request.url, std::move(head),
+            response_code == net::HTTP_OK ? "{\"a\":1}" : "",
+            network::URLLoaderCompletionStatus());
+      }));
+
+  auto request = [&](APIRequestResult* result) {
+    api_request_helper_->Request(
+        "GET", network_url, "", "", false,
+        base::BindLambdaForTesting(
+            [&, result](APIRequestResult r) { *result = std::move(r); }));
+    task_environment_.RunUntilIdle();
+  };
+
+  // First fetch is unconditional and populates the cache.
+  APIRequestResult result;
+  request(&result);
+  EXPECT_TRUE(if_none_match.empty());
+  EXPECT_EQ(200, result.response_code());
+  EXPECT_EQ(ParseJson("{\"a\":1}"), result.value_body());
+
+  // A 304 is answered from the cached value.
+  response_code = net::HTTP_NOT_MODIFIED;
+  request(&result);
+  EXPECT_EQ("\"v1\"", if_none_match);
+  EXPECT_EQ(200, result.response_code());
+  EXPECT_EQ("{\"a\":1}", result.body());
+  EXPECT_EQ(ParseJson("{\"a\":1}"), result.value_body());
+
+  auto* cache = api_request_helper_->response_cache();
+  EXPECT_EQ(1u, cache->hits());
+  EXPECT_EQ(1u, cache->misses());
+  EXPECT_EQ(7u, cache->bytes_saved());
+
+  // Validators and bodies survive a restart.
+  api_request_helper_->EnableResponseCache(temp_dir.GetPath(), "Test");
+  task_environment_.RunUntilIdle();
+  request(&result);
+  EXPECT_EQ("\"v1\"", if_none_match);
+  EXPECT_EQ(200, result.response_code());
+  EXPECT_EQ(ParseJson("{\"a\":1}"), result.value_body());
+}
+
+TEST_F(ApiRequestHelperUnitTest, ResponseCacheBudgets) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  APIRequestCache cache(temp_dir.GetPath(), "Test", /*max_memory_bytes=*/40,
+                        /*max_disk_bytes=*/15);
+  task_environment_.RunUntilIdle();
+
+  const base::flat_map<std::string, std::string> headers = {
+      {"etag", "\"v1\""}};
+  const GURL first_url("http://localhost/first.json");
+  const GURL second_url("http://localhost/second.json");
+  ASSERT_TRUE(cache.Store(first_url, headers, "[1,2,3,4]"));
+  cache.StoreValue(first_url, ParseJson("[1,2,3,4]"));
+  EXPECT_TRUE(cache.GetValue(first_url));
+  EXPECT_EQ(9u, cache.memory_bytes());
+
+  // The second body doesn't fit next to the first one on disk.
+  ASSERT_TRUE(cache.Store(second_url, headers, "[1,2,3]"));
+  EXPECT_FALSE(cache.GetEntry(first_url));
+  EXPECT_FALSE(cache.GetValue(first_url));
+  EXPECT_EQ(7u, cache.disk_bytes());
+  EXPECT_EQ(7u, cache.memory_bytes());
+  task_environment_.RunUntilIdle();
+
+  // Bodies that aren't in memory are read back from disk.
+  APIRequestCache restarted_cache(temp_dir.GetPath(), "Test");
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(restarted_cache.GetEntry(first_url));
+  ASSERT_TRUE(restarted_cache.GetEntry(second_url));
+  EXPECT_EQ(0u, restarted_cache.memory_bytes());
+  base::test::TestFuture<absl::optional<std::string>> body;
+  restarted_cache.GetBody(second_url, body.GetCallback());
+  EXPECT_EQ("[1,2,3]", body.Get());
+
+  // Entries are dropped once their body is gone.
+  ASSERT_TRUE(base::DeletePathRecursively(temp_dir.GetPath()));
+  base::test::TestFuture<absl::optional<std::string>> missing_body;
+  restarted_cache.GetBody(second_url, missing_body.GetCallback());
+  EXPECT_FALSE(missing_body.Get());
+  EXPECT_FALSE(restarted_cache.GetEntry(second_url));
+}
+
+TEST_F(ApiRequestHelperUnitTest, ClearResponseCache) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath cache_dir = temp_dir.GetPath().AppendASCII("cache");
+  const base::flat_map<std::string, std::string> headers = {
+      {"etag", "\"v1\""}};
+  const GURL url("http://localhost/feed.json");
+  {
+    APIRequestCache cache(cache_dir, "Test");
+    task_environment_.RunUntilIdle();
+    ASSERT_TRUE(cache.Store(url, headers, "[1]"));
+    task_environment_.RunUntilIdle();
+  }
+
+  // Entries that are still being loaded are dropped too.
+  APIRequestCache cache(cache_dir, "Test");
+  cache.Clear();
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(cache.GetEntry(url));
+  EXPECT_EQ(0u, cache.disk_bytes());
+  EXPECT_FALSE(base::PathExists(cache_dir));
+
+  ASSERT_TRUE(cache.Store(url, headers, "[1]"));
+  cache.Clear();
+  EXPECT_FALSE(cache.GetEntry(url));
+  EXPECT_FALSE(cache.GetValue(url));
+  EXPECT_EQ(0u, cache.memory_bytes());
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(cache_dir));
+}
+
 TEST_F(ApiRequestHelperUnitTest, Is2XXResponseCode) {
   EXPECT_TRUE(
       APIRequestResult(200, {}, {}, {}, net::OK, GURL()).Is2XXResponseCode());
@@ -37,11 +37,25 @@ void AsyncDataStore::AddTrainingInstance(
       .Then(std::move(callback));
 }
 
+void AsyncDataStore::AddTrainingInstances(
+    TrainingInstances training_instances,
+    base::OnceCallback<void(bool)> callback) {
+  data_store_.AsyncCall(&DataStore::AddTrainingInstances)
+      .WithArgs(std::move(training_instances))
+      .Then(std::move(callback));
+}
+
 void AsyncDataStore::LoadTrainingData(
     base::OnceCallback<void(TrainingData)> callback) {
   data_store_.AsyncCall(&DataStore::LoadTrainingData).Then(std::move(callback));
 }
 
+void AsyncDataStore::LoadColumnarTrainingData(
+    base::OnceCallback<void(ColumnarTrainingData)> callback) {
+  data_store_.AsyncCall(&DataStore::LoadColumnarTrainingData)
+      .Then(std::move(callback));
+}
+
 void AsyncDataStore::PurgeTrainingDataAfterExpirationDate() {
   data_store_.AsyncCall(&DataStore::PurgeTrainingDataAfterExpirationDate);
 }
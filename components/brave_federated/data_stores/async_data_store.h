@@ -31,7 +31,11 @@ class AsyncDataStore {
   void AddTrainingInstance(
       std::vector<brave_federated::mojom::CovariateInfoPtr> training_instance,
       base::OnceCallback<void(bool)> callback);
+  void AddTrainingInstances(TrainingInstances training_instances,
+                            base::OnceCallback<void(bool)> callback);
   void LoadTrainingData(base::OnceCallback<void(TrainingData)> callback);
+  void LoadColumnarTrainingData(
+      base::OnceCallback<void(ColumnarTrainingData)> callback);
   void PurgeTrainingDataAfterExpirationDate();
 
  private:
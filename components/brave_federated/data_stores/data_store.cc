@@ -5,12 +5,16 @@
 
 #include "brave/components/brave_federated/data_stores/data_store.h"
 
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
 #include <utility>
 
 #include "base/bind.h"
 #include "base/check.h"
 #include "base/containers/flat_map.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "sql/recovery.h"
@@ -63,6 +67,12 @@ void BindCovariateToStatement(
 
 namespace brave_federated {
 
+ColumnarTrainingData::ColumnarTrainingData() = default;
+ColumnarTrainingData::~ColumnarTrainingData() = default;
+ColumnarTrainingData::ColumnarTrainingData(ColumnarTrainingData&&) = default;
+ColumnarTrainingData& ColumnarTrainingData::operator=(ColumnarTrainingData&&) =
+    default;
+
 DataStore::DataStore(const DataStoreTask data_store_task,
                      const base::FilePath& db_file_path)
     : database_(
@@ -81,50 +91,79 @@ bool DataStore::InitializeDatabase() {
       base::BindRepeating(&DatabaseErrorCallback, &database_, db_file_path_));
 
   // Attach the database to our index file.
-  return database_.Open(db_file_path_) && MaybeCreateTable();
-}
+  if (!database_.Open(db_file_path_) || !MaybeCreateTable())
+    return false;
 
-int DataStore::GetNextTrainingInstanceId() {
-  sql::Statement statement(database_.GetUniqueStatement(
-      base::StringPrintf("SELECT MAX(training_instance_id) FROM %s",
-                         data_store_task_.name.c_str())
-          .c_str()));
+  next_training_instance_id_ = LoadNextTrainingInstanceId();
+  return true;
+}
 
-  if (statement.Step()) {
-    return statement.ColumnInt(0) + 1;
-  }
-  return 0;
+int DataStore::GetNextTrainingInstanceId() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return next_training_instance_id_;
 }
 
-void DataStore::SaveCovariate(
+bool DataStore::SaveCovariate(
     const brave_federated::mojom::CovariateInfo& covariate,
     int training_instance_id,
     const base::Time created_at) {
-  sql::Statement statement(database_.GetUniqueStatement(
-      base::StringPrintf("INSERT INTO %s (training_instance_id, "
-                         "feature_name, feature_type, "
-                         "feature_value, created_at) "
-                         "VALUES (?,?,?,?,?)",
-                         data_store_task_.name.c_str())
-          .c_str()));
+  // All inserts go through the same cached statement, the table name is fixed
+  // for the lifetime of |database_|.
+  sql::Statement statement(database_.GetCachedStatement(
+      SQL_FROM_HERE, base::StringPrintf("INSERT INTO %s (training_instance_id, "
+                                        "feature_name, feature_type, "
+                                        "feature_value, created_at) "
+                                        "VALUES (?,?,?,?,?)",
+                                        data_store_task_.name.c_str())
+                         .c_str()));
 
   BindCovariateToStatement(covariate, training_instance_id, created_at,
                            &statement);
-  statement.Run();
+  if (!statement.Run())
+    return false;
+
+  next_training_instance_id_ =
+      std::max(next_training_instance_id_, training_instance_id + 1);
+  return true;
 }
 
 bool DataStore::AddTrainingInstance(
-    const std::vector<brave_federated::mojom::CovariateInfoPtr>
-        training_instance) {
+    std::vector<brave_federated::mojom::CovariateInfoPtr> training_instance) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const int training_instance_id = GetNextTrainingInstanceId();
+  TrainingInstances training_instances;
+  training_instances.push_back(std::move(training_instance));
+  return AddTrainingInstances(training_instances);
+}
+
+bool DataStore::AddTrainingInstances(
+    const TrainingInstances& training_instances) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  const int first_training_instance_id = next_training_instance_id_;
   const base::Time created_at = base::Time::Now();
 
-  for (const auto& covariate : training_instance) {
-    SaveCovariate(*covariate, training_instance_id, created_at);
+  sql::Transaction transaction(&database_);
+  if (!transaction.Begin())
+    return false;
+
+  int training_instance_id = first_training_instance_id;
+  for (const auto& training_instance : training_instances) {
+    for (const auto& covariate : training_instance) {
+      if (!SaveCovariate(*covariate, training_instance_id, created_at)) {
+        next_training_instance_id_ = first_training_instance_id;
+        return false;
+      }
+    }
+    training_instance_id++;
+  }
+
+  if (!transaction.Commit()) {
+    next_training_instance_id_ = first_training_instance_id;
+    return false;
   }
 
+  next_training_instance_id_ = training_instance_id;
   return true;
 }
 
@@ -152,6 +191,58 @@ TrainingData DataStore::LoadTrainingData() {
   return training_instances;
 }
 
+ColumnarTrainingData DataStore::LoadColumnarTrainingData() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  ColumnarTrainingData training_data;
+  // Rows of an instance are inserted together, so scanning in insertion order
+  // only rarely needs to look up an instance's column.
+  sql::Statement statement(database_.GetUniqueStatement(
+      base::StringPrintf("SELECT training_instance_id, feature_name, "
+                         "feature_type, feature_value FROM %s ORDER BY id",
+                         data_store_task_.name.c_str())
+          .c_str()));
+
+  std::unordered_map<int, size_t> instance_columns;
+  int last_training_instance_id = 0;
+  size_t column = 0;
+  while (statement.Step()) {
+    if (static_cast<mojom::DataType>(statement.ColumnInt(2)) ==
+        mojom::DataType::kString) {
+      continue;
+    }
+
+    const int training_instance_id = statement.ColumnInt(0);
+    if (training_data.training_instance_ids.empty() ||
+        training_instance_id != last_training_instance_id) {
+      auto [it, inserted] = instance_columns.emplace(
+          training_instance_id, training_data.training_instance_ids.size());
+      if (inserted) {
+        training_data.training_instance_ids.push_back(training_instance_id);
+        for (auto& [type, values] : training_data.features) {
+          values.push_back(std::numeric_limits<float>::quiet_NaN());
+        }
+      }
+      column = it->second;
+      last_training_instance_id = training_instance_id;
+    }
+
+    const auto type = static_cast<mojom::CovariateType>(statement.ColumnInt(1));
+    auto feature = training_data.features.find(type);
+    if (feature == training_data.features.end()) {
+      std::vector<float> values(training_data.training_instance_ids.size(),
+                                std::numeric_limits<float>::quiet_NaN());
+      feature = training_data.features.emplace(type, std::move(values)).first;
+    }
+
+    double value;
+    if (base::StringToDouble(statement.ColumnString(3), &value))
+      feature->second[column] = static_cast<float>(value);
+  }
+
+  return training_data;
+}
+
 bool DataStore::DeleteTrainingData() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -161,6 +252,7 @@ bool DataStore::DeleteTrainingData() {
     return false;
 
   std::ignore = database_.Execute("VACUUM");
+  next_training_instance_id_ = 1;
   return true;
 }
 
@@ -180,6 +272,18 @@ void DataStore::PurgeTrainingDataAfterExpirationDate() {
   delete_statement.Run();
 }
 
+int DataStore::LoadNextTrainingInstanceId() {
+  sql::Statement statement(database_.GetUniqueStatement(
+      base::StringPrintf("SELECT MAX(training_instance_id) FROM %s",
+                         data_store_task_.name.c_str())
+          .c_str()));
+
+  if (statement.Step()) {
+    return statement.ColumnInt(0) + 1;
+  }
+  return 1;
+}
+
 bool DataStore::MaybeCreateTable() {
   if (database_.DoesTableExist(data_store_task_.name)) {
     return true;
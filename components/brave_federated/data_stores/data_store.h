@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/sequence_checker.h"
@@ -18,6 +19,21 @@
 namespace brave_federated {
 
 using TrainingData = base::flat_map<int, std::vector<mojom::CovariateInfoPtr>>;
+using TrainingInstances = std::vector<std::vector<mojom::CovariateInfoPtr>>;
+
+// Training data laid out feature-major so it can be fed to a trainer as is:
+// |features[type][i]| holds covariate |type| of |training_instance_ids[i]|, or
+// NaN if that instance doesn't have it. String covariates aren't numeric and
+// are left out.
+struct ColumnarTrainingData {
+  ColumnarTrainingData();
+  ~ColumnarTrainingData();
+  ColumnarTrainingData(ColumnarTrainingData&&);
+  ColumnarTrainingData& operator=(ColumnarTrainingData&&);
+
+  std::vector<int> training_instance_ids;
+  base::flat_map<mojom::CovariateType, std::vector<float>> features;
+};
 
 struct DataStoreTask {
   int id = 0;
@@ -37,16 +53,18 @@ class DataStore {
 
   bool InitializeDatabase();
 
-  int GetNextTrainingInstanceId();
-  void SaveCovariate(const brave_federated::mojom::CovariateInfo& covariate,
+  int GetNextTrainingInstanceId() const;
+  bool SaveCovariate(const brave_federated::mojom::CovariateInfo& covariate,
                      int training_instance_id,
                      const base::Time created_at);
   bool AddTrainingInstance(
-      const std::vector<brave_federated::mojom::CovariateInfoPtr>
-          training_instance);
+      std::vector<brave_federated::mojom::CovariateInfoPtr> training_instance);
+  // Adds all |training_instances| in a single transaction.
+  bool AddTrainingInstances(const TrainingInstances& training_instances);
 
   bool DeleteTrainingData();
   TrainingData LoadTrainingData();
+  ColumnarTrainingData LoadColumnarTrainingData();
   void PurgeTrainingDataAfterExpirationDate();
 
  protected:
@@ -58,6 +76,11 @@ class DataStore {
 
  private:
   bool MaybeCreateTable();
+  int LoadNextTrainingInstanceId();
+
+  // Instance ids are handed out from memory and seeded from the table on
+  // initialization, so that adding an instance doesn't need a query.
+  int next_training_instance_id_ = 1;
 
   SEQUENCE_CHECKER(sequence_checker_);
 };
@@ -3,13 +3,16 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/check.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "brave/components/brave_federated/data_stores/data_store.h"
 #include "content/public/test/browser_task_environment.h"
@@ -155,6 +158,17 @@ TEST_F(DataStoreTest, AddTrainingInstance) {
   EXPECT_EQ(2, TrainingInstanceCount());
 }
 
+TEST_F(DataStoreTest, AddTrainingInstances) {
+  TrainingData training_data = TrainingDataFromTestInfo();
+  TrainingInstances training_instances;
+  training_instances.push_back(std::move(training_data[0]));
+  training_instances.push_back(std::move(training_data[1]));
+  EXPECT_TRUE(data_store_->AddTrainingInstances(training_instances));
+  EXPECT_EQ(4, RecordCount());
+  EXPECT_EQ(2, TrainingInstanceCount());
+  EXPECT_EQ(3, data_store_->GetNextTrainingInstanceId());
+}
+
 TEST_F(DataStoreTest, LoadTrainingData) {
   InitializeDataStore();
   EXPECT_EQ(4, RecordCount());
@@ -169,6 +183,110 @@ TEST_F(DataStoreTest, LoadTrainingData) {
   }
 }
 
+TEST_F(DataStoreTest, LoadColumnarTrainingData) {
+  InitializeDataStore();
+  ColumnarTrainingData training_data = data_store_->LoadColumnarTrainingData();
+
+  EXPECT_EQ((std::vector<int>{1, 2}), training_data.training_instance_ids);
+  ASSERT_EQ(2U, training_data.features.size());
+  const auto& values =
+      training_data.features[static_cast<mojom::CovariateType>(2)];
+  EXPECT_EQ((std::vector<float>{24, 42}), values);
+  // Values that don't parse as numbers are missing.
+  for (float value :
+       training_data.features[static_cast<mojom::CovariateType>(1)]) {
+    EXPECT_TRUE(std::isnan(value));
+  }
+}
+
+TEST_F(DataStoreTest, LoadColumnarTrainingDataWithMissingCovariate) {
+  std::vector<mojom::CovariateInfoPtr> training_instance;
+  training_instance.push_back(mojom::CovariateInfo::New(
+      mojom::CovariateType::kAverageClickthroughRate, mojom::DataType::kDouble,
+      "0.5"));
+  EXPECT_TRUE(AddTrainingInstance(std::move(training_instance)));
+  training_instance.clear();
+  training_instance.push_back(mojom::CovariateInfo::New(
+      mojom::CovariateType::kNumberOfClickedLinkEvents, mojom::DataType::kInt,
+      "3"));
+  // String covariates are left out.
+  training_instance.push_back(mojom::CovariateInfo::New(
+      mojom::CovariateType::kNotificationAdEvent, mojom::DataType::kString,
+      "clicked"));
+  EXPECT_TRUE(AddTrainingInstance(std::move(training_instance)));
+
+  ColumnarTrainingData training_data = data_store_->LoadColumnarTrainingData();
+  ASSERT_EQ(2U, training_data.training_instance_ids.size());
+  EXPECT_EQ(2U, training_data.features.size());
+  const auto& rates =
+      training_data.features[mojom::CovariateType::kAverageClickthroughRate];
+  const auto& clicks =
+      training_data.features[mojom::CovariateType::kNumberOfClickedLinkEvents];
+  ASSERT_EQ(2U, rates.size());
+  ASSERT_EQ(2U, clicks.size());
+  EXPECT_EQ(0.5f, rates[0]);
+  EXPECT_TRUE(std::isnan(rates[1]));
+  EXPECT_TRUE(std::isnan(clicks[0]));
+  EXPECT_EQ(3.0f, clicks[1]);
+}
+
+// Adding instances in one batch stores the same data as adding them one at a
+// time, and the columnar load agrees with the row-wise load.
+TEST_F(DataStoreTest, BatchedWritesAndColumnarLoadMatchRowPath) {
+  constexpr int kTrainingInstanceCount = 20;
+  constexpr int kCovariateCount = 3;
+
+  auto make_training_instance = [](int i) {
+    std::vector<mojom::CovariateInfoPtr> training_instance;
+    for (int j = 0; j < kCovariateCount; ++j) {
+      training_instance.push_back(mojom::CovariateInfo::New(
+          static_cast<mojom::CovariateType>(j), mojom::DataType::kDouble,
+          base::NumberToString(i * j + 0.5)));
+    }
+    return training_instance;
+  };
+
+  DataStore batched_data_store(
+      {1, "batched_federated_task", kTrainingInstanceCount, base::Days(30)},
+      temp_dir_.GetPath().Append(FILE_PATH_LITERAL("batched_data_store")));
+  ASSERT_TRUE(batched_data_store.InitializeDatabase());
+  TrainingInstances training_instances;
+  for (int i = 0; i < kTrainingInstanceCount; ++i) {
+    training_instances.push_back(make_training_instance(i));
+    ASSERT_TRUE(AddTrainingInstance(make_training_instance(i)));
+  }
+  ASSERT_TRUE(batched_data_store.AddTrainingInstances(training_instances));
+
+  TrainingData training_data = data_store_->LoadTrainingData();
+  TrainingData batched_training_data = batched_data_store.LoadTrainingData();
+  ASSERT_EQ(static_cast<size_t>(kTrainingInstanceCount), training_data.size());
+  ASSERT_EQ(training_data.size(), batched_training_data.size());
+  for (const auto& [id, training_instance] : training_data) {
+    const auto& batched_training_instance = batched_training_data[id];
+    ASSERT_EQ(training_instance.size(), batched_training_instance.size());
+    for (size_t j = 0; j < training_instance.size(); ++j) {
+      EXPECT_TRUE(training_instance[j].Equals(batched_training_instance[j]));
+    }
+  }
+
+  ColumnarTrainingData columnar_training_data =
+      batched_data_store.LoadColumnarTrainingData();
+  ASSERT_EQ(static_cast<size_t>(kTrainingInstanceCount),
+            columnar_training_data.training_instance_ids.size());
+  ASSERT_EQ(static_cast<size_t>(kCovariateCount),
+            columnar_training_data.features.size());
+  for (size_t i = 0; i < columnar_training_data.training_instance_ids.size();
+       ++i) {
+    const int id = columnar_training_data.training_instance_ids[i];
+    for (const auto& covariate : batched_training_data[id]) {
+      double value;
+      ASSERT_TRUE(base::StringToDouble(covariate->value, &value));
+      EXPECT_EQ(static_cast<float>(value),
+                columnar_training_data.features[covariate->type][i]);
+    }
+  }
+}
+
 TEST_F(DataStoreTest, DeleteLogs) {
   InitializeDataStore();
   EXPECT_EQ(4, RecordCount());
@@ -0,0 +1,424 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_page_graph/common/binary_graph.h"
+
+#include <limits>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/memory/raw_ptr.h"
+#include "third_party/zlib/zlib.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+constexpr char kMagic[] = {'P', 'G', 'B'};
+constexpr uint8_t kVersion = 1;
+constexpr uint8_t kKnownFlags = BinaryGraphWriter::kCompressed;
+// Recordings are decompressed in one go, refuse to allocate more than this.
+constexpr uint64_t kMaxPayloadSize = 1u << 31;
+
+// Strings longer than this are mostly URLs and script sources that seldom
+// repeat, looking them up costs more than it saves.
+constexpr size_t kMaxInternedStringSize = 32;
+// String ref of a string that directly follows in the strings section instead
+// of being in the table, refs of table strings are their index plus one.
+constexpr uint64_t kInlineString = 0;
+
+enum Op : uint8_t {
+  kEndElement,
+  kStartElement,
+  kAttribute,
+  kIdAttribute,
+  kText,
+  kEncodedText,
+  kNumberText,
+  kUnsignedNumberText,
+};
+
+void AppendVarint(uint64_t value, std::string* output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Reads sequentially from a buffer, failing on truncated or oversized input
+// instead of reading past the end.
+class Cursor {
+ public:
+  explicit Cursor(base::StringPiece data) : data_(data) {}
+
+  bool AtEnd() const { return data_.empty(); }
+
+  bool ReadByte(uint8_t* value) {
+    if (data_.empty())
+      return false;
+    *value = static_cast<uint8_t>(data_[0]);
+    data_.remove_prefix(1);
+    return true;
+  }
+
+  bool ReadVarint(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!ReadByte(&byte))
+        return false;
+      *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool ReadBytes(uint64_t size, base::StringPiece* value) {
+    if (size > data_.size())
+      return false;
+    *value = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return true;
+  }
+
+  base::StringPiece ReadRemaining() {
+    base::StringPiece rest = data_;
+    data_ = base::StringPiece();
+    return rest;
+  }
+
+  bool ReadSection(base::StringPiece* section) {
+    uint64_t size;
+    return ReadVarint(&size) && ReadBytes(size, section);
+  }
+
+ private:
+  base::StringPiece data_;
+};
+
+class Replayer {
+ public:
+  Replayer(base::StringPiece ops,
+           base::StringPiece refs,
+           base::StringPiece ints,
+           base::StringPiece strings,
+           GraphMLWriter* writer)
+      : ops_(ops),
+        refs_(refs),
+        ints_(ints),
+        strings_(strings),
+        writer_(writer) {}
+
+  bool Run() {
+    uint8_t op;
+    while (ops_.ReadByte(&op)) {
+      if (!ReplayOp(static_cast<Op>(op)))
+        return false;
+    }
+    return refs_.AtEnd() && ints_.AtEnd() && strings_.AtEnd();
+  }
+
+ private:
+  bool ReplayOp(Op op) {
+    // Attributes are only valid straight after a start tag.
+    const bool in_start_tag = in_start_tag_;
+    in_start_tag_ = false;
+
+    switch (op) {
+      case kEndElement:
+        if (!depth_)
+          return false;
+        --depth_;
+        writer_->EndElement();
+        return true;
+      case kStartElement: {
+        const std::string* name;
+        if (!ReadName(&name))
+          return false;
+        ++depth_;
+        in_start_tag_ = true;
+        writer_->StartElement(name->c_str());
+        return true;
+      }
+      case kAttribute: {
+        const std::string* name;
+        const std::string* value;
+        if (!in_start_tag || !ReadName(&name) || !ReadString(&value))
+          return false;
+        in_start_tag_ = true;
+        writer_->AddAttribute(name->c_str(), *value);
+        return true;
+      }
+      case kIdAttribute: {
+        const std::string* name;
+        uint64_t prefix;
+        uint64_t id;
+        if (!in_start_tag || !ReadName(&name) ||
+            !ints_.ReadVarint(&prefix) ||
+            prefix > std::numeric_limits<uint8_t>::max() ||
+            !ints_.ReadVarint(&id)) {
+          return false;
+        }
+        in_start_tag_ = true;
+        writer_->AddIdAttribute(name->c_str(), static_cast<char>(prefix), id);
+        return true;
+      }
+      case kText:
+      case kEncodedText: {
+        const std::string* text;
+        if (!depth_ || !ReadString(&text))
+          return false;
+        if (op == kText) {
+          writer_->AddText(*text);
+        } else {
+          writer_->AddEncodedText(*text);
+        }
+        return true;
+      }
+      case kNumberText:
+      case kUnsignedNumberText: {
+        uint64_t value;
+        if (!depth_ || !ints_.ReadVarint(&value))
+          return false;
+        if (op == kNumberText) {
+          writer_->AddNumberText(ZigZagDecode(value));
+        } else {
+          writer_->AddUnsignedNumberText(value);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Writers may keep element and attribute names until the element ends, so
+  // they must come from |table_| rather than |inline_string_|.
+  bool ReadName(const std::string** name) {
+    return ReadString(name, /*allow_inline=*/false);
+  }
+
+  bool ReadString(const std::string** value, bool allow_inline = true) {
+    uint64_t ref;
+    if (!refs_.ReadVarint(&ref) || (ref == kInlineString && !allow_inline))
+      return false;
+    if (ref != kInlineString && ref <= table_.size()) {
+      *value = &table_[ref - 1];
+      return true;
+    }
+    if (ref > table_.size() + 1)
+      return false;
+
+    uint64_t size;
+    base::StringPiece string;
+    if (!strings_.ReadVarint(&size) || !strings_.ReadBytes(size, &string))
+      return false;
+    if (ref == kInlineString) {
+      inline_string_.assign(string.data(), string.size());
+      *value = &inline_string_;
+      return true;
+    }
+    table_.emplace_back(string);
+    *value = &table_.back();
+    return true;
+  }
+
+  Cursor ops_;
+  Cursor refs_;
+  Cursor ints_;
+  Cursor strings_;
+  raw_ptr<GraphMLWriter> writer_;
+
+  // Elements never move, the writer may hold on to element names.
+  std::deque<std::string> table_;
+  // Only holds attribute values and text, which writers don't keep;
+  // ReadName() never returns it.
+  std::string inline_string_;
+  size_t depth_ = 0;
+  bool in_start_tag_ = false;
+};
+
+}  // namespace
+
+BinaryGraphWriter::BinaryGraphWriter(bool compress) : compress_(compress) {}
+
+BinaryGraphWriter::~BinaryGraphWriter() = default;
+
+void BinaryGraphWriter::StartElement(const char* name) {
+  ops_.push_back(kStartElement);
+  AddName(name);
+  ++depth_;
+}
+
+void BinaryGraphWriter::AddAttribute(const char* name,
+                                     base::StringPiece value) {
+  ops_.push_back(kAttribute);
+  AddName(name);
+  AddString(value);
+}
+
+void BinaryGraphWriter::AddIdAttribute(const char* name,
+                                       char prefix,
+                                       uint64_t id) {
+  ops_.push_back(kIdAttribute);
+  AddName(name);
+  AppendVarint(static_cast<uint8_t>(prefix), &ints_);
+  AppendVarint(id, &ints_);
+}
+
+void BinaryGraphWriter::EndElement() {
+  DCHECK_GT(depth_, 0u);
+  ops_.push_back(kEndElement);
+  --depth_;
+}
+
+void BinaryGraphWriter::AddText(base::StringPiece text) {
+  ops_.push_back(kText);
+  AddString(text);
+}
+
+void BinaryGraphWriter::AddEncodedText(base::StringPiece text) {
+  // Stored as is, the encoding is applied by whatever the recording is
+  // replayed into.
+  ops_.push_back(kEncodedText);
+  AddString(text);
+}
+
+void BinaryGraphWriter::AddNumberText(int64_t value) {
+  ops_.push_back(kNumberText);
+  AppendVarint(ZigZagEncode(value), &ints_);
+}
+
+void BinaryGraphWriter::AddUnsignedNumberText(uint64_t value) {
+  ops_.push_back(kUnsignedNumberText);
+  AppendVarint(value, &ints_);
+}
+
+std::string BinaryGraphWriter::Finish() {
+  while (depth_) {
+    EndElement();
+  }
+
+  std::string payload;
+  payload.reserve(ops_.size() + refs_.size() + ints_.size() +
+                  strings_.size() + 40);
+  for (const std::string* section : {&ops_, &refs_, &ints_, &strings_}) {
+    AppendVarint(section->size(), &payload);
+    payload.append(*section);
+  }
+
+  std::string output(kMagic, sizeof(kMagic));
+  output.push_back(kVersion);
+  if (!compress_) {
+    output.push_back(0);
+    output.append(payload);
+    return output;
+  }
+
+  output.push_back(kCompressed);
+  AppendVarint(payload.size(), &output);
+  const size_t header_size = output.size();
+  uLongf compressed_size = compressBound(payload.size());
+  output.resize(header_size + compressed_size);
+  const int result = compress2(
+      reinterpret_cast<Bytef*>(&output[header_size]), &compressed_size,
+      reinterpret_cast<const Bytef*>(payload.data()), payload.size(),
+      Z_BEST_SPEED);
+  if (result != Z_OK) {
+    return std::string();
+  }
+  output.resize(header_size + compressed_size);
+  return output;
+}
+
+void BinaryGraphWriter::AddName(const char* name) {
+  AddString(name, /*intern=*/true);
+}
+
+void BinaryGraphWriter::AddString(base::StringPiece value, bool intern) {
+  if (!intern && value.size() > kMaxInternedStringSize) {
+    AppendVarint(kInlineString, &refs_);
+    AppendVarint(value.size(), &strings_);
+    strings_.append(value.data(), value.size());
+    return;
+  }
+
+  auto it = string_ids_.find(value);
+  if (it != string_ids_.end()) {
+    AppendVarint(it->second, &refs_);
+    return;
+  }
+
+  const uint32_t ref = interned_strings_.size() + 1;
+  AppendVarint(ref, &refs_);
+  AppendVarint(value.size(), &strings_);
+  strings_.append(value.data(), value.size());
+  interned_strings_.emplace_back(value);
+  string_ids_.emplace(interned_strings_.back(), ref);
+}
+
+bool ReplayBinaryGraph(base::StringPiece data, GraphMLWriter* writer) {
+  DCHECK(writer);
+  Cursor cursor(data);
+  base::StringPiece magic;
+  uint8_t version;
+  uint8_t flags;
+  if (!cursor.ReadBytes(sizeof(kMagic), &magic) ||
+      magic != base::StringPiece(kMagic, sizeof(kMagic)) ||
+      !cursor.ReadByte(&version) || version != kVersion ||
+      !cursor.ReadByte(&flags) || (flags & ~kKnownFlags)) {
+    return false;
+  }
+
+  base::StringPiece payload = cursor.ReadRemaining();
+  std::string decompressed;
+  if (flags & BinaryGraphWriter::kCompressed) {
+    Cursor compressed(payload);
+    uint64_t payload_size;
+    if (!compressed.ReadVarint(&payload_size) ||
+        payload_size > kMaxPayloadSize) {
+      return false;
+    }
+    const base::StringPiece deflated = compressed.ReadRemaining();
+    decompressed.resize(payload_size);
+    uLongf decompressed_size = payload_size;
+    uLong deflated_size = deflated.size();
+    // uncompress2() stops at the end of the stream, anything after it means
+    // the recording is corrupt.
+    if (uncompress2(reinterpret_cast<Bytef*>(&decompressed[0]),
+                    &decompressed_size,
+                    reinterpret_cast<const Bytef*>(deflated.data()),
+                    &deflated_size) != Z_OK ||
+        decompressed_size != payload_size ||
+        deflated_size != deflated.size()) {
+      return false;
+    }
+    payload = decompressed;
+  }
+
+  Cursor sections(payload);
+  base::StringPiece ops;
+  base::StringPiece refs;
+  base::StringPiece ints;
+  base::StringPiece strings;
+  if (!sections.ReadSection(&ops) || !sections.ReadSection(&refs) ||
+      !sections.ReadSection(&ints) || !sections.ReadSection(&strings) ||
+      !sections.AtEnd()) {
+    return false;
+  }
+  return Replayer(ops, refs, ints, strings, writer).Run();
+}
+
+}  // namespace brave_page_graph
@@ -0,0 +1,86 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_BINARY_GRAPH_H_
+#define BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_BINARY_GRAPH_H_
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "base/strings/string_piece.h"
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
+
+namespace brave_page_graph {
+
+// Records the GraphMLWriter calls that make up a page graph in a compact
+// binary form, which ReplayBinaryGraph() turns back into the exact same calls.
+// Converting the output to GraphML happens offline (see
+// //brave/components/brave_page_graph/tools), so the browser only pays for
+// this cheaper encoding.
+//
+// Layout: the "PGB" magic, a version byte and a flags byte, followed by the
+// payload, which is deflated if kCompressed is set and then starts with its
+// uncompressed size as a varint. The payload is made of four length-prefixed
+// sections that are read in lockstep:
+//  - ops: one byte per writer call,
+//  - refs: one varint per string. Short strings are stored once and referred
+//    to by their index plus one, a ref one past the last index adds the next
+//    one. 0 marks a string that isn't kept,
+//  - ints: varints (zigzag encoded for signed values),
+//  - strings: the contents of new and non-kept strings, each prefixed with
+//    its length.
+class BinaryGraphWriter : public GraphMLWriter {
+ public:
+  enum Flags : uint8_t {
+    kCompressed = 1 << 0,
+  };
+
+  explicit BinaryGraphWriter(bool compress);
+  ~BinaryGraphWriter() override;
+
+  BinaryGraphWriter(const BinaryGraphWriter&) = delete;
+  BinaryGraphWriter& operator=(const BinaryGraphWriter&) = delete;
+
+  // GraphMLWriter:
+  void StartElement(const char* name) override;
+  void AddAttribute(const char* name, base::StringPiece value) override;
+  void AddIdAttribute(const char* name, char prefix, uint64_t id) override;
+  void EndElement() override;
+  void AddText(base::StringPiece text) override;
+  void AddEncodedText(base::StringPiece text) override;
+  void AddNumberText(int64_t value) override;
+  void AddUnsignedNumberText(uint64_t value) override;
+  // Returns an empty string if the recording couldn't be compressed, e.g. for
+  // lack of memory.
+  std::string Finish() override;
+
+ private:
+  // Element and attribute names are always interned, replaying relies on it.
+  void AddName(const char* name);
+  void AddString(base::StringPiece value, bool intern = false);
+
+  const bool compress_;
+  size_t depth_ = 0;
+
+  std::string ops_;
+  std::string refs_;
+  std::string ints_;
+  std::string strings_;
+  // Keys point into |interned_strings_|, whose elements never move.
+  std::deque<std::string> interned_strings_;
+  std::unordered_map<base::StringPiece, uint32_t, base::StringPieceHash>
+      string_ids_;
+};
+
+// Replays a graph recorded with BinaryGraphWriter into |writer|, without
+// calling Finish() on it. Returns false if |data| isn't a valid recording, in
+// which case |writer| may have received part of the graph.
+bool ReplayBinaryGraph(base::StringPiece data, GraphMLWriter* writer);
+
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_BINARY_GRAPH_H_
@@ -0,0 +1,165 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_page_graph/common/binary_graph.h"
+
+#include <string>
+
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+// Writes a graph shaped like PageGraph::ToGraphML() output.
+void WriteGraph(size_t node_count, GraphMLWriter* writer) {
+  writer->StartElement("graphml");
+  writer->AddAttribute("xmlns", "http://graphml.graphdrawing.org/xmlns");
+  writer->StartElement("desc");
+  writer->AddTextElement("frame_id", "frame & <id>");
+  writer->AddTextElement("empty", "");
+  writer->EndElement();
+  writer->StartElement("key");
+  writer->AddAttribute("id", "d1");
+  writer->AddAttribute("attr.name", "quotes \" and\ttabs");
+  writer->EndElement();
+
+  writer->StartElement("graph");
+  writer->AddAttribute("id", "G");
+  for (size_t i = 0; i < node_count; ++i) {
+    writer->StartElement("node");
+    writer->AddIdAttribute("id", 'n', i);
+    writer->StartElement("data");
+    writer->AddAttribute("key", "d1");
+    writer->AddEncodedText(i % 2 ? "HTML element" : "script");
+    writer->EndElement();
+    writer->StartElement("data");
+    writer->AddAttribute("key", "d2");
+    writer->AddEncodedText(base::StrCat(
+        {"https://example.com/?a=", base::NumberToString(i), "&b=<\x01>\xff"}));
+    writer->EndElement();
+    writer->StartElement("data");
+    writer->AddAttribute("key", "d3");
+    writer->AddNumberText(-static_cast<int64_t>(i) * 1000);
+    writer->EndElement();
+    writer->EndElement();
+
+    if (i) {
+      writer->StartElement("edge");
+      writer->AddIdAttribute("id", 'e', node_count + i);
+      writer->AddIdAttribute("source", 'n', i - 1);
+      writer->AddIdAttribute("target", 'n', i);
+      writer->StartElement("data");
+      writer->AddAttribute("key", "d4");
+      writer->AddUnsignedNumberText(UINT64_MAX - i);
+      writer->EndElement();
+      writer->EndElement();
+    }
+  }
+  // Left open, Finish() closes the remaining elements.
+}
+
+std::string WriteText(size_t node_count) {
+  GraphMLTextWriter writer;
+  WriteGraph(node_count, &writer);
+  return writer.Finish();
+}
+
+std::string WriteBinary(size_t node_count, bool compress) {
+  BinaryGraphWriter writer(compress);
+  WriteGraph(node_count, &writer);
+  return writer.Finish();
+}
+
+bool Convert(const std::string& binary, std::string* graphml) {
+  GraphMLTextWriter writer;
+  if (!ReplayBinaryGraph(binary, &writer))
+    return false;
+  *graphml = writer.Finish();
+  return true;
+}
+
+// Builds an uncompressed recording out of raw sections.
+std::string MakeRecording(base::StringPiece ops,
+                          base::StringPiece refs,
+                          base::StringPiece strings) {
+  std::string recording("PGB\x01\x00", 5);
+  for (base::StringPiece section : {ops, refs, base::StringPiece(), strings}) {
+    recording.push_back(static_cast<char>(section.size()));
+    recording.append(section.data(), section.size());
+  }
+  return recording;
+}
+
+}  // namespace
+
+TEST(BinaryGraphTest, ConvertsToSameGraphML) {
+  for (bool compress : {false, true}) {
+    for (size_t node_count : {0, 1, 50}) {
+      std::string graphml;
+      ASSERT_TRUE(Convert(WriteBinary(node_count, compress), &graphml));
+      EXPECT_EQ(WriteText(node_count), graphml);
+    }
+  }
+}
+
+TEST(BinaryGraphTest, RejectsInvalidInput) {
+  std::string graphml;
+  EXPECT_FALSE(Convert("", &graphml));
+  EXPECT_FALSE(Convert("<?xml version=\"1.0\"?>", &graphml));
+
+  for (bool compress : {false, true}) {
+    const std::string binary = WriteBinary(5, compress);
+    for (size_t size = 0; size < binary.size(); ++size) {
+      EXPECT_FALSE(Convert(binary.substr(0, size), &graphml)) << size;
+    }
+    EXPECT_FALSE(Convert(binary + '\0', &graphml));
+
+    std::string bad_version = binary;
+    bad_version[3] = 2;
+    EXPECT_FALSE(Convert(bad_version, &graphml));
+  }
+}
+
+TEST(BinaryGraphTest, RejectsInlineNames) {
+  using base::StringPiece;
+  // Start and end of a "node" element, whose name is table string 1.
+  const StringPiece ops("\x01\x00", 2);
+  const StringPiece strings("\x04node", 5);
+  std::string graphml;
+  ASSERT_TRUE(
+      Convert(MakeRecording(ops, StringPiece("\x01", 1), strings), &graphml));
+  EXPECT_EQ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<node/>\n", graphml);
+
+  // The same name given inline.
+  EXPECT_FALSE(
+      Convert(MakeRecording(ops, StringPiece("\x00", 1), strings), &graphml));
+
+  // A "node" element with an attribute named "a" given inline.
+  const StringPiece attribute_ops("\x01\x02\x00", 3);
+  const StringPiece attribute_strings("\x04node\x01a", 7);
+  EXPECT_FALSE(Convert(MakeRecording(attribute_ops,
+                                     StringPiece("\x01\x00\x01", 3),
+                                     attribute_strings),
+                       &graphml));
+}
+
+TEST(BinaryGraphTest, RecordingIsSmallerThanGraphML) {
+  constexpr size_t kNodeCount = 1000;
+  const std::string text = WriteText(kNodeCount);
+  const std::string binary = WriteBinary(kNodeCount, false);
+  const std::string compressed = WriteBinary(kNodeCount, true);
+  EXPECT_LT(binary.size(), text.size());
+  EXPECT_LT(compressed.size(), binary.size());
+
+  std::string graphml;
+  ASSERT_TRUE(Convert(compressed, &graphml));
+  EXPECT_EQ(text, graphml);
+}
+
+}  // namespace brave_page_graph
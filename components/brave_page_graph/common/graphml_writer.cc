@@ -0,0 +1,224 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
+
+#include <utility>
+
+#include "base/check.h"
+#include "base/strings/string_number_conversions.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+// Escaping of text content, see xmlEscapeContent() in libxml's xmlsave.c.
+void AppendEscapedText(char c, std::string* output) {
+  switch (c) {
+    case '<':
+      output->append("&lt;");
+      break;
+    case '>':
+      output->append("&gt;");
+      break;
+    case '&':
+      output->append("&amp;");
+      break;
+    case '\r':
+      output->append("&#13;");
+      break;
+    default:
+      output->push_back(c);
+  }
+}
+
+// Escaping of attribute values, see xmlBufAttrSerializeTxtContent().
+void AppendEscapedAttributeValue(base::StringPiece value, std::string* output) {
+  for (char c : value) {
+    switch (c) {
+      case '<':
+        output->append("&lt;");
+        break;
+      case '>':
+        output->append("&gt;");
+        break;
+      case '&':
+        output->append("&amp;");
+        break;
+      case '"':
+        output->append("&quot;");
+        break;
+      case '\n':
+        output->append("&#10;");
+        break;
+      case '\r':
+        output->append("&#13;");
+        break;
+      case '\t':
+        output->append("&#9;");
+        break;
+      default:
+        output->push_back(c);
+    }
+  }
+}
+
+// Matches libxml's IS_CHAR() for code points outside of ASCII.
+bool IsXmlChar(uint32_t code_point) {
+  return (code_point >= 0x80 && code_point <= 0xD7FF) ||
+         (code_point >= 0xE000 && code_point <= 0xFFFD) ||
+         (code_point >= 0x10000 && code_point <= 0x10FFFF);
+}
+
+// Returns the length of the UTF-8 sequence at the start of |text|, or 0 if
+// it's not a valid XML character.
+size_t GetUTF8SequenceLength(base::StringPiece text) {
+  const uint8_t lead = static_cast<uint8_t>(text[0]);
+  size_t length;
+  uint32_t code_point;
+  if (lead >= 0xC0 && lead < 0xE0) {
+    length = 2;
+    code_point = lead & 0x1F;
+  } else if (lead >= 0xE0 && lead < 0xF0) {
+    length = 3;
+    code_point = lead & 0x0F;
+  } else if (lead >= 0xF0 && lead < 0xF8) {
+    length = 4;
+    code_point = lead & 0x07;
+  } else {
+    return 0;
+  }
+  if (text.size() < length)
+    return 0;
+
+  for (size_t i = 1; i < length; ++i) {
+    const uint8_t trail = static_cast<uint8_t>(text[i]);
+    if ((trail & 0xC0) != 0x80)
+      return 0;
+    code_point = (code_point << 6) | (trail & 0x3F);
+  }
+  return IsXmlChar(code_point) ? length : 0;
+}
+
+}  // namespace
+
+void GraphMLWriter::AddTextElement(const char* name, base::StringPiece text) {
+  StartElement(name);
+  AddText(text);
+  EndElement();
+}
+
+GraphMLTextWriter::GraphMLTextWriter(size_t size_hint) {
+  output_.reserve(size_hint);
+  output_.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+}
+
+GraphMLTextWriter::~GraphMLTextWriter() = default;
+
+void GraphMLTextWriter::StartElement(const char* name) {
+  CloseStartTag();
+  output_.push_back('<');
+  output_.append(name);
+  open_elements_.push_back(name);
+  start_tag_open_ = true;
+}
+
+void GraphMLTextWriter::AddAttribute(const char* name,
+                                     base::StringPiece value) {
+  DCHECK(start_tag_open_);
+  output_.push_back(' ');
+  output_.append(name);
+  output_.append("=\"");
+  AppendEscapedAttributeValue(value, &output_);
+  output_.push_back('"');
+}
+
+void GraphMLTextWriter::AddIdAttribute(const char* name,
+                                       char prefix,
+                                       uint64_t id) {
+  DCHECK(start_tag_open_);
+  output_.push_back(' ');
+  output_.append(name);
+  output_.append("=\"");
+  output_.push_back(prefix);
+  output_.append(base::NumberToString(id));
+  output_.push_back('"');
+}
+
+void GraphMLTextWriter::EndElement() {
+  DCHECK(!open_elements_.empty());
+  // Elements without content are self-closing.
+  if (start_tag_open_) {
+    output_.append("/>");
+    start_tag_open_ = false;
+  } else {
+    output_.append("</");
+    output_.append(open_elements_.back());
+    output_.push_back('>');
+  }
+  open_elements_.pop_back();
+}
+
+void GraphMLTextWriter::AddText(base::StringPiece text) {
+  // xmlNewTextChild() keeps a text node even for empty content, so the element
+  // isn't self-closing then.
+  CloseStartTag();
+  for (char c : text) {
+    AppendEscapedText(c, &output_);
+  }
+}
+
+void GraphMLTextWriter::AddEncodedText(base::StringPiece text) {
+  for (size_t i = 0; i < text.size();) {
+    const uint8_t c = static_cast<uint8_t>(text[i]);
+    if (c == 0)
+      break;
+
+    if (c < 0x80) {
+      if (c >= 0x20 || c == '\t' || c == '\n' || c == '\r') {
+        CloseStartTag();
+        AppendEscapedText(static_cast<char>(c), &output_);
+      }
+      ++i;
+      continue;
+    }
+
+    CloseStartTag();
+    const size_t length = GetUTF8SequenceLength(text.substr(i));
+    if (length) {
+      output_.append(text.data() + i, length);
+      i += length;
+      continue;
+    }
+    output_.push_back(static_cast<char>(0xC0 | (c >> 6)));
+    output_.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+    ++i;
+  }
+}
+
+void GraphMLTextWriter::AddNumberText(int64_t value) {
+  AddText(base::NumberToString(value));
+}
+
+void GraphMLTextWriter::AddUnsignedNumberText(uint64_t value) {
+  AddText(base::NumberToString(value));
+}
+
+std::string GraphMLTextWriter::Finish() {
+  while (!open_elements_.empty()) {
+    EndElement();
+  }
+  output_.push_back('\n');
+  return std::move(output_);
+}
+
+void GraphMLTextWriter::CloseStartTag() {
+  if (!start_tag_open_)
+    return;
+  output_.push_back('>');
+  start_tag_open_ = false;
+}
+
+}  // namespace brave_page_graph
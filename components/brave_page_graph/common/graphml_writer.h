@@ -0,0 +1,84 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_GRAPHML_WRITER_H_
+#define BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_GRAPHML_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+
+namespace brave_page_graph {
+
+// Receives a page graph's GraphML document piece by piece and serializes it.
+class GraphMLWriter {
+ public:
+  virtual ~GraphMLWriter() = default;
+
+  // Element names must outlive the element, they are string literals
+  // everywhere.
+  virtual void StartElement(const char* name) = 0;
+  // Must directly follow StartElement() or another attribute.
+  virtual void AddAttribute(const char* name, base::StringPiece value) = 0;
+  // Adds an attribute with the value |prefix| followed by |id|, e.g. "n42".
+  virtual void AddIdAttribute(const char* name, char prefix, uint64_t id) = 0;
+  virtual void EndElement() = 0;
+
+  // Adds |text| as is, like content passed to xmlNewTextChild().
+  virtual void AddText(base::StringPiece text) = 0;
+  // Adds |text| the way it ended up in the tree when it was passed through
+  // xmlEncodeEntitiesReentrant() into xmlNewChild(): the content stops at the
+  // first NUL, control characters other than tabs, newlines and carriage
+  // returns are dropped and bytes that aren't part of valid UTF-8 are read as
+  // Latin-1.
+  virtual void AddEncodedText(base::StringPiece text) = 0;
+  // Add the decimal representation of |value|.
+  virtual void AddNumberText(int64_t value) = 0;
+  virtual void AddUnsignedNumberText(uint64_t value) = 0;
+
+  // Closes all open elements and returns the serialized document.
+  virtual std::string Finish() = 0;
+
+  // Shorthand for an element that only holds |text|, added with AddText().
+  void AddTextElement(const char* name, base::StringPiece text);
+};
+
+// Writes GraphML straight into a growing buffer, without building a document
+// tree first. The output is byte-identical to what libxml's
+// xmlDocDumpMemoryEnc(doc, ..., "UTF-8") produced for the same tree built with
+// xmlNewChild()/xmlNewTextChild()/xmlSetProp(), which is what page graphs used
+// to be serialized with.
+class GraphMLTextWriter : public GraphMLWriter {
+ public:
+  explicit GraphMLTextWriter(size_t size_hint = 0);
+  ~GraphMLTextWriter() override;
+
+  GraphMLTextWriter(const GraphMLTextWriter&) = delete;
+  GraphMLTextWriter& operator=(const GraphMLTextWriter&) = delete;
+
+  // GraphMLWriter:
+  void StartElement(const char* name) override;
+  void AddAttribute(const char* name, base::StringPiece value) override;
+  void AddIdAttribute(const char* name, char prefix, uint64_t id) override;
+  void EndElement() override;
+  void AddText(base::StringPiece text) override;
+  void AddEncodedText(base::StringPiece text) override;
+  void AddNumberText(int64_t value) override;
+  void AddUnsignedNumberText(uint64_t value) override;
+  std::string Finish() override;
+
+ private:
+  void CloseStartTag();
+
+  std::string output_;
+  std::vector<const char*> open_elements_;
+  bool start_tag_open_ = false;
+};
+
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_COMPONENTS_BRAVE_PAGE_GRAPH_COMMON_GRAPHML_WRITER_H_
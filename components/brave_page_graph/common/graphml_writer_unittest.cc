@@ -0,0 +1,228 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
+
+#include <libxml/entities.h>
+#include <libxml/tree.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+// Builds a libxml document tree with the calls PageGraph::ToGraphML() and the
+// graph items used before GraphMLTextWriter, and dumps it the same way.
+class LibxmlGraphMLWriter : public GraphMLWriter {
+ public:
+  LibxmlGraphMLWriter() : doc_(xmlNewDoc(BAD_CAST "1.0")) {}
+  ~LibxmlGraphMLWriter() override { xmlFreeDoc(doc_); }
+
+  void StartElement(const char* name) override {
+    xmlNodePtr node;
+    if (open_elements_.empty()) {
+      node = xmlNewNode(nullptr, BAD_CAST name);
+      xmlDocSetRootElement(doc_, node);
+    } else {
+      node = xmlNewChild(open_elements_.back(), nullptr, BAD_CAST name,
+                         nullptr);
+    }
+    open_elements_.push_back(node);
+  }
+
+  void AddAttribute(const char* name, base::StringPiece value) override {
+    const std::string value_string(value);
+    xmlNodePtr node = open_elements_.back();
+    // The root element declared its namespaces with xmlNewNs().
+    if (base::StringPiece(name) == "xmlns") {
+      xmlNewNs(node, BAD_CAST value_string.c_str(), nullptr);
+    } else if (base::StringPiece(name) == "xmlns:xsi") {
+      xsi_ns_ = xmlNewNs(node, BAD_CAST value_string.c_str(), BAD_CAST "xsi");
+    } else if (base::StringPiece(name) == "xsi:schemaLocation") {
+      CHECK(xsi_ns_);
+      xmlNewNsProp(node, xsi_ns_, BAD_CAST "schemaLocation",
+                   BAD_CAST value_string.c_str());
+    } else {
+      xmlSetProp(node, BAD_CAST name, BAD_CAST value_string.c_str());
+    }
+  }
+
+  void AddIdAttribute(const char* name, char prefix, uint64_t id) override {
+    AddAttribute(name, base::StrCat({std::string(1, prefix),
+                                     base::NumberToString(id)}));
+  }
+
+  void EndElement() override { open_elements_.pop_back(); }
+
+  // Like the content of xmlNewTextChild().
+  void AddText(base::StringPiece text) override {
+    xmlAddChild(open_elements_.back(),
+                xmlNewDocText(doc_, BAD_CAST std::string(text).c_str()));
+  }
+
+  // Like the content of xmlNewChild(), after xmlEncodeEntitiesReentrant().
+  void AddEncodedText(base::StringPiece text) override {
+    xmlChar* encoded =
+        xmlEncodeEntitiesReentrant(doc_, BAD_CAST std::string(text).c_str());
+    xmlNodePtr content = xmlStringGetNodeList(doc_, encoded);
+    if (content)
+      xmlAddChildList(open_elements_.back(), content);
+    xmlFree(encoded);
+  }
+
+  void AddNumberText(int64_t value) override {
+    AddText(base::NumberToString(value));
+  }
+
+  void AddUnsignedNumberText(uint64_t value) override {
+    AddText(base::NumberToString(value));
+  }
+
+  std::string Finish() override {
+    open_elements_.clear();
+    xmlChar* xml_string;
+    int size;
+    xmlDocDumpMemoryEnc(doc_, &xml_string, &size, "UTF-8");
+    std::string result(reinterpret_cast<const char*>(xml_string), size);
+    xmlFree(xml_string);
+    return result;
+  }
+
+ private:
+  xmlDocPtr doc_;
+  xmlNsPtr xsi_ns_ = nullptr;
+  std::vector<xmlNodePtr> open_elements_;
+};
+
+void AddDataElement(GraphMLWriter* writer,
+                    const char* key,
+                    base::StringPiece value) {
+  writer->StartElement("data");
+  writer->AddAttribute("key", key);
+  writer->AddEncodedText(value);
+  writer->EndElement();
+}
+
+// Writes a graph laid out like PageGraph::WriteGraphML() does, with the kinds
+// of values graph items write.
+void WriteSampleGraph(GraphMLWriter* writer,
+                      const std::string& frame_id,
+                      const std::vector<std::string>& values) {
+  writer->StartElement("graphml");
+  writer->AddAttribute("xmlns", "http://graphml.graphdrawing.org/xmlns");
+  writer->AddAttribute("xmlns:xsi",
+                       "http://www.w3.org/2001/XMLSchema-instance");
+  writer->AddAttribute(
+      "xsi:schemaLocation",
+      "http://graphml.graphdrawing.org/xmlns "
+      "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
+
+  writer->StartElement("desc");
+  writer->AddTextElement("version", "0.2.4");
+  writer->AddTextElement("about", "https://github.com/brave/brave-browser");
+  writer->AddTextElement("is_root", "true");
+  writer->AddTextElement("frame_id", frame_id);
+  writer->StartElement("time");
+  writer->AddTextElement("start", "0");
+  writer->AddTextElement("end", "1234");
+  writer->EndElement();  // time
+  writer->EndElement();  // desc
+
+  const char* const kKeys[][4] = {{"d1", "node", "node type", "string"},
+                                  {"d2", "edge", "edge type", "string"},
+                                  {"d3", "node", "script id", "int"},
+                                  {"d4", "edge", "is style", "boolean"}};
+  for (const auto& key : kKeys) {
+    writer->StartElement("key");
+    writer->AddAttribute("id", key[0]);
+    writer->AddAttribute("for", key[1]);
+    writer->AddAttribute("attr.name", key[2]);
+    writer->AddAttribute("attr.type", key[3]);
+    writer->EndElement();
+  }
+
+  writer->StartElement("graph");
+  writer->AddAttribute("id", "G");
+  writer->AddAttribute("edgedefault", "directed");
+  for (size_t i = 0; i < values.size(); ++i) {
+    writer->StartElement("node");
+    writer->AddIdAttribute("id", 'n', i);
+    AddDataElement(writer, "d1", values[i]);
+    writer->StartElement("data");
+    writer->AddAttribute("key", "d3");
+    writer->AddNumberText(-static_cast<int64_t>(i));
+    writer->EndElement();
+    writer->EndElement();  // node
+  }
+  for (size_t i = 0; i + 1 < values.size(); ++i) {
+    writer->StartElement("edge");
+    writer->AddIdAttribute("id", 'e', i);
+    writer->AddIdAttribute("source", 'n', i);
+    writer->AddIdAttribute("target", 'n', i + 1);
+    AddDataElement(writer, "d2", values[values.size() - i - 1]);
+    writer->StartElement("data");
+    writer->AddAttribute("key", "d2");
+    writer->AddUnsignedNumberText(std::numeric_limits<uint64_t>::max() - i);
+    writer->EndElement();
+    writer->StartElement("data");
+    writer->AddAttribute("key", "d4");
+    writer->AddText(i % 2 ? "true" : "false");
+    writer->EndElement();
+    writer->EndElement();  // edge
+  }
+}
+
+std::string WriteWithLibxml(const std::string& frame_id,
+                            const std::vector<std::string>& values) {
+  LibxmlGraphMLWriter writer;
+  WriteSampleGraph(&writer, frame_id, values);
+  return writer.Finish();
+}
+
+std::string WriteWithTextWriter(const std::string& frame_id,
+                                const std::vector<std::string>& values) {
+  GraphMLTextWriter writer;
+  WriteSampleGraph(&writer, frame_id, values);
+  return writer.Finish();
+}
+
+}  // namespace
+
+TEST(GraphMLWriterTest, SampleGraphMatchesLibxml) {
+  const std::vector<std::string> values = {
+      "HTML element",
+      "https://example.com/?a=1&b=2",
+      "<div class=\"content\">",
+      "quotes \" and '",
+      ""};
+  const std::string output = WriteWithTextWriter("frame", values);
+  EXPECT_EQ(WriteWithLibxml("frame", values), output);
+  EXPECT_NE(std::string::npos,
+            output.find("<edge id=\"e0\" source=\"n0\" target=\"n1\">"));
+}
+
+TEST(GraphMLWriterTest, EscapingMatchesLibxml) {
+  const std::vector<std::string> values = {
+      "<script>a && b</script>",
+      "tab\tnewline\ncarriage\rreturn",
+      "control\x01\x1f chars",
+      std::string("before\0after", 12),
+      "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80",
+      "\x7f"};
+  EXPECT_EQ(WriteWithLibxml("frame & <id>\r\n", values),
+            WriteWithTextWriter("frame & <id>\r\n", values));
+  EXPECT_EQ(WriteWithLibxml("", {}), WriteWithTextWriter("", {}));
+}
+
+}  // namespace brave_page_graph
@@ -0,0 +1,51 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <cstdio>
+#include <string>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "brave/components/brave_page_graph/common/binary_graph.h"
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
+
+int main(int argc, char* argv[]) {
+  base::CommandLine::Init(argc, argv);
+  const base::CommandLine::StringVector& args =
+      base::CommandLine::ForCurrentProcess()->GetArgs();
+  if (args.empty() || args.size() > 2) {
+    fprintf(stderr, "Usage: %s <input.pgb> [<output.graphml>]\n", argv[0]);
+    return 1;
+  }
+
+  const base::FilePath input_path(args[0]);
+  std::string input;
+  if (!base::ReadFileToString(input_path, &input)) {
+    fprintf(stderr, "Failed to read %s\n", input_path.AsUTF8Unsafe().c_str());
+    return 1;
+  }
+
+  brave_page_graph::GraphMLTextWriter writer(input.size() * 4);
+  if (!brave_page_graph::ReplayBinaryGraph(input, &writer)) {
+    fprintf(stderr, "%s is not a valid page graph recording\n",
+            input_path.AsUTF8Unsafe().c_str());
+    return 1;
+  }
+  const std::string graphml = writer.Finish();
+
+  if (args.size() == 1) {
+    fwrite(graphml.data(), 1, graphml.size(), stdout);
+    return 0;
+  }
+
+  const base::FilePath output_path(args[1]);
+  if (!base::WriteFile(output_path, graphml)) {
+    fprintf(stderr, "Failed to write %s\n",
+            output_path.AsUTF8Unsafe().c_str());
+    return 1;
+  }
+  return 0;
+}
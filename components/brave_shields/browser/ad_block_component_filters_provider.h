@@ -50,7 +50,7 @@ class AdBlockComponentFiltersProvider : public AdBlockFiltersProvider {
 
   void LoadDATBuffer(
       base::OnceCallback<void(bool deserialize,
-                              const DATFileDataBuffer& dat_buf)>) override;
+                              DATFileDataBuffer dat_buf)>) override;
 
   // Remove the component. This will force it to be redownloaded next time it
   // is registered.
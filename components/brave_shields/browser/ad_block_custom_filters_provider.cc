@@ -45,10 +45,13 @@ bool AdBlockCustomFiltersProvider::UpdateCustomFilters(
 }
 
 void AdBlockCustomFiltersProvider::LoadDATBuffer(
-    base::OnceCallback<void(bool deserialize, const DATFileDataBuffer& dat_buf)>
-        cb) {
+    base::OnceCallback<void(bool deserialize, DATFileDataBuffer dat_buf)> cb) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   auto custom_filters = GetCustomFilters();
+  // Custom filters have an engine of their own, and an empty buffer would
+  // leave the previous filters in it.
+  if (custom_filters.empty())
+    custom_filters = "\n";
 
   auto buffer =
       std::vector<unsigned char>(custom_filters.begin(), custom_filters.end());
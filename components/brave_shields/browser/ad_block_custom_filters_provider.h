@@ -32,7 +32,7 @@ class AdBlockCustomFiltersProvider : public AdBlockFiltersProvider {
 
   void LoadDATBuffer(
       base::OnceCallback<void(bool deserialize,
-                              const DATFileDataBuffer& dat_buf)>) override;
+                              DATFileDataBuffer dat_buf)>) override;
 
   // AdBlockFiltersProvider
   void AddObserver(AdBlockFiltersProvider::Observer* observer);
@@ -12,14 +12,29 @@
 
 #include "base/bind.h"
 #include "base/containers/contains.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/json/json_reader.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/ranges/algorithm.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/components/brave_shields/common/class_id_filter.h"
+#include "crypto/sha2.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/origin.h"
@@ -94,6 +109,46 @@ std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
   return filter_option;
 }
 
+// Bump when the engine serialization changes without the list text changing,
+// e.g. when adblock-rust is updated.
+constexpr char kCompiledEngineCacheVersion[] = "1";
+constexpr base::FilePath::CharType kCompiledEngineExtension[] =
+    FILE_PATH_LITERAL(".dat");
+
+std::string GetListHash(const DATFileDataBuffer& filters) {
+  const std::string hash = crypto::SHA256HashString(base::StrCat(
+      {kCompiledEngineCacheVersion, "\n",
+       base::StringPiece(reinterpret_cast<const char*>(filters.data()),
+                         filters.size())}));
+  return base::ToLowerASCII(base::HexEncode(hash.data(), hash.size()));
+}
+
+base::FilePath GetCompiledEnginePath(const base::FilePath& cache_dir,
+                                     const std::string& list_hash) {
+  return cache_dir.AppendASCII(list_hash).AddExtension(
+      kCompiledEngineExtension);
+}
+
+// Engines of several lists share |cache_dir|, so only the engine this one
+// replaces is removed. Older versions of a list are unlikely to come back.
+void WriteCompiledEngine(const base::FilePath& cache_dir,
+                         const base::FilePath& path,
+                         const base::FilePath& replaced_path,
+                         std::vector<uint8_t> serialized) {
+  if (!base::CreateDirectory(cache_dir))
+    return;
+
+  if (!base::ImportantFileWriter::WriteFileAtomically(
+          path, base::StringPiece(reinterpret_cast<const char*>(
+                                      serialized.data()),
+                                  serialized.size()))) {
+    return;
+  }
+
+  if (!replaced_path.empty() && replaced_path != path)
+    base::DeleteFile(replaced_path);
+}
+
 }  // namespace
 
 namespace brave_shields {
@@ -210,11 +265,54 @@ void AdBlockEngine::Load(bool deserialize,
   }
 }
 
+const absl::optional<ClassIdFilter>& AdBlockEngine::class_id_filter() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return class_id_filter_;
+}
+
+int AdBlockEngine::update_count() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return update_count_;
+}
+
+void AdBlockEngine::EnableCompiledEngineCache(
+    const base::FilePath& cache_dir) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  compiled_engine_cache_dir_ = cache_dir;
+  cache_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+      {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+}
+
+const std::string& AdBlockEngine::list_hash() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return list_hash_;
+}
+
+// static
+void AdBlockEngine::DeleteUnusedCompiledEngines(
+    const base::FilePath& cache_dir,
+    const base::flat_set<std::string>& list_hashes) {
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    // Other files, e.g. those being written, are left alone.
+    if (path.Extension() != kCompiledEngineExtension)
+      continue;
+    const std::string list_hash =
+        path.BaseName().RemoveExtension().AsUTF8Unsafe();
+    if (!list_hashes.contains(list_hash))
+      base::DeleteFile(path);
+  }
+}
+
 void AdBlockEngine::UpdateAdBlockClient(
     std::unique_ptr<adblock::Engine> ad_block_client,
     const std::string& resources_json) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   ad_block_client_ = std::move(ad_block_client);
+  update_count_++;
   UseResources(resources_json);
   AddKnownTagsToAdBlockInstance();
   if (test_observer_) {
@@ -232,9 +330,87 @@ void AdBlockEngine::AddKnownTagsToAdBlockInstance() {
 
 void AdBlockEngine::OnListSourceLoaded(const DATFileDataBuffer& filters,
                                        const std::string& resources_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::string list_hash;
+  if (!compiled_engine_cache_dir_.empty()) {
+    list_hash = GetListHash(filters);
+    if (list_hash == list_hash_) {
+      // Nothing changed in the lists, only pick up the new resources.
+      UseResources(resources_json);
+      return;
+    }
+  }
+
+  class_id_filter_ = ClassIdFilter();
+  AddGenericClassIdKeysTo(
+      base::StringPiece(reinterpret_cast<const char*>(filters.data()),
+                        filters.size()),
+      &*class_id_filter_);
+
+  if (!list_hash.empty() && LoadCompiledEngine(list_hash, resources_json))
+    return;
+
+  const base::ElapsedTimer timer;
   auto engine = std::make_unique<adblock::Engine>(
       reinterpret_cast<const char*>(filters.data()), filters.size());
   UpdateAdBlockClient(std::move(engine), resources_json);
+
+  if (!list_hash.empty()) {
+    base::UmaHistogramMediumTimes("Brave.Adblock.EngineCompileTime",
+                                  timer.Elapsed());
+    const std::string replaced_list_hash = std::move(list_hash_);
+    list_hash_ = list_hash;
+    StoreCompiledEngine(list_hash, replaced_list_hash);
+  }
+}
+
+bool AdBlockEngine::LoadCompiledEngine(const std::string& list_hash,
+                                       const std::string& resources_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const base::ElapsedTimer timer;
+  // Deserialize straight from a mapping of the file, the engine keeps its own
+  // copy of everything it needs.
+  base::MemoryMappedFile serialized;
+  if (!serialized.Initialize(
+          GetCompiledEnginePath(compiled_engine_cache_dir_, list_hash)) ||
+      !serialized.length()) {
+    return false;
+  }
+
+  auto client = std::make_unique<adblock::Engine>();
+  if (!client->deserialize(reinterpret_cast<const char*>(serialized.data()),
+                           serialized.length())) {
+    return false;
+  }
+
+  list_hash_ = list_hash;
+  UpdateAdBlockClient(std::move(client), resources_json);
+  base::UmaHistogramMediumTimes("Brave.Adblock.CompiledEngineLoadTime",
+                                timer.Elapsed());
+  return true;
+}
+
+void AdBlockEngine::StoreCompiledEngine(
+    const std::string& list_hash,
+    const std::string& replaced_list_hash) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Serialization has to happen here as the engine isn't thread safe, writing
+  // to disk doesn't.
+  std::vector<uint8_t> serialized = ad_block_client_->serialize();
+  if (serialized.empty())
+    return;
+
+  base::FilePath replaced_path;
+  if (!replaced_list_hash.empty()) {
+    replaced_path =
+        GetCompiledEnginePath(compiled_engine_cache_dir_, replaced_list_hash);
+  }
+  cache_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&WriteCompiledEngine, compiled_engine_cache_dir_,
+                     GetCompiledEnginePath(compiled_engine_cache_dir_,
+                                           list_hash),
+                     replaced_path, std::move(serialized)));
 }
 
 void AdBlockEngine::OnDATLoaded(const DATFileDataBuffer& dat_buf,
@@ -248,6 +424,9 @@ void AdBlockEngine::OnDATLoaded(const DATFileDataBuffer& dat_buf,
   client->deserialize(reinterpret_cast<const char*>(&dat_buf.front()),
                       dat_buf.size());
 
+  list_hash_.clear();
+  // The rules of a serialized engine aren't known.
+  class_id_filter_ = absl::nullopt;
   UpdateAdBlockClient(std::move(client), resources_json);
 }
 
@@ -14,12 +14,17 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/flat_set.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list_types.h"
 #include "base/sequence_checker.h"
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/common/class_id_filter.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #include "url/gurl.h"
 
@@ -29,6 +34,10 @@ namespace adblock {
 class Engine;
 }  // namespace adblock
 
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
+
 class AdBlockServiceTest;
 class BraveAdBlockTPNetworkDelegateHelperTest;
 class EphemeralStorage1pDomainBlockBrowserTest;
@@ -39,9 +48,6 @@ namespace brave_shields {
 // Service managing an adblock engine.
 class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
  public:
-  using GetDATFileDataResult =
-      brave_component_updater::LoadDATFileDataResult<adblock::Engine>;
-
   AdBlockEngine();
   AdBlockEngine(const AdBlockEngine&) = delete;
   AdBlockEngine& operator=(const AdBlockEngine&) = delete;
@@ -74,6 +80,26 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
             const DATFileDataBuffer& dat_buf,
             const std::string& resources_json);
 
+  // Class and id names the generic hide rules of the engine are keyed on, or
+  // nullopt until the engine is built from a filter list.
+  const absl::optional<ClassIdFilter>& class_id_filter() const;
+  // Incremented whenever the engine is replaced.
+  int update_count() const;
+
+  // Keeps the engine compiled from a filter list in |cache_dir|, keyed by a
+  // hash of the list. Later loads of the same list deserialize that engine
+  // instead of compiling the list again.
+  void EnableCompiledEngineCache(const base::FilePath& cache_dir);
+  // Hash the current engine is stored under in the compiled engine cache, or
+  // empty if it isn't.
+  const std::string& list_hash() const;
+
+  // Deletes the files in |cache_dir| other than the engines stored under
+  // |list_hashes|. Blocks on disk.
+  static void DeleteUnusedCompiledEngines(
+      const base::FilePath& cache_dir,
+      const base::flat_set<std::string>& list_hashes);
+
   class TestObserver : public base::CheckedObserver {
    public:
     virtual void OnEngineUpdated() = 0;
@@ -92,6 +118,14 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   void OnDATLoaded(const DATFileDataBuffer& dat_buf,
                    const std::string& resources_json);
 
+  // Returns false if the compiled engine cache doesn't have |list_hash|.
+  bool LoadCompiledEngine(const std::string& list_hash,
+                          const std::string& resources_json);
+  // Stores the current engine under |list_hash| and drops the engine stored
+  // under |replaced_list_hash|, if any.
+  void StoreCompiledEngine(const std::string& list_hash,
+                           const std::string& replaced_list_hash);
+
   std::unique_ptr<adblock::Engine> ad_block_client_
       GUARDED_BY_CONTEXT(sequence_checker_);
 
@@ -103,6 +137,17 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
 
   std::set<std::string> tags_ GUARDED_BY_CONTEXT(sequence_checker_);
 
+  base::FilePath compiled_engine_cache_dir_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+  scoped_refptr<base::SequencedTaskRunner> cache_task_runner_;
+  // Hash of the filter list the current engine was built from, if it was
+  // built from a list and the compiled engine cache is enabled.
+  std::string list_hash_ GUARDED_BY_CONTEXT(sequence_checker_);
+
+  absl::optional<ClassIdFilter> class_id_filter_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+  int update_count_ GUARDED_BY_CONTEXT(sequence_checker_) = 0;
+
   raw_ptr<TestObserver> test_observer_ = nullptr;
 
   SEQUENCE_CHECKER(sequence_checker_);
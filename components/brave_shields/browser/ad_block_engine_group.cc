@@ -0,0 +1,333 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_engine_group.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/containers/contains.h"
+#include "base/containers/flat_set.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
+#include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
+
+namespace brave_shields {
+
+namespace {
+
+// Network rule options which turn off rules of other lists.
+constexpr base::StringPiece kCrossListOptions[] = {
+    "badfilter", "generichide",  "ghide", "elemhide",
+    "ehide",     "specifichide", "shide"};
+
+bool IsCrossListRule(base::StringPiece rule) {
+  if (rule.find("#@") != base::StringPiece::npos)
+    return true;
+  // Other cosmetic rules have no options, but may contain a '$'.
+  if (rule.find("##") != base::StringPiece::npos ||
+      rule.find("#$#") != base::StringPiece::npos ||
+      rule.find("#?#") != base::StringPiece::npos) {
+    return false;
+  }
+  const size_t options_start = rule.rfind('$');
+  if (options_start == base::StringPiece::npos)
+    return false;
+  for (base::StringPiece option : base::SplitStringPiece(
+           rule.substr(options_start + 1), ",", base::TRIM_WHITESPACE,
+           base::SPLIT_WANT_NONEMPTY)) {
+    if (base::Contains(kCrossListOptions, option))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+std::string GetCrossListRules(base::StringPiece list) {
+  std::vector<base::StringPiece> rules;
+  for (base::StringPiece rule :
+       base::SplitStringPiece(list, "\r\n", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    if (base::StartsWith(rule, "!") || base::StartsWith(rule, "["))
+      continue;
+    if (IsCrossListRule(rule))
+      rules.push_back(rule);
+  }
+  base::ranges::sort(rules);
+  rules.erase(base::ranges::unique(rules), rules.end());
+  return base::JoinString(rules, "\n");
+}
+
+AdBlockEngineGroup::ListState::ListState() = default;
+AdBlockEngineGroup::ListState::ListState(ListState&&) = default;
+AdBlockEngineGroup::ListState& AdBlockEngineGroup::ListState::operator=(
+    ListState&&) = default;
+AdBlockEngineGroup::ListState::~ListState() = default;
+
+AdBlockEngineGroup::AdBlockEngineGroup() {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+AdBlockEngineGroup::~AdBlockEngineGroup() = default;
+
+void AdBlockEngineGroup::AddEngine(std::unique_ptr<AdBlockEngine> engine,
+                                   base::RepeatingClosure reload_list) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(engine);
+  if (reload_list) {
+    if (!compiled_engine_cache_dir_.empty())
+      engine->EnableCompiledEngineCache(compiled_engine_cache_dir_);
+    ListState state;
+    state.reload_list = std::move(reload_list);
+    lists_.emplace(engine.get(), std::move(state));
+  }
+  engines_.push_back(std::move(engine));
+  engines_change_count_++;
+}
+
+void AdBlockEngineGroup::RemoveEngine(const AdBlockEngine* engine) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = base::ranges::find(engines_, engine,
+                               &std::unique_ptr<AdBlockEngine>::get);
+  if (it != engines_.end()) {
+    // Keeps update_count() growing once the engine's own count is gone.
+    engines_change_count_ += (*it)->update_count() + 1;
+    engines_.erase(it);
+  }
+
+  auto list_it = lists_.find(engine);
+  if (list_it != lists_.end()) {
+    if (!list_it->second.cross_list_rules.empty())
+      cross_list_rules_changed_ = true;
+    lists_.erase(list_it);
+    // The removed engine may have been the last one without a list.
+    MaybeBuildPendingLists();
+  }
+}
+
+void AdBlockEngineGroup::EnableCompiledEngineCache(
+    const base::FilePath& cache_dir) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(lists_.empty());
+  compiled_engine_cache_dir_ = cache_dir;
+}
+
+size_t AdBlockEngineGroup::size() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return engines_.size();
+}
+
+void AdBlockEngineGroup::LoadList(const AdBlockEngine* engine,
+                                  bool deserialize,
+                                  DATFileDataBuffer list,
+                                  const std::string& resources_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = lists_.find(engine);
+  if (it == lists_.end())
+    return;
+
+  ListState& state = it->second;
+  state.has_received_list = true;
+  auto engine_it = base::ranges::find(engines_, engine,
+                                      &std::unique_ptr<AdBlockEngine>::get);
+  DCHECK(engine_it != engines_.end());
+  if (deserialize) {
+    // A serialized engine can't take the rules of other lists, nor have its
+    // rules read.
+    if (!state.cross_list_rules.empty()) {
+      state.cross_list_rules.clear();
+      cross_list_rules_changed_ = true;
+    }
+    state.has_list = false;
+    state.pending_list.reset();
+    (*engine_it)->Load(deserialize, list, resources_json);
+    MaybeBuildPendingLists();
+    return;
+  }
+  if (list.empty() && !state.pending_list) {
+    // Only the resources changed, or the list is not available.
+    (*engine_it)->UseResources(resources_json);
+    MaybeBuildPendingLists();
+    return;
+  }
+
+  if (!list.empty()) {
+    std::string cross_list_rules = GetCrossListRules(base::StringPiece(
+        reinterpret_cast<const char*>(list.data()), list.size()));
+    if (cross_list_rules != state.cross_list_rules) {
+      state.cross_list_rules = std::move(cross_list_rules);
+      cross_list_rules_changed_ = true;
+    }
+    state.pending_list = std::move(list);
+  }
+  state.pending_resources_json = resources_json;
+  MaybeBuildPendingLists();
+}
+
+void AdBlockEngineGroup::MaybeBuildPendingLists() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  for (const auto& [engine, state] : lists_) {
+    if (!state.has_received_list)
+      return;
+  }
+
+  const bool cross_list_rules_changed = cross_list_rules_changed_;
+  cross_list_rules_changed_ = false;
+  for (auto& engine : engines_) {
+    auto it = lists_.find(engine.get());
+    if (it == lists_.end())
+      continue;
+
+    ListState& state = it->second;
+    if (!state.pending_list) {
+      // Built with the previous rules of the other lists.
+      if (cross_list_rules_changed && state.has_list)
+        state.reload_list.Run();
+      continue;
+    }
+
+    DATFileDataBuffer list = std::move(*state.pending_list);
+    state.pending_list.reset();
+    state.has_list = true;
+    const std::string other_rules = GetCrossListRulesOfOtherLists(engine.get());
+    if (!other_rules.empty()) {
+      list.push_back('\n');
+      list.insert(list.end(), other_rules.begin(), other_rules.end());
+    }
+    engine->Load(/*deserialize=*/false, list, state.pending_resources_json);
+  }
+
+  if (compiled_engine_cache_dir_.empty() ||
+      has_deleted_unused_compiled_engines_) {
+    return;
+  }
+  has_deleted_unused_compiled_engines_ = true;
+  base::flat_set<std::string> list_hashes;
+  for (const auto& engine : engines_) {
+    if (!engine->list_hash().empty())
+      list_hashes.insert(engine->list_hash());
+  }
+  base::ThreadPool::PostTask(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&AdBlockEngine::DeleteUnusedCompiledEngines,
+                     compiled_engine_cache_dir_, std::move(list_hashes)));
+}
+
+std::string AdBlockEngineGroup::GetCrossListRulesOfOtherLists(
+    const AdBlockEngine* engine) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Sorted so that the list, and so its compiled engine cache, does not depend
+  // on the order of the engines.
+  std::vector<base::StringPiece> rules;
+  for (const auto& [other_engine, state] : lists_) {
+    if (other_engine != engine && !state.cross_list_rules.empty())
+      rules.push_back(state.cross_list_rules);
+  }
+  base::ranges::sort(rules);
+  return base::JoinString(rules, "\n");
+}
+
+void AdBlockEngineGroup::ShouldStartRequest(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host,
+    bool aggressive_blocking,
+    bool* did_match_rule,
+    bool* did_match_exception,
+    bool* did_match_important,
+    std::string* mock_data_url,
+    std::string* rewritten_url) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  for (auto& engine : engines_) {
+    if (did_match_important && *did_match_important)
+      return;
+
+    const GURL request_url =
+        rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
+    engine->ShouldStartRequest(request_url, resource_type, tab_host,
+                               aggressive_blocking, did_match_rule,
+                               did_match_exception, did_match_important,
+                               mock_data_url, rewritten_url);
+  }
+}
+
+absl::optional<std::string> AdBlockEngineGroup::GetCspDirectives(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  absl::optional<std::string> csp_directives;
+  for (auto& engine : engines_) {
+    MergeCspDirectiveInto(
+        engine->GetCspDirectives(url, resource_type, tab_host),
+        &csp_directives);
+  }
+  return csp_directives;
+}
+
+absl::optional<base::Value::Dict> AdBlockEngineGroup::UrlCosmeticResources(
+    const std::string& url) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  absl::optional<base::Value::Dict> resources;
+  for (auto& engine : engines_) {
+    absl::optional<base::Value> engine_resources =
+        engine->UrlCosmeticResources(url);
+    if (!engine_resources || !engine_resources->is_dict())
+      continue;
+
+    if (!resources) {
+      resources = std::move(engine_resources->GetDict());
+    } else {
+      MergeResourcesInto(std::move(engine_resources->GetDict()), &*resources,
+                         /*force_hide=*/false);
+    }
+  }
+  return resources;
+}
+
+base::Value::List AdBlockEngineGroup::HiddenClassIdSelectors(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  base::Value::List selectors;
+  for (auto& engine : engines_) {
+    for (auto& selector :
+         engine->HiddenClassIdSelectors(classes, ids, exceptions)) {
+      selectors.Append(std::move(selector));
+    }
+  }
+  return selectors;
+}
+
+absl::optional<ClassIdFilter> AdBlockEngineGroup::GetClassIdFilter() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ClassIdFilter filter;
+  for (auto& engine : engines_) {
+    const auto& engine_filter = engine->class_id_filter();
+    if (!engine_filter)
+      return absl::nullopt;
+    filter.Merge(*engine_filter);
+  }
+  return filter;
+}
+
+int AdBlockEngineGroup::update_count() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Each count only grows, so the sum changes with any of them.
+  int count = engines_change_count_;
+  for (auto& engine : engines_)
+    count += engine->update_count();
+  return count;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,142 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_ENGINE_GROUP_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_ENGINE_GROUP_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/flat_map.h"
+#include "base/files/file_path.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/strings/string_piece.h"
+#include "base/values.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/common/class_id_filter.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+class AdBlockEngine;
+
+// Returns the rules of |list| which apply to rules of other lists as well:
+// cosmetic exceptions and the $badfilter, $generichide, $elemhide and
+// $specifichide options. Sorted and deduplicated, one rule per line.
+std::string GetCrossListRules(base::StringPiece list);
+
+// Engines of the additional filter lists, queried in the order they were
+// added and merged as if they were a single engine. Each engine is loaded and
+// replaced on its own, so updating one list leaves the others untouched.
+//
+// adblock-rust only applies exceptions to rules of the same engine, so each
+// list is compiled along with the cross-list rules (see GetCrossListRules())
+// of all the other lists. When those change, the other lists are reloaded.
+//
+// Like AdBlockEngine, this lives on the adblock task runner.
+class AdBlockEngineGroup : public base::SupportsWeakPtr<AdBlockEngineGroup> {
+ public:
+  AdBlockEngineGroup();
+  AdBlockEngineGroup(const AdBlockEngineGroup&) = delete;
+  AdBlockEngineGroup& operator=(const AdBlockEngineGroup&) = delete;
+  ~AdBlockEngineGroup();
+
+  // Engines added with |reload_list| are built by LoadList(). |reload_list|
+  // is run when the engine has to be built again, and should lead to another
+  // LoadList() call with the engine's list.
+  void AddEngine(std::unique_ptr<AdBlockEngine> engine,
+                 base::RepeatingClosure reload_list = {});
+  void RemoveEngine(const AdBlockEngine* engine);
+  size_t size() const;
+
+  // Keeps the engines built by LoadList() in the compiled engine cache in
+  // |cache_dir| (see AdBlockEngine::EnableCompiledEngineCache()). Once they
+  // are all built for the first time, the other engines in |cache_dir| are
+  // deleted, e.g. those of removed lists or of an older adblock-rust.
+  void EnableCompiledEngineCache(const base::FilePath& cache_dir);
+
+  // Builds |engine| from |list| and the cross-list rules of the other lists.
+  // An empty |list| only updates the resources, and serialized engines are
+  // loaded as they are. Lists are held back until every engine has received
+  // one, so that each list is only compiled once at startup.
+  void LoadList(const AdBlockEngine* engine,
+                bool deserialize,
+                brave_component_updater::DATFileDataBuffer list,
+                const std::string& resources_json);
+
+  // Same as AdBlockEngine::ShouldStartRequest. The results of earlier engines
+  // are passed on to later ones, so an exception in any list applies to rules
+  // from all of them.
+  void ShouldStartRequest(const GURL& url,
+                          blink::mojom::ResourceType resource_type,
+                          const std::string& tab_host,
+                          bool aggressive_blocking,
+                          bool* did_match_rule,
+                          bool* did_match_exception,
+                          bool* did_match_important,
+                          std::string* mock_data_url,
+                          std::string* rewritten_url);
+  absl::optional<std::string> GetCspDirectives(
+      const GURL& url,
+      blink::mojom::ResourceType resource_type,
+      const std::string& tab_host);
+  absl::optional<base::Value::Dict> UrlCosmeticResources(
+      const std::string& url);
+  base::Value::List HiddenClassIdSelectors(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      const std::vector<std::string>& exceptions);
+
+  // Merged AdBlockEngine::class_id_filter() of all engines, nullopt if any of
+  // them is unknown.
+  absl::optional<ClassIdFilter> GetClassIdFilter();
+  // Changes whenever an engine is added, removed or updated.
+  int update_count();
+
+ private:
+  // State of an engine which is built by LoadList().
+  struct ListState {
+    ListState();
+    ListState(ListState&&);
+    ListState& operator=(ListState&&);
+    ~ListState();
+
+    base::RepeatingClosure reload_list;
+    bool has_received_list = false;
+    // The engine was built from a non-empty list.
+    bool has_list = false;
+    std::string cross_list_rules;
+    // A list that is waiting for the other engines' lists.
+    absl::optional<brave_component_updater::DATFileDataBuffer> pending_list;
+    std::string pending_resources_json;
+  };
+
+  // Builds the pending lists once every engine received a list, and reloads
+  // the other lists if the cross-list rules changed.
+  void MaybeBuildPendingLists();
+  std::string GetCrossListRulesOfOtherLists(const AdBlockEngine* engine);
+
+  std::vector<std::unique_ptr<AdBlockEngine>> engines_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+  base::flat_map<const AdBlockEngine*, ListState> lists_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+  bool cross_list_rules_changed_ GUARDED_BY_CONTEXT(sequence_checker_) = false;
+  base::FilePath compiled_engine_cache_dir_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+  bool has_deleted_unused_compiled_engines_
+      GUARDED_BY_CONTEXT(sequence_checker_) = false;
+  int engines_change_count_ GUARDED_BY_CONTEXT(sequence_checker_) = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_ENGINE_GROUP_H_
@@ -0,0 +1,221 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_engine_group.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/common/adblock_domain_resolver.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+std::unique_ptr<AdBlockEngine> CreateEngine(const std::string& rules) {
+  auto engine = std::make_unique<AdBlockEngine>();
+  engine->Load(false, DATFileDataBuffer(rules.begin(), rules.end()), "[]");
+  return engine;
+}
+
+// Adds an engine which is built by AdBlockEngineGroup::LoadList().
+const AdBlockEngine* AddListEngine(AdBlockEngineGroup* group,
+                                   int* reload_count) {
+  auto engine = std::make_unique<AdBlockEngine>();
+  const AdBlockEngine* engine_ptr = engine.get();
+  group->AddEngine(std::move(engine), base::BindLambdaForTesting(
+                                          [reload_count] { ++*reload_count; }));
+  return engine_ptr;
+}
+
+void LoadList(AdBlockEngineGroup* group,
+              const AdBlockEngine* engine,
+              const std::string& rules) {
+  group->LoadList(engine, /*deserialize=*/false,
+                  DATFileDataBuffer(rules.begin(), rules.end()), "[]");
+}
+
+bool IsScriptBlocked(AdBlockEngineGroup* group, const GURL& url) {
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+  std::string rewritten_url;
+  group->ShouldStartRequest(url, blink::mojom::ResourceType::kScript,
+                            "brave.com", false, &did_match_rule,
+                            &did_match_exception, &did_match_important,
+                            &mock_data_url, &rewritten_url);
+  return did_match_rule && !did_match_exception;
+}
+
+}  // namespace
+
+class AdBlockEngineGroupTest : public testing::Test {
+ public:
+  void SetUp() override {
+    adblock::SetDomainResolver(AdBlockServiceDomainResolver);
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  AdBlockEngineGroup group_;
+};
+
+TEST_F(AdBlockEngineGroupTest, ResultsAreMergedAcrossEngines) {
+  const GURL ad_url("https://example.com/ad.js");
+  const GURL tracker_url("https://example.org/tracker.js");
+  EXPECT_FALSE(IsScriptBlocked(&group_, ad_url));
+
+  group_.AddEngine(CreateEngine("||example.com^\n||example.org^\n"));
+  EXPECT_TRUE(IsScriptBlocked(&group_, ad_url));
+  EXPECT_TRUE(IsScriptBlocked(&group_, tracker_url));
+
+  // An exception from a later list applies to rules from earlier ones.
+  auto exceptions = CreateEngine("@@||example.com/ad.js\n");
+  const AdBlockEngine* exceptions_engine = exceptions.get();
+  group_.AddEngine(std::move(exceptions));
+  EXPECT_EQ(2u, group_.size());
+  EXPECT_FALSE(IsScriptBlocked(&group_, ad_url));
+  EXPECT_TRUE(IsScriptBlocked(&group_, tracker_url));
+
+  group_.RemoveEngine(exceptions_engine);
+  EXPECT_EQ(1u, group_.size());
+  EXPECT_TRUE(IsScriptBlocked(&group_, ad_url));
+}
+
+TEST_F(AdBlockEngineGroupTest, ImportantRulesStopLaterEngines) {
+  const GURL ad_url("https://example.com/ad.js");
+  group_.AddEngine(CreateEngine("||example.com^$important\n"));
+  group_.AddEngine(CreateEngine("@@||example.com/ad.js\n"));
+  EXPECT_TRUE(IsScriptBlocked(&group_, ad_url));
+}
+
+TEST_F(AdBlockEngineGroupTest, HiddenClassIdSelectorsOfAllEngines) {
+  group_.AddEngine(CreateEngine("##.ad\n"));
+  group_.AddEngine(CreateEngine("###banner\n"));
+  base::Value::List selectors =
+      group_.HiddenClassIdSelectors({"ad"}, {"banner"}, {});
+  EXPECT_EQ(2u, selectors.size());
+}
+
+TEST_F(AdBlockEngineGroupTest, GetCrossListRules) {
+  EXPECT_EQ(
+      "@@||example.com^$generichide\n"
+      "example.com#@#.ad\n"
+      "||ads.example.com^$script,badfilter",
+      GetCrossListRules("! Title: Test\n"
+                        "[Adblock Plus 2.0]\n"
+                        "##.ad\n"
+                        "example.com#@#.ad\n"
+                        "||ads.example.com^$script,badfilter\n"
+                        "@@||example.com^$generichide\r\n"
+                        "example.com#@#.ad\n"
+                        "||example.com/$script\n"
+                        "example.org##a[href$=\"badfilter\"]\n"));
+  EXPECT_EQ("", GetCrossListRules(""));
+}
+
+TEST_F(AdBlockEngineGroupTest, ExceptionsApplyAcrossLists) {
+  int ads_reload_count = 0;
+  int exceptions_reload_count = 0;
+  const AdBlockEngine* ads = AddListEngine(&group_, &ads_reload_count);
+  const AdBlockEngine* exceptions =
+      AddListEngine(&group_, &exceptions_reload_count);
+
+  const GURL ad_url("https://ads.example.com/ad.js");
+  const GURL tracker_url("https://tracker.example.org/tracker.js");
+  LoadList(&group_, ads,
+           "example.com##.banner-ad\n"
+           "##div[data-ad]\n"
+           "||ads.example.com^\n"
+           "||tracker.example.org^\n");
+  // Lists are only built once all of them are in.
+  EXPECT_FALSE(IsScriptBlocked(&group_, tracker_url));
+
+  LoadList(&group_, exceptions,
+           "example.com#@#.banner-ad\n"
+           "||ads.example.com^$badfilter\n"
+           "@@||example.com^$generichide\n");
+  EXPECT_TRUE(IsScriptBlocked(&group_, tracker_url));
+  EXPECT_FALSE(IsScriptBlocked(&group_, ad_url));
+
+  absl::optional<base::Value::Dict> resources =
+      group_.UrlCosmeticResources("https://example.com/");
+  ASSERT_TRUE(resources);
+  EXPECT_EQ(absl::optional<bool>(true), resources->FindBool("generichide"));
+  const base::Value::List* hide_selectors =
+      resources->FindList("hide_selectors");
+  ASSERT_TRUE(hide_selectors);
+  EXPECT_FALSE(base::Contains(*hide_selectors, base::Value(".banner-ad")));
+  EXPECT_FALSE(base::Contains(*hide_selectors, base::Value("div[data-ad]")));
+  EXPECT_EQ(0, ads_reload_count);
+  EXPECT_EQ(0, exceptions_reload_count);
+
+  // Dropping the $badfilter rule reloads the other list, which then blocks the
+  // request again.
+  LoadList(&group_, exceptions, "example.com#@#.banner-ad\n");
+  EXPECT_EQ(1, ads_reload_count);
+  EXPECT_EQ(0, exceptions_reload_count);
+  EXPECT_FALSE(IsScriptBlocked(&group_, ad_url));
+  LoadList(&group_, ads,
+           "example.com##.banner-ad\n"
+           "##div[data-ad]\n"
+           "||ads.example.com^\n"
+           "||tracker.example.org^\n");
+  EXPECT_TRUE(IsScriptBlocked(&group_, ad_url));
+  EXPECT_EQ(0, exceptions_reload_count);
+
+  // So does removing the list.
+  group_.RemoveEngine(exceptions);
+  EXPECT_EQ(2, ads_reload_count);
+}
+
+TEST_F(AdBlockEngineGroupTest, DeletesUnusedCompiledEngines) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath stale_engine =
+      temp_dir.GetPath().AppendASCII("0123456789abcdef.dat");
+  const base::FilePath other_file = temp_dir.GetPath().AppendASCII("other");
+  ASSERT_TRUE(base::WriteFile(stale_engine, "stale"));
+  ASSERT_TRUE(base::WriteFile(other_file, "other"));
+
+  AdBlockEngineGroup group;
+  group.EnableCompiledEngineCache(temp_dir.GetPath());
+  int reload_count = 0;
+  const AdBlockEngine* first = AddListEngine(&group, &reload_count);
+  const AdBlockEngine* second = AddListEngine(&group, &reload_count);
+  LoadList(&group, first, "||example.com^\n");
+  task_environment_.RunUntilIdle();
+  // Nothing is deleted until every list is built.
+  EXPECT_TRUE(base::PathExists(stale_engine));
+
+  LoadList(&group, second, "||example.org^\n");
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(stale_engine));
+  EXPECT_TRUE(base::PathExists(other_file));
+
+  int engine_count = 0;
+  base::FileEnumerator enumerator(temp_dir.GetPath(), false,
+                                  base::FileEnumerator::FILES,
+                                  FILE_PATH_LITERAL("*.dat"));
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    engine_count++;
+  }
+  EXPECT_EQ(2, engine_count);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,106 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_engine.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/task_environment.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_shields/common/adblock_domain_resolver.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kCompileTimeHistogram[] = "Brave.Adblock.EngineCompileTime";
+constexpr char kCachedLoadTimeHistogram[] =
+    "Brave.Adblock.CompiledEngineLoadTime";
+
+DATFileDataBuffer ToBuffer(const std::string& rules) {
+  return DATFileDataBuffer(rules.begin(), rules.end());
+}
+
+bool IsScriptBlocked(AdBlockEngine* engine, const GURL& url) {
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+  std::string rewritten_url;
+  engine->ShouldStartRequest(url, blink::mojom::ResourceType::kScript,
+                             "brave.com", false, &did_match_rule,
+                             &did_match_exception, &did_match_important,
+                             &mock_data_url, &rewritten_url);
+  return did_match_rule && !did_match_exception;
+}
+
+}  // namespace
+
+class AdBlockEngineTest : public testing::Test {
+ public:
+  void SetUp() override {
+    adblock::SetDomainResolver(AdBlockServiceDomainResolver);
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+ protected:
+  base::FilePath cache_dir() const {
+    return temp_dir_.GetPath().AppendASCII("cache");
+  }
+
+  std::unique_ptr<AdBlockEngine> CreateEngine() {
+    auto engine = std::make_unique<AdBlockEngine>();
+    engine->EnableCompiledEngineCache(cache_dir());
+    return engine;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(AdBlockEngineTest, CompiledEngineIsCachedByListContents) {
+  const auto filters = ToBuffer("||example.com/ad.js\n");
+  const GURL ad_url("https://example.com/ad.js");
+  base::HistogramTester histogram_tester;
+
+  // First load compiles the list and stores the result.
+  auto engine = CreateEngine();
+  engine->Load(false, filters, "[]");
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(IsScriptBlocked(engine.get(), ad_url));
+  histogram_tester.ExpectTotalCount(kCompileTimeHistogram, 1);
+  EXPECT_FALSE(base::IsDirectoryEmpty(cache_dir()));
+
+  // Loading the same list again is a no-op.
+  engine->Load(false, filters, "[]");
+  histogram_tester.ExpectTotalCount(kCompileTimeHistogram, 1);
+  histogram_tester.ExpectTotalCount(kCachedLoadTimeHistogram, 0);
+
+  // A new engine, e.g. after a restart, deserializes the stored engine.
+  engine = CreateEngine();
+  engine->Load(false, filters, "[]");
+  EXPECT_TRUE(IsScriptBlocked(engine.get(), ad_url));
+  histogram_tester.ExpectTotalCount(kCompileTimeHistogram, 1);
+  histogram_tester.ExpectTotalCount(kCachedLoadTimeHistogram, 1);
+
+  // Changed lists are compiled again and replace the stored engine.
+  engine->Load(false, ToBuffer("||example.org/ad.js\n"), "[]");
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(IsScriptBlocked(engine.get(), ad_url));
+  EXPECT_TRUE(IsScriptBlocked(engine.get(), GURL("https://example.org/ad.js")));
+  histogram_tester.ExpectTotalCount(kCompileTimeHistogram, 2);
+
+  engine = CreateEngine();
+  engine->Load(false, filters, "[]");
+  histogram_tester.ExpectTotalCount(kCompileTimeHistogram, 3);
+  histogram_tester.ExpectTotalCount(kCachedLoadTimeHistogram, 1);
+}
+
+}  // namespace brave_shields
@@ -32,8 +32,7 @@ void AdBlockFiltersProvider::NotifyObservers() {
 }
 
 void AdBlockFiltersProvider::LoadDAT(
-    base::OnceCallback<void(bool deserialize, const DATFileDataBuffer& dat_buf)>
-        cb) {
+    base::OnceCallback<void(bool deserialize, DATFileDataBuffer dat_buf)> cb) {
   LoadDATBuffer(std::move(cb));
 }
 
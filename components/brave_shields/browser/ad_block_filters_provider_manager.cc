@@ -5,33 +5,12 @@
 
 #include "brave/components/brave_shields/browser/ad_block_filters_provider_manager.h"
 
-#include <memory>
-#include <string>
-#include <utility>
+#include <algorithm>
 
-#include "base/barrier_callback.h"
-#include "base/location.h"
-#include "base/logging.h"
-#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/check.h"
 
 namespace brave_shields {
 
-namespace {
-
-static void OnDATLoaded(
-    base::OnceCallback<void(DATFileDataBuffer)> collect_and_merge,
-    bool deserialize,
-    const DATFileDataBuffer& dat_buf) {
-  // This manager should never be used for a provider that returns a serialized
-  // DAT. The ability should be removed from the FiltersProvider API when
-  // possible.
-  CHECK(!deserialize);
-
-  std::move(collect_and_merge).Run(dat_buf);
-}
-
-}  // namespace
-
 // static
 AdBlockFiltersProviderManager* AdBlockFiltersProviderManager::GetInstance() {
   return base::Singleton<AdBlockFiltersProviderManager>::get();
@@ -47,7 +26,8 @@ void AdBlockFiltersProviderManager::AddProvider(
       std::find(filters_providers_.begin(), filters_providers_.end(), provider);
   CHECK(it == filters_providers_.end());
   filters_providers_.push_back(provider);
-  provider->AddObserver(this);
+  for (auto& observer : observers_)
+    observer.OnProviderAdded(provider);
 }
 
 void AdBlockFiltersProviderManager::RemoveProvider(
@@ -55,51 +35,19 @@ void AdBlockFiltersProviderManager::RemoveProvider(
   auto it =
       std::find(filters_providers_.begin(), filters_providers_.end(), provider);
   CHECK(it != filters_providers_.end());
-  (*it)->RemoveObserver(this);
+  for (auto& observer : observers_)
+    observer.OnProviderRemoved(provider);
   filters_providers_.erase(it);
-  NotifyObservers();
-}
-
-void AdBlockFiltersProviderManager::OnChanged() {
-  NotifyObservers();
 }
 
-void AdBlockFiltersProviderManager::LoadDATBuffer(
-    base::OnceCallback<void(bool deserialize, const DATFileDataBuffer& dat_buf)>
-        cb) {
-  if (task_tracker_.HasTrackedTasks()) {
-    // There's already an in-progress load, cancel it.
-    task_tracker_.TryCancelAll();
-  }
-
-  const auto collect_and_merge = base::BarrierCallback<DATFileDataBuffer>(
-      filters_providers_.size(),
-      base::BindOnce(&AdBlockFiltersProviderManager::FinishCombinating,
-                     weak_factory_.GetWeakPtr(), std::move(cb)));
-  for (auto* provider : filters_providers_) {
-    task_tracker_.PostTask(
-        base::SequencedTaskRunnerHandle::Get().get(), FROM_HERE,
-        base::BindOnce(
-            &AdBlockFiltersProvider::LoadDAT, base::Unretained(provider),
-            base::BindOnce(OnDATLoaded, std::move(collect_and_merge))));
-  }
+void AdBlockFiltersProviderManager::AddProvidersObserver(
+    ProvidersObserver* observer) {
+  observers_.AddObserver(observer);
 }
 
-void AdBlockFiltersProviderManager::FinishCombinating(
-    base::OnceCallback<void(bool, const DATFileDataBuffer&)> cb,
-    const std::vector<DATFileDataBuffer>& results) {
-  DATFileDataBuffer combined_list;
-  for (const auto& dat_buf : results) {
-    combined_list.push_back('\n');
-    combined_list.insert(combined_list.end(), dat_buf.begin(), dat_buf.end());
-  }
-  if (combined_list.size() == 0) {
-    // Small workaround for code in
-    // AdBlockService::SourceProviderObserver::OnResourcesLoaded that encodes a
-    // state using an entirely empty DAT.
-    combined_list.push_back('\n');
-  }
-  std::move(cb).Run(false, combined_list);
+void AdBlockFiltersProviderManager::RemoveProvidersObserver(
+    ProvidersObserver* observer) {
+  observers_.RemoveObserver(observer);
 }
 
 }  // namespace brave_shields
@@ -6,56 +6,53 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_FILTERS_PROVIDER_MANAGER_H_
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_FILTERS_PROVIDER_MANAGER_H_
 
-#include <string>
 #include <vector>
 
-#include "base/callback.h"
 #include "base/memory/singleton.h"
 #include "base/observer_list.h"
-#include "base/task/cancelable_task_tracker.h"
-#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "base/observer_list_types.h"
 #include "brave/components/brave_shields/browser/ad_block_filters_provider.h"
 
-using brave_component_updater::DATFileDataBuffer;
-
 namespace brave_shields {
 
-// AdBlockFiltersProviderManager is both an AdBlockFiltersProvider and an
-// AdBlockFiltersProvider::Observer. It is used to observe multiple provider
-// sources and combine their filter lists into a single compound filter list.
-class AdBlockFiltersProviderManager : public AdBlockFiltersProvider,
-                                      public AdBlockFiltersProvider::Observer {
+// AdBlockFiltersProviderManager keeps track of the providers of additional
+// filter lists (regional lists, subscriptions and custom filters).
+// AdBlockService observes it to build one engine per provider, so a change to
+// one list only rebuilds that list's engine.
+class AdBlockFiltersProviderManager {
  public:
+  class ProvidersObserver : public base::CheckedObserver {
+   public:
+    virtual void OnProviderAdded(AdBlockFiltersProvider* provider) = 0;
+    // Called before |provider| is removed, it's still valid at this point.
+    virtual void OnProviderRemoved(AdBlockFiltersProvider* provider) = 0;
+  };
+
   AdBlockFiltersProviderManager(const AdBlockFiltersProviderManager&) = delete;
   AdBlockFiltersProviderManager& operator=(
       const AdBlockFiltersProviderManager&) = delete;
 
   static AdBlockFiltersProviderManager* GetInstance();
 
-  void LoadDATBuffer(
-      base::OnceCallback<void(bool deserialize,
-                              const DATFileDataBuffer& dat_buf)>) override;
-
-  // AdBlockFiltersProvider::Observer
-  void OnChanged() override;
-
   void AddProvider(AdBlockFiltersProvider* provider);
   void RemoveProvider(AdBlockFiltersProvider* provider);
 
- private:
-  friend struct base::DefaultSingletonTraits<AdBlockFiltersProviderManager>;
-
-  void FinishCombinating(
-      base::OnceCallback<void(bool, const DATFileDataBuffer&)> cb,
-      const std::vector<DATFileDataBuffer>& results);
-  std::vector<AdBlockFiltersProvider*> filters_providers_;
+  // Providers in the order they were added.
+  const std::vector<AdBlockFiltersProvider*>& providers() const {
+    return filters_providers_;
+  }
 
-  base::CancelableTaskTracker task_tracker_;
+  void AddProvidersObserver(ProvidersObserver* observer);
+  void RemoveProvidersObserver(ProvidersObserver* observer);
 
-  base::WeakPtrFactory<AdBlockFiltersProviderManager> weak_factory_{this};
+ private:
+  friend struct base::DefaultSingletonTraits<AdBlockFiltersProviderManager>;
 
   AdBlockFiltersProviderManager();
-  ~AdBlockFiltersProviderManager() override;
+  ~AdBlockFiltersProviderManager();
+
+  std::vector<AdBlockFiltersProvider*> filters_providers_;
+  base::ObserverList<ProvidersObserver> observers_;
 };
 
 }  // namespace brave_shields
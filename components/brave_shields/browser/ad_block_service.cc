@@ -18,11 +18,14 @@
 #include "base/memory/ptr_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/bind_post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
 #include "brave/components/brave_shields/browser/ad_block_component_filters_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_default_resource_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/browser/ad_block_engine_group.h"
 #include "brave/components/brave_shields/browser/ad_block_filter_list_catalog_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
@@ -51,6 +54,10 @@ const char kAdBlockComponentBase64PublicKey[] =
     "q+SDNXROG554RnU4BnDJaNETTkDTZ0Pn+rmLmp1qY5Si0yGsfHkrv3FS3vdxVozO"
     "PQIDAQAB";
 
+// Compiled engines of the regional, subscription and custom filter lists.
+const base::FilePath::CharType kAdditionalFiltersEngineCacheDir[] =
+    FILE_PATH_LITERAL("AdBlockEngineCache");
+
 std::string g_ad_block_component_id_(kAdBlockComponentId);
 std::string g_ad_block_component_base64_public_key_(
     kAdBlockComponentBase64PublicKey);
@@ -63,11 +70,13 @@ AdBlockService::SourceProviderObserver::SourceProviderObserver(
     AdBlockEngine* adblock_engine,
     AdBlockFiltersProvider* filters_provider,
     AdBlockResourceProvider* resource_provider,
-    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    AdBlockEngineGroup* engine_group)
     : adblock_engine_(adblock_engine),
       filters_provider_(filters_provider),
       resource_provider_(resource_provider),
-      task_runner_(task_runner) {
+      task_runner_(task_runner),
+      engine_group_(engine_group) {
   filters_provider_->AddObserver(this);
   filters_provider_->LoadDAT(
       base::BindOnce(&AdBlockService::SourceProviderObserver::OnDATLoaded,
@@ -87,7 +96,7 @@ void AdBlockService::SourceProviderObserver::OnChanged() {
 
 void AdBlockService::SourceProviderObserver::OnDATLoaded(
     bool deserialize,
-    const DATFileDataBuffer& dat_buf) {
+    DATFileDataBuffer dat_buf) {
   deserialize_ = deserialize;
   dat_buf_ = std::move(dat_buf);
   // multiple AddObserver calls are ignored
@@ -98,6 +107,17 @@ void AdBlockService::SourceProviderObserver::OnDATLoaded(
 
 void AdBlockService::SourceProviderObserver::OnResourcesLoaded(
     const std::string& resources_json) {
+  if (engine_group_) {
+    // The engine is owned by the group, which ignores it once removed.
+    task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&AdBlockEngineGroup::LoadList,
+                       engine_group_->AsWeakPtr(),
+                       base::Unretained(adblock_engine_.get()), deserialize_,
+                       std::move(dat_buf_), resources_json));
+    return;
+  }
+
   if (dat_buf_.empty()) {
     task_runner_->PostTask(
         FROM_HERE,
@@ -148,10 +168,8 @@ void AdBlockService::ShouldStartRequest(
     }
   }
 
-  request_url =
-      rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
-  additional_filters_engine_->ShouldStartRequest(
-      request_url, resource_type, tab_host, aggressive_blocking, did_match_rule,
+  additional_filters_engines_->ShouldStartRequest(
+      url, resource_type, tab_host, aggressive_blocking, did_match_rule,
       did_match_exception, did_match_important, mock_data_url, rewritten_url);
 }
 
@@ -163,7 +181,7 @@ absl::optional<std::string> AdBlockService::GetCspDirectives(
   auto csp_directives =
       default_engine_->GetCspDirectives(url, resource_type, tab_host);
 
-  const auto additional_csp = additional_filters_engine_->GetCspDirectives(
+  const auto additional_csp = additional_filters_engines_->GetCspDirectives(
       url, resource_type, tab_host);
   MergeCspDirectiveInto(additional_csp, &csp_directives);
 
@@ -180,11 +198,11 @@ absl::optional<base::Value> AdBlockService::UrlCosmeticResources(
     return resources;
   }
 
-  absl::optional<base::Value> additional_resources =
-      additional_filters_engine_->UrlCosmeticResources(url);
+  absl::optional<base::Value::Dict> additional_resources =
+      additional_filters_engines_->UrlCosmeticResources(url);
 
-  if (additional_resources && additional_resources->is_dict()) {
-    MergeResourcesInto(std::move(additional_resources->GetDict()),
+  if (additional_resources) {
+    MergeResourcesInto(std::move(*additional_resources),
                        resources->GetIfDict(),
                        /*force_hide=*/true);
   }
@@ -210,8 +228,8 @@ base::Value::Dict AdBlockService::HiddenClassIdSelectors(
       default_engine_->HiddenClassIdSelectors(classes, ids, exceptions);
 
   base::Value::List additional_selectors =
-      additional_filters_engine_->HiddenClassIdSelectors(classes, ids,
-                                                         exceptions);
+      additional_filters_engines_->HiddenClassIdSelectors(classes, ids,
+                                                          exceptions);
 
   base::Value::List force_hide_selectors = std::move(additional_selectors);
 
@@ -221,6 +239,25 @@ base::Value::Dict AdBlockService::HiddenClassIdSelectors(
   return result;
 }
 
+const ClassIdFilter* AdBlockService::GetClassIdFilter(int* version) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  DCHECK(version);
+  const int update_count = default_engine_->update_count() +
+                           additional_filters_engines_->update_count();
+  if (update_count != class_id_filter_version_) {
+    class_id_filter_version_ = update_count;
+    class_id_filter_ = additional_filters_engines_->GetClassIdFilter();
+    const auto& default_filter = default_engine_->class_id_filter();
+    if (class_id_filter_ && default_filter)
+      class_id_filter_->Merge(*default_filter);
+    else
+      class_id_filter_ = absl::nullopt;
+  }
+
+  *version = class_id_filter_version_;
+  return class_id_filter_ ? &*class_id_filter_ : nullptr;
+}
+
 AdBlockRegionalServiceManager* AdBlockService::regional_service_manager() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   return regional_service_manager_.get();
@@ -255,13 +292,20 @@ AdBlockService::AdBlockService(
       default_engine_(std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter>(
           new AdBlockEngine(),
           base::OnTaskRunnerDeleter(GetTaskRunner()))),
-      additional_filters_engine_(
-          std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter>(
-              new AdBlockEngine(),
+      additional_filters_engines_(
+          std::unique_ptr<AdBlockEngineGroup, base::OnTaskRunnerDeleter>(
+              new AdBlockEngineGroup(),
               base::OnTaskRunnerDeleter(GetTaskRunner()))) {
   // Initializes adblock-rust's domain resolution implementation
   adblock::SetDomainResolver(AdBlockServiceDomainResolver);
 
+  // The default engine is loaded from a serialized DAT already.
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&AdBlockEngineGroup::EnableCompiledEngineCache,
+                     additional_filters_engines_->AsWeakPtr(),
+                     profile_dir_.Append(kAdditionalFiltersEngineCacheDir)));
+
   resource_provider_ = std::make_unique<AdBlockDefaultResourceProvider>(
       component_update_service_);
   filter_list_catalog_provider_ =
@@ -284,14 +328,85 @@ AdBlockService::AdBlockService(
   default_service_observer_ = std::make_unique<SourceProviderObserver>(
       default_engine_.get(), default_filters_provider_.get(),
       resource_provider_.get(), GetTaskRunner());
-  additional_filters_service_observer_ =
-      std::make_unique<SourceProviderObserver>(
-          additional_filters_engine_.get(),
-          AdBlockFiltersProviderManager::GetInstance(),
-          resource_provider_.get(), GetTaskRunner());
+
+  auto* providers_manager = AdBlockFiltersProviderManager::GetInstance();
+  for (auto* provider : providers_manager->providers())
+    AddAdditionalFiltersSource(provider);
+  providers_manager->AddProvidersObserver(this);
+}
+
+AdBlockService::~AdBlockService() {
+  AdBlockFiltersProviderManager::GetInstance()->RemoveProvidersObserver(this);
 }
 
-AdBlockService::~AdBlockService() = default;
+AdBlockService::AdditionalFiltersSource::AdditionalFiltersSource() = default;
+AdBlockService::AdditionalFiltersSource::AdditionalFiltersSource(
+    AdditionalFiltersSource&&) = default;
+AdBlockService::AdditionalFiltersSource&
+AdBlockService::AdditionalFiltersSource::operator=(AdditionalFiltersSource&&) =
+    default;
+AdBlockService::AdditionalFiltersSource::~AdditionalFiltersSource() = default;
+
+void AdBlockService::OnProviderAdded(AdBlockFiltersProvider* provider) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  AddAdditionalFiltersSource(provider);
+}
+
+void AdBlockService::OnProviderRemoved(AdBlockFiltersProvider* provider) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  RemoveAdditionalFiltersSource(provider);
+}
+
+void AdBlockService::AddAdditionalFiltersSource(
+    AdBlockFiltersProvider* provider) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(!additional_filters_sources_.contains(provider));
+
+  auto engine = std::make_unique<AdBlockEngine>();
+  AdditionalFiltersSource source;
+  source.engine = engine.get();
+  // The engine is owned by the group from here on, and is only removed from it
+  // after |source.observer| stops posting tasks to it.
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          &AdBlockEngineGroup::AddEngine,
+          additional_filters_engines_->AsWeakPtr(), std::move(engine),
+          base::BindPostTask(
+              base::SequencedTaskRunnerHandle::Get(),
+              base::BindRepeating(
+                  &AdBlockService::ReloadAdditionalFiltersSource,
+                  weak_factory_.GetWeakPtr(), base::Unretained(provider)))));
+  source.observer = std::make_unique<SourceProviderObserver>(
+      source.engine, provider, resource_provider_.get(), GetTaskRunner(),
+      additional_filters_engines_.get());
+
+  additional_filters_sources_.emplace(provider, std::move(source));
+}
+
+void AdBlockService::RemoveAdditionalFiltersSource(
+    AdBlockFiltersProvider* provider) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = additional_filters_sources_.find(provider);
+  if (it == additional_filters_sources_.end())
+    return;
+
+  const AdBlockEngine* engine = it->second.engine;
+  additional_filters_sources_.erase(it);
+  GetTaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&AdBlockEngineGroup::RemoveEngine,
+                                additional_filters_engines_->AsWeakPtr(),
+                                base::Unretained(engine)));
+}
+
+void AdBlockService::ReloadAdditionalFiltersSource(
+    AdBlockFiltersProvider* provider) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // |provider| is only compared, as it may have been removed since.
+  auto it = additional_filters_sources_.find(provider);
+  if (it != additional_filters_sources_.end())
+    it->second.observer->OnChanged();
+}
 
 void AdBlockService::EnableTag(const std::string& tag, bool enabled) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -332,10 +447,40 @@ void AdBlockService::UseCustomSourceProvidersForTest(
     AdBlockFiltersProvider* source_provider,
     AdBlockResourceProvider* resource_provider) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  additional_filters_service_observer_ =
-      std::make_unique<SourceProviderObserver>(
-          additional_filters_engine_.get(), source_provider, resource_provider,
-          GetTaskRunner());
+  for (auto& it : additional_filters_sources_) {
+    GetTaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(&AdBlockEngineGroup::RemoveEngine,
+                                  additional_filters_engines_->AsWeakPtr(),
+                                  base::Unretained(it.second.engine.get())));
+  }
+  additional_filters_sources_.clear();
+
+  auto engine = std::make_unique<AdBlockEngine>();
+  AdditionalFiltersSource source;
+  source.engine = engine.get();
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          &AdBlockEngineGroup::AddEngine,
+          additional_filters_engines_->AsWeakPtr(), std::move(engine),
+          base::BindPostTask(
+              base::SequencedTaskRunnerHandle::Get(),
+              base::BindRepeating(
+                  &AdBlockService::ReloadAdditionalFiltersSource,
+                  weak_factory_.GetWeakPtr(),
+                  base::Unretained(source_provider)))));
+  source.observer = std::make_unique<SourceProviderObserver>(
+      source.engine, source_provider, resource_provider, GetTaskRunner(),
+      additional_filters_engines_.get());
+  additional_filters_sources_.emplace(source_provider, std::move(source));
+}
+
+AdBlockEngine* AdBlockService::GetAdditionalFiltersEngineForTest(
+    AdBlockFiltersProvider* provider) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = additional_filters_sources_.find(provider);
+  return it == additional_filters_sources_.end() ? nullptr
+                                                 : it->second.engine.get();
 }
 
 void AdBlockService::TagExistsForTest(const std::string& tag,
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/files/file_path.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -22,6 +23,7 @@
 #include "brave/components/brave_shields/browser/ad_block_filters_provider_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_resource_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_download_manager.h"
+#include "brave/components/brave_shields/common/class_id_filter.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "content/public/browser/browser_thread.h"
@@ -39,6 +41,7 @@ class ComponentUpdateService;
 namespace brave_shields {
 
 class AdBlockEngine;
+class AdBlockEngineGroup;
 class AdBlockComponentFiltersProvider;
 class AdBlockDefaultResourceProvider;
 class AdBlockRegionalServiceManager;
@@ -47,26 +50,29 @@ class AdBlockFilterListCatalogProvider;
 class AdBlockSubscriptionServiceManager;
 
 // The brave shields service in charge of ad-block checking and init.
-class AdBlockService {
+class AdBlockService : public AdBlockFiltersProviderManager::ProvidersObserver {
  public:
   class SourceProviderObserver : public AdBlockResourceProvider::Observer,
                                  public AdBlockFiltersProvider::Observer {
    public:
+    // |engine_group| is set when |adblock_engine| belongs to it, in which case
+    // the group builds the engine.
     SourceProviderObserver(
         AdBlockEngine* adblock_engine,
         AdBlockFiltersProvider* source_provider,
         AdBlockResourceProvider* resource_provider,
-        scoped_refptr<base::SequencedTaskRunner> task_runner);
+        scoped_refptr<base::SequencedTaskRunner> task_runner,
+        AdBlockEngineGroup* engine_group = nullptr);
     SourceProviderObserver(const SourceProviderObserver&) = delete;
     SourceProviderObserver& operator=(const SourceProviderObserver&) = delete;
     ~SourceProviderObserver() override;
 
-   private:
-    void OnDATLoaded(bool deserialize, const DATFileDataBuffer& dat_buf);
-
     // AdBlockFiltersProvider::Observer
     void OnChanged() override;
 
+   private:
+    void OnDATLoaded(bool deserialize, DATFileDataBuffer dat_buf);
+
     // AdBlockResourceProvider::Observer
     void OnResourcesLoaded(const std::string& resources_json) override;
 
@@ -76,6 +82,7 @@ class AdBlockService {
     raw_ptr<AdBlockFiltersProvider> filters_provider_;    // not owned
     raw_ptr<AdBlockResourceProvider> resource_provider_;  // not owned
     scoped_refptr<base::SequencedTaskRunner> task_runner_;
+    raw_ptr<AdBlockEngineGroup> engine_group_;  // not owned
 
     base::WeakPtrFactory<SourceProviderObserver> weak_factory_{this};
   };
@@ -89,7 +96,7 @@ class AdBlockService {
       const base::FilePath& profile_dir);
   AdBlockService(const AdBlockService&) = delete;
   AdBlockService& operator=(const AdBlockService&) = delete;
-  ~AdBlockService();
+  ~AdBlockService() override;
 
   void ShouldStartRequest(const GURL& url,
                           blink::mojom::ResourceType resource_type,
@@ -109,6 +116,10 @@ class AdBlockService {
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
+  // Returns a filter of the class and id names that HiddenClassIdSelectors can
+  // return selectors for, and sets |version| to a value that changes along
+  // with it. Returns nullptr if some engine's rules aren't known.
+  const ClassIdFilter* GetClassIdFilter(int* version);
 
   AdBlockRegionalServiceManager* regional_service_manager();
   AdBlockSubscriptionServiceManager* subscription_service_manager();
@@ -124,9 +135,35 @@ class AdBlockService {
       AdBlockFiltersProvider* source_provider,
       AdBlockResourceProvider* resource_provider);
 
+  // Returns the engine built from |provider|'s filters, or nullptr. The engine
+  // must only be used on the adblock task runner.
+  AdBlockEngine* GetAdditionalFiltersEngineForTest(
+      AdBlockFiltersProvider* provider);
+
  private:
   friend class ::AdBlockServiceTest;
 
+  // An additional filter list and the engine it's compiled into.
+  struct AdditionalFiltersSource {
+    AdditionalFiltersSource();
+    AdditionalFiltersSource(AdditionalFiltersSource&&);
+    AdditionalFiltersSource& operator=(AdditionalFiltersSource&&);
+    ~AdditionalFiltersSource();
+
+    raw_ptr<AdBlockEngine> engine = nullptr;  // owned by the engine group
+    std::unique_ptr<SourceProviderObserver> observer;
+  };
+
+  // AdBlockFiltersProviderManager::ProvidersObserver
+  void OnProviderAdded(AdBlockFiltersProvider* provider) override;
+  void OnProviderRemoved(AdBlockFiltersProvider* provider) override;
+
+  void AddAdditionalFiltersSource(AdBlockFiltersProvider* provider);
+  void RemoveAdditionalFiltersSource(AdBlockFiltersProvider* provider);
+  // Loads the list of |provider| again, after the rules it shares with the
+  // other lists changed.
+  void ReloadAdditionalFiltersSource(AdBlockFiltersProvider* provider);
+
   static std::string g_ad_block_dat_file_version_;
 
   AdBlockResourceProvider* resource_provider();
@@ -163,13 +200,19 @@ class AdBlockService {
       GUARDED_BY_CONTEXT(sequence_checker_);
 
   std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter> default_engine_;
-  std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter>
-      additional_filters_engine_;
+  // One engine per additional filter list, so that updating a list only
+  // recompiles that list.
+  std::unique_ptr<AdBlockEngineGroup, base::OnTaskRunnerDeleter>
+      additional_filters_engines_;
+
+  // Only used on the adblock task runner.
+  absl::optional<ClassIdFilter> class_id_filter_;
+  int class_id_filter_version_ = -1;
 
   std::unique_ptr<SourceProviderObserver> default_service_observer_
       GUARDED_BY_CONTEXT(sequence_checker_);
-  std::unique_ptr<SourceProviderObserver> additional_filters_service_observer_
-      GUARDED_BY_CONTEXT(sequence_checker_);
+  base::flat_map<AdBlockFiltersProvider*, AdditionalFiltersSource>
+      additional_filters_sources_ GUARDED_BY_CONTEXT(sequence_checker_);
 
   SEQUENCE_CHECKER(sequence_checker_);
 
@@ -8,7 +8,61 @@
 #include <utility>
 
 #include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "base/values.h"
+#include "brave/components/brave_shields/common/class_id_filter.h"
+
+namespace {
+
+bool IsKeyChar(char c) {
+  return base::IsAsciiAlphaNumeric(c) || c == '_' || c == '-';
+}
+
+// Returns the class or id name a generic selector is keyed on, i.e. its
+// leading `[#.][\w-]+` with CSS escapes resolved. Names are cut at the first
+// non-ASCII character, ClassIdFilter lets non-ASCII names through anyway.
+std::string GetSelectorKey(base::StringPiece selector) {
+  std::string key;
+  size_t i = 1;
+  while (i < selector.size()) {
+    const char c = selector[i];
+    if (IsKeyChar(c)) {
+      key.push_back(c);
+      i++;
+      continue;
+    }
+    if (c != '\\' || i + 1 == selector.size())
+      break;
+
+    // Hex escapes are only recognized with a trailing space, everything else
+    // escapes the next character.
+    size_t hex_end = i + 1;
+    while (hex_end < selector.size() && base::IsHexDigit(selector[hex_end]))
+      hex_end++;
+    if (hex_end > i + 1 && hex_end < selector.size() &&
+        selector[hex_end] == ' ') {
+      uint32_t code_point = 0;
+      if (!base::HexStringToUInt(selector.substr(i + 1, hex_end - i - 1),
+                                 &code_point) ||
+          code_point > 0x7f ||
+          !base::IsAsciiPrintable(static_cast<char>(code_point))) {
+        break;
+      }
+      key.push_back(static_cast<char>(code_point));
+      i = hex_end + 1;
+    } else {
+      if (!base::IsAsciiPrintable(selector[i + 1]))
+        break;
+      key.push_back(selector[i + 1]);
+      i += 2;
+    }
+  }
+  return key;
+}
+
+}  // namespace
 
 namespace brave_shields {
 
@@ -103,4 +157,28 @@ void MergeResourcesInto(base::Value::Dict from,
   }
 }
 
+// Rules with domain constraints are keyed too. They only make the filter
+// report a few more names as possibly present.
+void AddGenericClassIdKeysTo(base::StringPiece filters, ClassIdFilter* filter) {
+  DCHECK(filter);
+  for (base::StringPiece line : base::SplitStringPiece(
+           filters, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    const size_t separator = line.find("##");
+    if (separator == base::StringPiece::npos)
+      continue;
+
+    const base::StringPiece selector = line.substr(separator + 2);
+    if (selector.empty() || (selector[0] != '.' && selector[0] != '#'))
+      continue;
+
+    const std::string key = GetSelectorKey(selector);
+    if (key.empty())
+      continue;
+    if (selector[0] == '.')
+      filter->AddClass(key);
+    else
+      filter->AddId(key);
+  }
+}
+
 }  // namespace brave_shields
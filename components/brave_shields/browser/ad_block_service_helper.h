@@ -11,11 +11,14 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
 #include "base/values.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace brave_shields {
 
+class ClassIdFilter;
+
 void MergeCspDirectiveInto(absl::optional<std::string> from,
                            absl::optional<std::string>* into);
 
@@ -23,6 +26,10 @@ void MergeResourcesInto(base::Value::Dict from,
                         base::Value::Dict* into,
                         bool force_hide);
 
+// Adds the class and id names that generic cosmetic rules in the filter list
+// |filters| are keyed on by adblock-rust's HiddenClassIdSelectors.
+void AddGenericClassIdKeysTo(base::StringPiece filters, ClassIdFilter* filter);
+
 }  // namespace brave_shields
 
 #endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SERVICE_HELPER_H_
@@ -28,8 +28,7 @@ AdBlockSubscriptionFiltersProvider::~AdBlockSubscriptionFiltersProvider() =
     default;
 
 void AdBlockSubscriptionFiltersProvider::LoadDATBuffer(
-    base::OnceCallback<void(bool deserialize, const DATFileDataBuffer& dat_buf)>
-        cb) {
+    base::OnceCallback<void(bool deserialize, DATFileDataBuffer dat_buf)> cb) {
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE, {base::MayBlock()},
       base::BindOnce(&brave_component_updater::ReadDATFileData, list_file_),
@@ -38,13 +37,12 @@ void AdBlockSubscriptionFiltersProvider::LoadDATBuffer(
 }
 
 void AdBlockSubscriptionFiltersProvider::OnDATFileDataReady(
-    base::OnceCallback<void(bool deserialize, const DATFileDataBuffer& dat_buf)>
-        cb,
-    const DATFileDataBuffer& dat_buf) {
+    base::OnceCallback<void(bool deserialize, DATFileDataBuffer dat_buf)> cb,
+    DATFileDataBuffer dat_buf) {
   adblock::FilterListMetadata metadata = adblock::FilterListMetadata(
       reinterpret_cast<const char*>(dat_buf.data()), dat_buf.size());
   on_metadata_retrieved_.Run(metadata);
-  std::move(cb).Run(false, dat_buf);
+  std::move(cb).Run(false, std::move(dat_buf));
 }
 
 void AdBlockSubscriptionFiltersProvider::OnListAvailable() {
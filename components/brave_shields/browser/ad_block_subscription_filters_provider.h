@@ -36,12 +36,12 @@ class AdBlockSubscriptionFiltersProvider : public AdBlockFiltersProvider {
 
   void LoadDATBuffer(
       base::OnceCallback<void(bool deserialize,
-                              const DATFileDataBuffer& dat_buf)>) override;
+                              DATFileDataBuffer dat_buf)>) override;
 
   void OnDATFileDataReady(
       base::OnceCallback<void(bool deserialize,
-                              const DATFileDataBuffer& dat_buf)> cb,
-      const DATFileDataBuffer& dat_buf);
+                              DATFileDataBuffer dat_buf)> cb,
+      DATFileDataBuffer dat_buf);
 
   void OnListAvailable();
 
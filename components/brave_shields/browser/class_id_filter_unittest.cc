@@ -0,0 +1,68 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/common/class_id_filter.h"
+
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+TEST(ClassIdFilterTest, KeysGenericRules) {
+  ClassIdFilter filter;
+  AddGenericClassIdKeysTo(
+      "! comment\n"
+      "##.ad-banner\n"
+      "###sponsored\n"
+      "##.promo > .inner\n"
+      "example.com##.site-specific\n"
+      "##.esc\\:aped\n"
+      "##.\\31 23\n"
+      "##div.not-keyed\n"
+      "#@#.unhidden\n"
+      "||example.com^\n",
+      &filter);
+
+  EXPECT_TRUE(filter.MayContainClass("ad-banner"));
+  EXPECT_TRUE(filter.MayContainId("sponsored"));
+  EXPECT_TRUE(filter.MayContainClass("promo"));
+  EXPECT_TRUE(filter.MayContainClass("site-specific"));
+  EXPECT_TRUE(filter.MayContainClass("esc:aped"));
+  EXPECT_TRUE(filter.MayContainClass("123"));
+
+  EXPECT_FALSE(filter.MayContainClass("sponsored"));
+  EXPECT_FALSE(filter.MayContainId("ad-banner"));
+  EXPECT_FALSE(filter.MayContainClass("inner"));
+  EXPECT_FALSE(filter.MayContainClass("not-keyed"));
+  EXPECT_FALSE(filter.MayContainClass("unhidden"));
+
+  // Non-ASCII names can't be ruled out.
+  EXPECT_TRUE(filter.MayContainClass("r\xC3\xA9klam"));
+}
+
+TEST(ClassIdFilterTest, MergeAndSerialize) {
+  ClassIdFilter empty;
+  EXPECT_TRUE(empty.bytes().empty());
+  EXPECT_FALSE(empty.MayContainClass("ad"));
+
+  ClassIdFilter a;
+  a.AddClass("ad");
+  ClassIdFilter b;
+  b.AddId("banner");
+  a.Merge(b);
+  a.Merge(empty);
+  EXPECT_TRUE(a.MayContainClass("ad"));
+  EXPECT_TRUE(a.MayContainId("banner"));
+
+  auto copy = ClassIdFilter::FromBytes(a.bytes());
+  ASSERT_TRUE(copy);
+  EXPECT_TRUE(copy->MayContainClass("ad"));
+  EXPECT_TRUE(copy->MayContainId("banner"));
+  EXPECT_FALSE(copy->MayContainId("ad"));
+
+  EXPECT_FALSE(ClassIdFilter::FromBytes({1, 2, 3}));
+}
+
+}  // namespace brave_shields
@@ -29,7 +29,7 @@ class TestFiltersProvider : public AdBlockFiltersProvider,
 
   void LoadDATBuffer(
       base::OnceCallback<void(bool deserialize,
-                              const DATFileDataBuffer& dat_buf)> cb) override;
+                              DATFileDataBuffer dat_buf)> cb) override;
 
   void LoadResources(
       base::OnceCallback<void(const std::string& resources_json)> cb) override;
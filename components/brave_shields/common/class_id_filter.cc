@@ -0,0 +1,92 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/common/class_id_filter.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/strings/string_util.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr size_t kNumBits = ClassIdFilter::kSizeInBytes * 8;
+constexpr int kNumHashes = 5;
+
+// FNV-1a, the filter is built in the browser and queried in renderers so the
+// hash has to be stable across processes.
+uint64_t Hash(char prefix, base::StringPiece name) {
+  constexpr uint64_t kPrime = 0x100000001b3;
+  uint64_t hash = 0xcbf29ce484222325;
+  hash = (hash ^ static_cast<uint8_t>(prefix)) * kPrime;
+  for (char c : name)
+    hash = (hash ^ static_cast<uint8_t>(c)) * kPrime;
+  return hash;
+}
+
+// Double hashing, see Kirsch and Mitzenmacher, "Less Hashing, Same
+// Performance: Building a Better Bloom Filter".
+template <typename Fn>
+void ForEachBit(char prefix, base::StringPiece name, Fn fn) {
+  const uint64_t hash = Hash(prefix, name);
+  const uint32_t h1 = static_cast<uint32_t>(hash);
+  const uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (int i = 0; i < kNumHashes; ++i)
+    fn((h1 + i * h2) % kNumBits);
+}
+
+}  // namespace
+
+ClassIdFilter::ClassIdFilter() = default;
+ClassIdFilter::ClassIdFilter(const ClassIdFilter&) = default;
+ClassIdFilter& ClassIdFilter::operator=(const ClassIdFilter&) = default;
+ClassIdFilter::ClassIdFilter(ClassIdFilter&&) = default;
+ClassIdFilter& ClassIdFilter::operator=(ClassIdFilter&&) = default;
+ClassIdFilter::~ClassIdFilter() = default;
+
+// static
+absl::optional<ClassIdFilter> ClassIdFilter::FromBytes(
+    std::vector<uint8_t> bytes) {
+  if (!bytes.empty() && bytes.size() != kSizeInBytes)
+    return absl::nullopt;
+  ClassIdFilter filter;
+  filter.bits_ = std::move(bytes);
+  return filter;
+}
+
+void ClassIdFilter::Merge(const ClassIdFilter& other) {
+  if (other.bits_.empty())
+    return;
+  if (bits_.empty()) {
+    bits_ = other.bits_;
+    return;
+  }
+  DCHECK_EQ(bits_.size(), other.bits_.size());
+  for (size_t i = 0; i < bits_.size(); ++i)
+    bits_[i] |= other.bits_[i];
+}
+
+void ClassIdFilter::Add(char prefix, base::StringPiece name) {
+  if (bits_.empty())
+    bits_.resize(kSizeInBytes);
+  ForEachBit(prefix, name,
+             [this](size_t bit) { bits_[bit / 8] |= 1 << (bit % 8); });
+}
+
+bool ClassIdFilter::MayContain(char prefix, base::StringPiece name) const {
+  if (!base::IsStringASCII(name))
+    return true;
+  if (bits_.empty())
+    return false;
+  bool may_contain = true;
+  ForEachBit(prefix, name, [this, &may_contain](size_t bit) {
+    may_contain &= (bits_[bit / 8] & (1 << (bit % 8))) != 0;
+  });
+  return may_contain;
+}
+
+}  // namespace brave_shields
@@ -58,6 +58,11 @@ namespace {
 // The favicon size we desire. The favicons are rendered at 24x24 pixels but
 // they look quite a bit nicer if we get a 48x48 pixel icon and downscale it.
 constexpr uint32_t kDesiredFaviconSizePixels = 48;
+constexpr char kFeedSnapshotFileName[] = "feed_snapshot";
+constexpr char kResponseCacheDirName[] = "responses";
+// Large enough to keep the decoded combined feed, which is several megabytes,
+// next to the publisher list.
+constexpr size_t kResponseCacheMemoryBytes = 24 * 1024 * 1024;
 }  // namespace
 
 // static
@@ -78,7 +83,8 @@ BraveNewsController::BraveNewsController(
     favicon::FaviconService* favicon_service,
     brave_ads::AdsService* ads_service,
     history::HistoryService* history_service,
-    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
+    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
+    const base::FilePath& cache_dir)
     : prefs_(prefs),
       favicon_service_(favicon_service),
       ads_service_(ads_service),
@@ -99,7 +105,8 @@ BraveNewsController::BraveNewsController(
                        &channels_controller_,
                        history_service,
                        &api_request_helper_,
-                       prefs_),
+                       prefs_,
+                       cache_dir.AppendASCII(kFeedSnapshotFileName)),
       suggestions_controller_(prefs_,
                               &publishers_controller_,
                               &api_request_helper_,
@@ -107,6 +114,10 @@ BraveNewsController::BraveNewsController(
       publishers_observation_(this),
       weak_ptr_factory_(this) {
   DCHECK(prefs_);
+  // Feeds and publisher lists are revalidated rather than refetched.
+  api_request_helper_.EnableResponseCache(
+      cache_dir.AppendASCII(kResponseCacheDirName), "BraveNews",
+      kResponseCacheMemoryBytes);
   // Set up preference listeners
   pref_change_registrar_.Init(prefs_);
   pref_change_registrar_.Add(
@@ -138,8 +149,10 @@ void BraveNewsController::Bind(
 }
 
 void BraveNewsController::ClearHistory() {
-  // TODO(petemill): Clear history once/if we actually store
-  // feed cache somewhere.
+  // The feed snapshot is scored against browsing history, and the stored
+  // responses include the user's direct feeds.
+  feed_controller_.ClearCache();
+  api_request_helper_.ClearResponseCache();
 }
 
 mojo::PendingRemote<mojom::BraveNewsController>
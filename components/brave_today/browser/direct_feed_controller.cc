@@ -16,12 +16,13 @@
 #include "base/barrier_callback.h"
 #include "base/bind.h"
 #include "base/callback.h"
-#include "base/containers/flat_set.h"
 #include "base/guid.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/string_util.h"
 #include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/time/time.h"
 #include "brave/components/brave_private_cdn/headers.h"
 #include "brave/components/brave_today/browser/html_parsing.h"
@@ -110,8 +111,61 @@ void ParseFeedDataOffMainThread(const GURL& feed_url,
       std::move(callback));
 }
 
+// A feed that hasn't responded by then is treated as failed.
+constexpr base::TimeDelta kDirectFeedDownloadTimeout = base::Seconds(30);
+
 }  // namespace
 
+// Collects the articles for a DownloadAllContent call.
+class DirectFeedController::DownloadAllContentState
+    : public base::RefCounted<DownloadAllContentState> {
+ public:
+  DownloadAllContentState(size_t feed_count,
+                          GetFeedItemsCallback callback,
+                          FeedDoneCallback on_feed_done)
+      : remaining_(feed_count),
+        callback_(std::move(callback)),
+        on_feed_done_(std::move(on_feed_done)) {}
+  DownloadAllContentState(const DownloadAllContentState&) = delete;
+  DownloadAllContentState& operator=(const DownloadAllContentState&) = delete;
+
+  void OnFeedDone(const std::string& publisher_id, Articles articles) {
+    DCHECK_GT(remaining_, 0u);
+    remaining_--;
+    std::vector<mojom::FeedItemPtr> feed_items;
+    feed_items.reserve(articles.size());
+    for (auto& article : articles)
+      feed_items.push_back(mojom::FeedItem::NewArticle(std::move(article)));
+    if (on_feed_done_)
+      on_feed_done_.Run(publisher_id, feed_items);
+    // Feeds completing after the budget ran out are only reported through
+    // |on_feed_done_|.
+    if (!callback_)
+      return;
+    feed_items_.insert(feed_items_.end(),
+                       std::make_move_iterator(feed_items.begin()),
+                       std::make_move_iterator(feed_items.end()));
+    if (remaining_ == 0)
+      Finish();
+  }
+
+  void Finish() {
+    if (!callback_)
+      return;
+    VLOG(1) << "Direct feeds retrieved, " << remaining_ << " still pending.";
+    std::move(callback_).Run(std::move(feed_items_));
+  }
+
+ private:
+  friend class base::RefCounted<DownloadAllContentState>;
+  ~DownloadAllContentState() = default;
+
+  size_t remaining_;
+  GetFeedItemsCallback callback_;
+  FeedDoneCallback on_feed_done_;
+  std::vector<mojom::FeedItemPtr> feed_items_;
+};
+
 DirectFeedController::DirectFeedController(
     PrefService* prefs,
     scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
@@ -325,38 +379,29 @@ void DirectFeedController::VerifyFeedUrl(const GURL& feed_url,
 
 void DirectFeedController::DownloadAllContent(
     std::vector<mojom::PublisherPtr> publishers,
-    GetFeedItemsCallback callback) {
-  // Handle when all retrieve operations are complete
-  auto all_done_handler = base::BindOnce(
-      [](GetFeedItemsCallback callback, std::vector<Articles> results) {
-        VLOG(1) << "All direct feeds retrieved.";
-        std::size_t total_size = 0;
-        for (const auto& collection : results) {
-          total_size += collection.size();
-        }
-        std::vector<mojom::FeedItemPtr> all_feed_articles;
-        all_feed_articles.reserve(total_size);
-        for (auto& collection : results) {
-          auto it = collection.begin();
-          while (it != collection.end()) {
-            all_feed_articles.insert(
-                all_feed_articles.end(),
-                mojom::FeedItem::NewArticle(*std::make_move_iterator(it)));
-            it = collection.erase(it);
-          }
-        }
-        std::move(callback).Run(std::move(all_feed_articles));
-      },
-      std::move(callback));
-  // Perform requests in parallel and wait for completion
-  auto feed_content_handler = base::BarrierCallback<Articles>(
-      publishers.size(), std::move(all_done_handler));
-  base::flat_set<GURL> direct_feed_urls;
+    GetFeedItemsCallback callback,
+    FeedDoneCallback on_feed_done,
+    base::TimeDelta budget) {
+  auto state = base::MakeRefCounted<DownloadAllContentState>(
+      publishers.size(), std::move(callback), std::move(on_feed_done));
+  if (publishers.empty()) {
+    state->Finish();
+    return;
+  }
+  if (!budget.is_max()) {
+    base::SequencedTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE, base::BindOnce(&DownloadAllContentState::Finish, state),
+        budget);
+  }
+  // Downloads are queued and run in parallel up to the concurrency limits,
+  // each feed is handed to |state| as soon as it is parsed.
   for (auto& publisher : publishers) {
     VLOG(1) << "Downloading feed content from "
             << publisher->feed_source.spec();
-    DownloadFeedContent(publisher->feed_source, publisher->publisher_id,
-                        feed_content_handler);
+    DownloadFeedContent(
+        publisher->feed_source, publisher->publisher_id,
+        base::BindOnce(&DownloadAllContentState::OnFeedDone, state,
+                       publisher->publisher_id));
   }
 }
 
@@ -372,17 +417,27 @@ void DirectFeedController::DownloadFeedContent(const GURL& feed_url,
           std::move(callback).Run({});
           return;
         }
-        // Valid feed, convert items
+        // Valid feed, convert items off the main thread as well.
         VLOG(1) << "Valid feed parsed from " << response->url.spec();
-        Articles articles;
-        DirectFeedController::BuildArticles(articles, response->data,
-                                            publisher_id);
-        VLOG(1) << "Direct feed retrieved article count: " << articles.size();
-        std::move(callback).Run(std::move(articles));
+        base::ThreadPool::PostTaskAndReplyWithResult(
+            FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+            base::BindOnce(
+                [](std::unique_ptr<DirectFeedResponse> response,
+                   const std::string& publisher_id) {
+                  Articles articles;
+                  DirectFeedController::BuildArticles(articles, response->data,
+                                                      publisher_id);
+                  VLOG(1) << "Direct feed retrieved article count: "
+                          << articles.size();
+                  return articles;
+                },
+                std::move(response), publisher_id),
+            std::move(callback));
       },
       std::move(callback), publisher_id);
   // Make request
-  DownloadFeed(feed_url, std::move(responseHandler));
+  DownloadFeed(feed_url, std::move(responseHandler),
+               false /* is_user_initiated */);
 }
 
 // static
@@ -416,8 +471,47 @@ void DirectFeedController::BuildArticles(Articles& articles,
   }
 }
 
+DirectFeedController::PendingDownload::PendingDownload(
+    const GURL& feed_url,
+    DownloadFeedCallback callback)
+    : feed_url(feed_url), callback(std::move(callback)) {}
+DirectFeedController::PendingDownload::PendingDownload(PendingDownload&&) =
+    default;
+DirectFeedController::PendingDownload&
+DirectFeedController::PendingDownload::operator=(PendingDownload&&) = default;
+DirectFeedController::PendingDownload::~PendingDownload() = default;
+
 void DirectFeedController::DownloadFeed(const GURL& feed_url,
-                                        DownloadFeedCallback callback) {
+                                        DownloadFeedCallback callback,
+                                        bool is_user_initiated) {
+  if (is_user_initiated) {
+    pending_downloads_.emplace_front(feed_url, std::move(callback));
+  } else {
+    pending_downloads_.emplace_back(feed_url, std::move(callback));
+  }
+  MaybeStartDownloads();
+}
+
+void DirectFeedController::MaybeStartDownloads() {
+  auto it = pending_downloads_.begin();
+  while (it != pending_downloads_.end() &&
+         url_loaders_.size() < kMaxConcurrentDirectFeedDownloads) {
+    // Skip over hosts which are already busy, a slow server shouldn't hold
+    // up feeds from other hosts.
+    if (active_downloads_per_host_[it->feed_url.host()] >=
+        kMaxConcurrentDirectFeedDownloadsPerHost) {
+      it++;
+      continue;
+    }
+    PendingDownload download = std::move(*it);
+    it = pending_downloads_.erase(it);
+    StartDownload(std::move(download));
+  }
+}
+
+void DirectFeedController::StartDownload(PendingDownload download) {
+  const GURL& feed_url = download.feed_url;
+  active_downloads_per_host_[feed_url.host()]++;
   // Make request
   auto request = std::make_unique<network::ResourceRequest>();
   request->url = feed_url;
@@ -430,12 +524,13 @@ void DirectFeedController::DownloadFeed(const GURL& feed_url,
       1, network::SimpleURLLoader::RetryMode::RETRY_ON_5XX |
              network::SimpleURLLoader::RetryMode::RETRY_ON_NETWORK_CHANGE);
   url_loader->SetAllowHttpErrorResults(true);
+  url_loader->SetTimeoutDuration(kDirectFeedDownloadTimeout);
   auto iter = url_loaders_.insert(url_loaders_.begin(), std::move(url_loader));
   iter->get()->DownloadToString(
       url_loader_factory_.get(),
       // Handle response
       base::BindOnce(&DirectFeedController::OnResponse, base::Unretained(this),
-                     iter, std::move(callback), feed_url),
+                     iter, std::move(download.callback), feed_url),
       5 * 1024 * 1024);
 }
 
@@ -455,6 +550,11 @@ void DirectFeedController::OnResponse(
     }
   }
   url_loaders_.erase(iter);
+  auto host_it = active_downloads_per_host_.find(feed_url.host());
+  DCHECK(host_it != active_downloads_per_host_.end());
+  if (--host_it->second == 0)
+    active_downloads_per_host_.erase(host_it);
+  MaybeStartDownloads();
   // Validate if we get a feed
   std::string body_content = response_body ? *response_body : "";
   // TODO(petemill): handle any url redirects and change the stored feed url?
@@ -11,9 +11,11 @@
 #include <string>
 #include <vector>
 
-#include "base/callback_forward.h"
+#include "base/callback.h"
+#include "base/containers/flat_map.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_refptr.h"
+#include "base/time/time.h"
 #include "brave/components/brave_today/common/brave_news.mojom-forward.h"
 #include "brave/components/brave_today/common/brave_news.mojom-shared.h"
 #include "brave/components/brave_today/common/brave_news.mojom.h"
@@ -31,6 +33,10 @@ class SimpleURLLoader;
 namespace brave_news {
 
 constexpr std::size_t kMaxArticlesPerDirectFeedSource = 100;
+// Feed downloads are queued so that at most this many are in flight, and at
+// most kMaxConcurrentDirectFeedDownloadsPerHost to any single host.
+constexpr std::size_t kMaxConcurrentDirectFeedDownloads = 6;
+constexpr std::size_t kMaxConcurrentDirectFeedDownloadsPerHost = 2;
 
 struct DirectFeedResponse {
  public:
@@ -43,6 +49,9 @@ using Articles = std::vector<mojom::ArticlePtr>;
 using GetArticlesCallback = base::OnceCallback<void(Articles)>;
 using GetFeedItemsCallback =
     base::OnceCallback<void(std::vector<mojom::FeedItemPtr>)>;
+using FeedDoneCallback = base::RepeatingCallback<void(
+    const std::string& publisher_id,
+    const std::vector<mojom::FeedItemPtr>& feed_items)>;
 using DownloadFeedCallback =
     base::OnceCallback<void(std::unique_ptr<DirectFeedResponse>)>;
 using IsValidCallback =
@@ -71,15 +80,33 @@ class DirectFeedController {
   // Returns a list of all the direct feeds currently subscribed to.
   std::vector<mojom::PublisherPtr> ParseDirectFeedsPref();
   void VerifyFeedUrl(const GURL& feed_url, IsValidCallback callback);
-  void DownloadAllContent(std::vector<mojom::PublisherPtr> publishers,
-                          GetFeedItemsCallback callback);
+  // Downloads the articles of all |publishers|. |on_feed_done| runs as each
+  // feed completes. |callback| gets the articles of all completed feeds once
+  // every feed is done or once |budget| has passed, whichever is first, so a
+  // slow feed can't hold up the others.
+  void DownloadAllContent(
+      std::vector<mojom::PublisherPtr> publishers,
+      GetFeedItemsCallback callback,
+      FeedDoneCallback on_feed_done = base::NullCallback(),
+      base::TimeDelta budget = base::TimeDelta::Max());
   void FindFeeds(const GURL& possible_feed_or_site_url,
                  mojom::BraveNewsController::FindFeedsCallback callback);
 
  private:
+  class DownloadAllContentState;
   using SimpleURLLoaderList =
       std::list<std::unique_ptr<network::SimpleURLLoader>>;
 
+  struct PendingDownload {
+    PendingDownload(const GURL& feed_url, DownloadFeedCallback callback);
+    PendingDownload(PendingDownload&&);
+    PendingDownload& operator=(PendingDownload&&);
+    ~PendingDownload();
+
+    GURL feed_url;
+    DownloadFeedCallback callback;
+  };
+
   FRIEND_TEST_ALL_PREFIXES(BraveNewsDirectFeed, ParseToArticle);
   FRIEND_TEST_ALL_PREFIXES(BraveNewsDirectFeed, ParseOnlyAllowsHTTPLinks);
 
@@ -91,7 +118,13 @@ class DirectFeedController {
   void DownloadFeedContent(const GURL& feed_url,
                            const std::string& publisher_id,
                            GetArticlesCallback callback);
-  void DownloadFeed(const GURL& feed_url, DownloadFeedCallback callback);
+  // Queues a feed download. User initiated downloads (|is_user_initiated|)
+  // jump ahead of background refreshes.
+  void DownloadFeed(const GURL& feed_url,
+                    DownloadFeedCallback callback,
+                    bool is_user_initiated = true);
+  void MaybeStartDownloads();
+  void StartDownload(PendingDownload download);
   void OnResponse(SimpleURLLoaderList::iterator iter,
                   DownloadFeedCallback callback,
                   const GURL& feed_url,
@@ -99,6 +132,8 @@ class DirectFeedController {
 
   raw_ptr<PrefService> prefs_;
   SimpleURLLoaderList url_loaders_;
+  std::list<PendingDownload> pending_downloads_;
+  base::flat_map<std::string, size_t> active_downloads_per_host_;
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
 };
 
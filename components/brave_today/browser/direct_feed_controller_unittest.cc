@@ -13,12 +13,18 @@
 
 #include "base/containers/flat_map.h"
 #include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
 #include "brave/components/brave_today/browser/brave_news_controller.h"
 #include "brave/components/brave_today/browser/direct_feed_controller.h"
 #include "brave/components/brave_today/common/pref_names.h"
 #include "brave/components/brave_today/rust/lib.rs.h"
 #include "components/prefs/testing_pref_service.h"
+#include "net/http/http_status_code.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_news {
@@ -393,4 +399,59 @@ TEST(BraveNewsDirectFeed, DirectFeedCanBeInspectedAndRemoved) {
   EXPECT_EQ(0u, parsed.size());
 }
 
+TEST(BraveNewsDirectFeed, DownloadsAreLimitedPerHostAndDelivered) {
+  base::test::TaskEnvironment task_environment(
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME);
+  TestingPrefServiceSimple prefs;
+  BraveNewsController::RegisterProfilePrefs(prefs.registry());
+  network::TestURLLoaderFactory url_loader_factory;
+  DirectFeedController controller(
+      &prefs,
+      base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+          &url_loader_factory));
+
+  // Lots of feeds on a slow host and one on a fast host.
+  std::vector<mojom::PublisherPtr> publishers;
+  for (int i = 0; i < 10; i++) {
+    auto publisher = mojom::Publisher::New();
+    publisher->publisher_id = "slow" + base::NumberToString(i);
+    publisher->feed_source =
+        GURL("https://slow.example.com/" + base::NumberToString(i));
+    publishers.push_back(std::move(publisher));
+  }
+  auto fast_publisher = mojom::Publisher::New();
+  fast_publisher->publisher_id = "fast";
+  fast_publisher->feed_source = GURL("https://fast.example.com/feed");
+  publishers.push_back(std::move(fast_publisher));
+
+  std::vector<std::string> done_feeds;
+  bool all_done = false;
+  controller.DownloadAllContent(
+      std::move(publishers),
+      base::BindLambdaForTesting(
+          [&](std::vector<mojom::FeedItemPtr> items) { all_done = true; }),
+      base::BindLambdaForTesting(
+          [&](const std::string& publisher_id,
+              const std::vector<mojom::FeedItemPtr>& items) {
+            done_feeds.push_back(publisher_id);
+          }),
+      base::Seconds(5));
+
+  // The slow host can't take all the slots, the fast host still gets one.
+  EXPECT_EQ(kMaxConcurrentDirectFeedDownloadsPerHost + 1,
+            static_cast<size_t>(url_loader_factory.NumPending()));
+  EXPECT_TRUE(url_loader_factory.IsPending("https://fast.example.com/feed"));
+
+  // The fast feed is delivered as soon as it completes.
+  url_loader_factory.AddResponse("https://fast.example.com/feed", "",
+                                 net::HTTP_NOT_FOUND);
+  task_environment.RunUntilIdle();
+  EXPECT_EQ(std::vector<std::string>{"fast"}, done_feeds);
+  EXPECT_FALSE(all_done);
+
+  // Slow feeds don't hold up the callback past the budget.
+  task_environment.FastForwardBy(base::Seconds(5));
+  EXPECT_TRUE(all_done);
+}
+
 }  // namespace brave_news
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
 #include <list>
 #include <map>
@@ -58,6 +59,81 @@ std::vector<CardType> page_content_order = {
 std::vector<CardType> random_content_order = {CardType::HEADLINE,
                                               CardType::HEADLINE_PAIRED};
 
+// Pages are generated until the articles run out, or up to this many.
+constexpr int kMaxPages = 4000;
+
+// Returns how many items a card of |card_type| holds at most.
+size_t GetCardCapacity(CardType card_type) {
+  switch (card_type) {
+    case CardType::HEADLINE:
+    case CardType::PROMOTED_ARTICLE:
+      return 1u;
+    case CardType::HEADLINE_PAIRED:
+      return 2u;
+    case CardType::CATEGORY_GROUP:
+    case CardType::PUBLISHER_GROUP:
+    case CardType::DEALS:
+      return 3u;
+    case CardType::DISPLAY_AD:
+      return 0u;
+  }
+}
+
+// Returns how many items of the types in |card_types| a feed of kMaxPages
+// pages can show.
+size_t GetMaxFeedItems(std::initializer_list<CardType> card_types) {
+  size_t per_page = 0;
+  for (const auto* order : {&page_content_order, &random_content_order}) {
+    for (auto card_type : *order) {
+      if (base::Contains(card_types, card_type))
+        per_page += GetCardCapacity(card_type);
+    }
+  }
+  return per_page * kMaxPages;
+}
+
+// Returns the |count| lowest scored items (the best ones), sorted by score
+// ascending. Only the selected items are sorted, and items with equal scores
+// keep their relative order, including at the cut off.
+template <class T>
+std::list<mojo::StructPtr<T>> TakeTopByScore(
+    std::vector<mojo::StructPtr<T>> items,
+    size_t count) {
+  if (count == 0)
+    return {};
+  if (items.size() > count) {
+    std::vector<double> scores;
+    scores.reserve(items.size());
+    for (const auto& item : items)
+      scores.push_back(item->data->score);
+    std::nth_element(scores.begin(), scores.begin() + count - 1, scores.end());
+    const double cut_off = scores[count - 1];
+    size_t below_cut_off = std::count_if(
+        scores.begin(), scores.begin() + count - 1,
+        [cut_off](double score) { return score < cut_off; });
+    size_t at_cut_off = count - below_cut_off;
+
+    std::vector<mojo::StructPtr<T>> selected;
+    selected.reserve(count);
+    for (auto& item : items) {
+      if (item->data->score < cut_off) {
+        selected.push_back(std::move(item));
+      } else if (item->data->score == cut_off && at_cut_off > 0) {
+        selected.push_back(std::move(item));
+        at_cut_off--;
+      }
+    }
+    items = std::move(selected);
+  }
+  std::stable_sort(items.begin(), items.end(),
+                   [](const mojo::StructPtr<T>& a,
+                      const mojo::StructPtr<T>& b) {
+                     return a->data->score < b->data->score;
+                   });
+  return std::list<mojo::StructPtr<T>>(std::make_move_iterator(items.begin()),
+                                       std::make_move_iterator(items.end()));
+}
+
 mojom::FeedItemPtr FromArticle(mojom::ArticlePtr article) {
   return mojom::FeedItem::NewArticle(std::move(article));
 }
@@ -310,9 +386,9 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
   Channels channels =
       ChannelsController::GetChannelsFromPublishers(*publishers, prefs);
 
-  std::list<mojom::ArticlePtr> articles;
-  std::list<mojom::PromotedArticlePtr> promoted_articles;
-  std::list<mojom::DealPtr> deals;
+  std::vector<mojom::ArticlePtr> all_articles;
+  std::vector<mojom::PromotedArticlePtr> all_promoted_articles;
+  std::vector<mojom::DealPtr> all_deals;
   std::hash<std::string> hasher;
   base::flat_set<GURL> seen_articles;
 
@@ -360,30 +436,32 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
     feed->hash = std::to_string(hasher(feed->hash + metadata->url.spec()));
     switch (item->which()) {
       case mojom::FeedItem::Tag::kArticle:
-        articles.push_back(std::move(item->get_article()));
+        all_articles.push_back(std::move(item->get_article()));
         break;
       case mojom::FeedItem::Tag::kDeal:
-        deals.push_back(std::move(item->get_deal()));
+        all_deals.push_back(std::move(item->get_deal()));
         break;
       case mojom::FeedItem::Tag::kPromotedArticle:
-        promoted_articles.push_back(std::move(item->get_promoted_article()));
+        all_promoted_articles.push_back(
+            std::move(item->get_promoted_article()));
         break;
     }
   }
+  // Sort by score, ascending
+  // Only the items the pages can hold are kept, plus the featured article.
+  std::list<mojom::ArticlePtr> articles = TakeTopByScore(
+      std::move(all_articles),
+      GetMaxFeedItems({CardType::HEADLINE, CardType::HEADLINE_PAIRED,
+                       CardType::CATEGORY_GROUP, CardType::PUBLISHER_GROUP}) +
+          1);
+  std::list<mojom::PromotedArticlePtr> promoted_articles =
+      TakeTopByScore(std::move(all_promoted_articles),
+                     GetMaxFeedItems({CardType::PROMOTED_ARTICLE}));
+  std::list<mojom::DealPtr> deals = TakeTopByScore(
+      std::move(all_deals), GetMaxFeedItems({CardType::DEALS}));
   VLOG(1) << "Got articles # " << articles.size();
   VLOG(1) << "Got deals # " << deals.size();
   VLOG(1) << "Got promoted articles # " << promoted_articles.size();
-  // Sort by score, ascending
-  articles.sort([](mojom::ArticlePtr& a, mojom::ArticlePtr& b) {
-    return (a.get()->data->score < b.get()->data->score);
-  });
-  promoted_articles.sort(
-      [](mojom::PromotedArticlePtr& a, mojom::PromotedArticlePtr& b) {
-        return (a.get()->data->score < b.get()->data->score);
-      });
-  deals.sort([](mojom::DealPtr& a, mojom::DealPtr& b) {
-    return (a.get()->data->score < b.get()->data->score);
-  });
   // Get unique categories present with article counts
   std::map<std::string, std::int32_t> category_counts;
   for (auto const& article : articles) {
@@ -460,10 +538,9 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
   // Generate as many pages of content as possible
   // Make the pages
   int cur_page = 0;
-  const int max_pages = 4000;
   auto category_it = category_names_by_priority.begin();
   auto deal_category_it = deal_category_names_by_priority.begin();
-  while (cur_page++ < max_pages) {
+  while (cur_page++ < kMaxPages) {
     if (articles.size() == 0) {
       // No more pages of content
       break;
@@ -17,10 +17,17 @@
 #include "base/barrier_callback.h"
 #include "base/bind.h"
 #include "base/callback_forward.h"
+#include "base/containers/flat_set.h"
 #include "base/feature_list.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
 #include "base/logging.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/one_shot_event.h"
 #include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
 #include "brave/components/api_request_helper/api_request_helper.h"
 #include "brave/components/brave_private_cdn/headers.h"
 #include "brave/components/brave_today/browser/channels_controller.h"
@@ -36,12 +43,21 @@
 #include "components/history/core/browser/history_service.h"
 #include "components/history/core/browser/history_types.h"
 #include "components/prefs/pref_service.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace brave_news {
 
 namespace {
 
 const char kEtagHeaderKey[] = "etag";
+// The combined feed is a few MB per locale, anything much larger is bogus.
+constexpr size_t kMaxFeedBodySize = 20 * 1024 * 1024;
+// How long the feed waits for direct feeds before it is built without the
+// ones that haven't completed yet. Those are merged in when they arrive.
+constexpr base::TimeDelta kDirectFeedsBudget = base::Seconds(5);
+constexpr base::TimeDelta kLateDirectFeedsDelay = base::Seconds(2);
+// Snapshots older than this are too stale to be shown while fetching.
+constexpr base::TimeDelta kMaxSnapshotAge = base::Days(1);
 
 GURL GetFeedUrl(const std::string& default_locale) {
   auto locale =
@@ -53,15 +69,57 @@ GURL GetFeedUrl(const std::string& default_locale) {
   return feed_url;
 }
 
+FeedItems CloneFeedItems(const FeedItems& feed_items) {
+  FeedItems clone;
+  clone.reserve(feed_items.size());
+  for (const auto& item : feed_items)
+    clone.push_back(item->Clone());
+  return clone;
+}
+
 }  // namespace
 
+std::string SerializeFeedSnapshot(const mojom::Feed& feed) {
+  auto clone = feed.Clone();
+  std::vector<uint8_t> data = mojom::Feed::Serialize(&clone);
+  std::string contents(1, static_cast<char>(kFeedSnapshotVersion));
+  contents.append(data.begin(), data.end());
+  return contents;
+}
+
+mojom::FeedPtr DeserializeFeedSnapshot(const std::string& contents) {
+  if (contents.empty() ||
+      static_cast<uint8_t>(contents[0]) != kFeedSnapshotVersion) {
+    VLOG(1) << "Discarding feed snapshot with unknown version";
+    return nullptr;
+  }
+  mojom::FeedPtr feed;
+  if (!mojom::Feed::Deserialize(contents.data() + 1, contents.size() - 1,
+                                &feed)) {
+    return nullptr;
+  }
+  return feed;
+}
+
+absl::optional<std::string> ReadFeedSnapshot(const base::FilePath& path) {
+  base::File::Info info;
+  std::string contents;
+  if (!base::GetFileInfo(path, &info) ||
+      base::Time::Now() - info.last_modified > kMaxSnapshotAge ||
+      !base::ReadFileToString(path, &contents)) {
+    return absl::nullopt;
+  }
+  return contents;
+}
+
 FeedController::FeedController(
     PublishersController* publishers_controller,
     DirectFeedController* direct_feed_controller,
     ChannelsController* channels_controller,
     history::HistoryService* history_service,
     api_request_helper::APIRequestHelper* api_request_helper,
-    PrefService* prefs)
+    PrefService* prefs,
+    const base::FilePath& snapshot_path)
     : prefs_(prefs),
       publishers_controller_(publishers_controller),
       direct_feed_controller_(direct_feed_controller),
@@ -69,8 +127,14 @@ FeedController::FeedController(
       history_service_(history_service),
       api_request_helper_(api_request_helper),
       on_current_update_complete_(new base::OneShotEvent()),
-      publishers_observation_(this) {
+      publishers_observation_(this),
+      snapshot_path_(snapshot_path),
+      file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::BLOCK_SHUTDOWN})),
+      creation_time_(base::TimeTicks::Now()) {
   publishers_observation_.Observe(publishers_controller);
+  LoadSnapshot();
 }
 
 FeedController::~FeedController() = default;
@@ -98,6 +162,7 @@ void FeedController::GetOrFetchFeed(GetFeedCallback callback) {
   GetOrFetchFeed(base::BindOnce(
       [](FeedController* controller, GetFeedCallback callback) {
         if (!controller->current_feed_.hash.empty()) {
+          controller->RecordTimeToFirstFeed();
           auto clone = controller->current_feed_.Clone();
           std::move(callback).Run(std::move(clone));
           return;
@@ -109,14 +174,35 @@ void FeedController::GetOrFetchFeed(GetFeedCallback callback) {
       base::Unretained(this), std::move(callback)));
 }
 
+void FeedController::RecordTimeToFirstFeed() {
+  if (first_feed_served_)
+    return;
+  first_feed_served_ = true;
+  // How long after startup the first news card could be shown, and whether it
+  // came from the snapshot or needed a fetch.
+  base::UmaHistogramMediumTimes("Brave.Today.TimeToFirstFeed",
+                                base::TimeTicks::Now() - creation_time_);
+  base::UmaHistogramBoolean("Brave.Today.FirstFeedFromSnapshot",
+                            is_feed_from_snapshot_);
+}
+
 void FeedController::EnsureFeedIsUpdating() {
-  VLOG(1) << "EnsureFeedIsUpdating " << is_update_in_progress_;
+  UpdateFeed(false);
+}
+
+void FeedController::UpdateFeed(bool only_missing_sources) {
+  VLOG(1) << "UpdateFeed " << is_update_in_progress_
+          << " only_missing_sources: " << only_missing_sources;
   // Only 1 update at a time, other calls for data will wait for
   // the current operation via the `on_publishers_update_` OneShotEvent.
   if (is_update_in_progress_) {
     return;
   }
   is_update_in_progress_ = true;
+  if (!only_missing_sources) {
+    locale_feed_items_.clear();
+    direct_feed_items_.clear();
+  }
 
   // Fetch publishers via callback
   publishers_controller_->GetOrFetchPublishers(base::BindOnce(
@@ -147,7 +233,9 @@ void FeedController::EnsureFeedIsUpdating() {
               VLOG(1) << "All feed item fetches done with item count: "
                       << total_size;
               if (total_size == 0) {
-                controller->ResetFeed();
+                // Probably offline, keep showing the snapshot if we have one.
+                if (!controller->is_feed_from_snapshot_)
+                  controller->ResetFeed();
                 controller->NotifyUpdateDone();
                 return;
               }
@@ -172,14 +260,18 @@ void FeedController::EnsureFeedIsUpdating() {
                       history_hosts.insert(host);
                     }
                     VLOG(1) << "history hosts # " << history_hosts.size();
-                    // Parse directly to in-memory property
-                    controller->ResetFeed();
-                    std::vector<mojom::FeedItemPtr> feed_items;
+                    // Build separately so that a failure doesn't replace the
+                    // snapshot which is being shown.
+                    mojom::Feed feed;
                     if (BuildFeed(all_feed_items, history_hosts, &publishers,
-                                  &controller->current_feed_,
-                                  controller->prefs_)) {
+                                  &feed, controller->prefs_)) {
+                      controller->current_feed_ = std::move(feed);
+                      controller->is_feed_from_snapshot_ = false;
+                      controller->WriteSnapshot();
                     } else {
                       VLOG(1) << "ParseFeed reported failure.";
+                      if (!controller->is_feed_from_snapshot_)
+                        controller->ResetFeed();
                     }
                     // Let any callbacks know that the data is ready
                     // or errored.
@@ -201,8 +293,8 @@ void FeedController::EnsureFeedIsUpdating() {
         controller->FetchCombinedFeed(fetch_items_handler);
         VLOG(1) << "Feed Controller found " << direct_feed_publishers.size()
                 << " direct feeds.";
-        controller->direct_feed_controller_->DownloadAllContent(
-            std::move(direct_feed_publishers), fetch_items_handler);
+        controller->FetchDirectFeeds(std::move(direct_feed_publishers),
+                                     fetch_items_handler);
       },
       base::Unretained(this)));
 }
@@ -235,9 +327,11 @@ void FeedController::UpdateIfRemoteChanged() {
                   if (base::ranges::any_of(updates, [](bool has_update) {
                         return has_update;
                       })) {
-                    // TODO(fallaciousreasoning): Only fetch the specific feed
-                    // which changes.
-                    controller->EnsureFeedIsUpdating();
+                    // Only the locales which changed were marked as stale,
+                    // the others are reused. Direct feeds have no cheap way
+                    // to check for changes so they are refreshed alongside.
+                    controller->direct_feed_items_.clear();
+                    controller->UpdateFeed(true);
                   }
                 },
                 base::Unretained(controller)));
@@ -254,7 +348,8 @@ void FeedController::UpdateIfRemoteChanged() {
           controller->api_request_helper_->Request(
               "HEAD", GetFeedUrl(locale), "", "", true,
               base::BindOnce(
-                  [](std::string current_etag,
+                  [](FeedController* controller, std::string locale,
+                     std::string current_etag,
                      base::RepeatingCallback<void(bool)> has_update_callback,
                      api_request_helper::APIRequestResult api_request_result) {
                     std::string etag;
@@ -282,9 +377,11 @@ void FeedController::UpdateIfRemoteChanged() {
                       return;
                     }
                     // Needs update
+                    controller->locale_feed_items_.erase(locale);
                     has_update_callback.Run(true);
                   },
-                  it->second, check_completed_callback),
+                  base::Unretained(controller), locale, it->second,
+                  check_completed_callback),
               brave::private_cdn_headers);
         }
       },
@@ -293,11 +390,88 @@ void FeedController::UpdateIfRemoteChanged() {
 
 void FeedController::ClearCache() {
   ResetFeed();
+  is_feed_from_snapshot_ = false;
+  locale_feed_items_.clear();
+  direct_feed_items_.clear();
+  pending_direct_feed_ids_.clear();
+  late_direct_feeds_timer_.Stop();
+  // The snapshot was scored against browsing history.
+  file_task_runner_->PostTask(
+      FROM_HERE, base::GetDeleteFileCallback(snapshot_path_));
 }
 
 void FeedController::OnPublishersUpdated(PublishersController* controller) {
   VLOG(1) << "OnPublishersUpdated";
-  EnsureFeedIsUpdating();
+  // Subscription changes only need the sources which aren't fetched yet, the
+  // rest of the feed is rebuilt from the items we already have.
+  UpdateFeed(true);
+}
+
+void FeedController::FetchDirectFeeds(
+    std::vector<mojom::PublisherPtr> publishers,
+    GetFeedItemsCallback callback) {
+  base::flat_set<std::string> publisher_ids;
+  std::vector<mojom::PublisherPtr> missing_publishers;
+  for (auto& publisher : publishers) {
+    publisher_ids.insert(publisher->publisher_id);
+    if (!direct_feed_items_.contains(publisher->publisher_id) &&
+        !pending_direct_feed_ids_.contains(publisher->publisher_id)) {
+      missing_publishers.push_back(std::move(publisher));
+    }
+  }
+  // Drop feeds the user unsubscribed from.
+  base::EraseIf(direct_feed_items_, [&publisher_ids](auto& entry) {
+    return !publisher_ids.contains(entry.first);
+  });
+
+  // Feeds are cached by OnDirectFeedDownloaded as they complete, the feed is
+  // then built from whatever is in the cache.
+  auto merge_cached = base::BindOnce(
+      [](FeedController* controller, GetFeedItemsCallback callback,
+         FeedItems completed_feed_items) {
+        controller->is_waiting_for_direct_feeds_ = false;
+        FeedItems all_feed_items;
+        for (const auto& entry : controller->direct_feed_items_) {
+          for (const auto& item : entry.second)
+            all_feed_items.push_back(item->Clone());
+        }
+        std::move(callback).Run(std::move(all_feed_items));
+      },
+      base::Unretained(this), std::move(callback));
+
+  if (missing_publishers.empty()) {
+    std::move(merge_cached).Run({});
+    return;
+  }
+
+  VLOG(1) << "Downloading " << missing_publishers.size() << " direct feeds.";
+  for (const auto& publisher : missing_publishers)
+    pending_direct_feed_ids_.insert(publisher->publisher_id);
+  is_waiting_for_direct_feeds_ = true;
+  direct_feed_controller_->DownloadAllContent(
+      std::move(missing_publishers), std::move(merge_cached),
+      base::BindRepeating(&FeedController::OnDirectFeedDownloaded,
+                          weak_ptr_factory_.GetWeakPtr()),
+      kDirectFeedsBudget);
+}
+
+void FeedController::OnDirectFeedDownloaded(const std::string& publisher_id,
+                                            const FeedItems& feed_items) {
+  // Drop downloads which were started before the cache was cleared.
+  if (!pending_direct_feed_ids_.erase(publisher_id))
+    return;
+  // Feeds without articles are cached too, so they are not refetched on every
+  // publisher change.
+  direct_feed_items_[publisher_id] = CloneFeedItems(feed_items);
+  if (is_waiting_for_direct_feeds_)
+    return;
+  // The feed was built without this source because it was too slow. Add it
+  // in, waiting a little for other stragglers so we don't rebuild for each.
+  VLOG(1) << "Late direct feed " << publisher_id;
+  late_direct_feeds_timer_.Start(
+      FROM_HERE, kLateDirectFeedsDelay,
+      base::BindOnce(&FeedController::UpdateFeed, base::Unretained(this),
+                     true));
 }
 
 void FeedController::FetchCombinedFeed(GetFeedItemsCallback callback) {
@@ -329,12 +503,26 @@ void FeedController::FetchCombinedFeed(GetFeedItemsCallback callback) {
                 },
                 std::move(callback)));
 
+        // Locales which are no longer needed won't be merged into the feed.
+        base::EraseIf(controller->locale_feed_items_, [&locales](auto& entry) {
+          return !locales.contains(entry.first);
+        });
+
         for (const auto& locale : locales) {
+          // Reuse the items of locales which haven't changed since they were
+          // last fetched.
+          auto cached = controller->locale_feed_items_.find(locale);
+          if (cached != controller->locale_feed_items_.end()) {
+            VLOG(1) << "Reusing feed items for " << locale;
+            locales_fetched_callback.Run(CloneFeedItems(cached->second));
+            continue;
+          }
           // Handle the response
           auto response_handler = base::BindOnce(
               [](FeedController* controller, std::string locale,
                  GetFeedItemsCallback callback,
-                 api_request_helper::APIRequestResult api_request_result) {
+                 api_request_helper::APIRequestResult api_request_result,
+                 absl::optional<FeedItems> feed_items) {
                 std::string etag;
                 if (api_request_result.headers().contains(kEtagHeaderKey)) {
                   etag = api_request_result.headers().at(kEtagHeaderKey);
@@ -343,8 +531,7 @@ void FeedController::FetchCombinedFeed(GetFeedItemsCallback callback) {
                         << api_request_result.response_code()
                         << " etag: " << etag;
                 // Handle bad response
-                if (api_request_result.response_code() != 200 ||
-                    api_request_result.value_body().is_none()) {
+                if (api_request_result.response_code() != 200 || !feed_items) {
                   LOG(ERROR)
                       << "Bad response from brave news feed.json. Status: "
                       << api_request_result.response_code();
@@ -354,17 +541,24 @@ void FeedController::FetchCombinedFeed(GetFeedItemsCallback callback) {
                 // Only mark cache time of remote request if
                 // parsing was successful
                 controller->locale_feed_etags_[locale] = etag;
-                FeedItems feed_items;
-                ParseFeedItems(api_request_result.value_body(), &feed_items);
-                std::move(callback).Run(std::move(feed_items));
+                controller->locale_feed_items_[locale] =
+                    CloneFeedItems(*feed_items);
+                std::move(callback).Run(std::move(*feed_items));
               },
               base::Unretained(controller), locale, locales_fetched_callback);
-          // Send the request
+          // Send the request. Feed items are parsed on a background sequence
+          // straight from the sanitized value.
           GURL feed_url(GetFeedUrl(locale));
           VLOG(1) << "Making feed request to " << feed_url.spec();
-          controller->api_request_helper_->Request(
-              "GET", feed_url, "", "", true, std::move(response_handler),
-              brave::private_cdn_headers);
+          controller->api_request_helper_->RequestTyped<FeedItems>(
+              "GET", feed_url, "", "", true, kMaxFeedBodySize,
+              base::BindOnce([](const base::Value& value) {
+                FeedItems feed_items;
+                if (!ParseFeedItems(value, &feed_items))
+                  return absl::optional<FeedItems>();
+                return absl::make_optional(std::move(feed_items));
+              }),
+              std::move(response_handler), brave::private_cdn_headers);
         }
       },
       base::Unretained(this), std::move(callback)));
@@ -373,11 +567,27 @@ void FeedController::FetchCombinedFeed(GetFeedItemsCallback callback) {
 void FeedController::GetOrFetchFeed(base::OnceClosure callback) {
   VLOG(1) << "getorfetch feed(oc) start: "
           << on_current_update_complete_->is_signaled();
+  // The on-disk snapshot is much quicker than a fetch, so wait for it first.
+  if (!on_snapshot_loaded_.is_signaled()) {
+    on_snapshot_loaded_.Post(
+        FROM_HERE,
+        base::BindOnce(
+            [](base::WeakPtr<FeedController> controller,
+               base::OnceClosure callback) {
+              if (controller)
+                controller->GetOrFetchFeed(std::move(callback));
+            },
+            weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+    return;
+  }
   // If in-memory feed is, no need to wait, otherwise wait for fetch
   // to be complete.
   if (!current_feed_.hash.empty()) {
     VLOG(1) << "getorfetchfeed(oc) from cache";
     std::move(callback).Run();
+    // Show the snapshot straight away but refresh it in the background.
+    if (is_feed_from_snapshot_)
+      EnsureFeedIsUpdating();
     return;
   }
   // Ensure feed is currently being fetched.
@@ -392,6 +602,45 @@ void FeedController::ResetFeed() {
   current_feed_.pages.clear();
 }
 
+void FeedController::LoadSnapshot() {
+  file_task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&ReadFeedSnapshot, snapshot_path_),
+      base::BindOnce(&FeedController::OnSnapshotLoaded,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void FeedController::OnSnapshotLoaded(absl::optional<std::string> contents) {
+  // A fetch may have finished first, it is always fresher than the snapshot.
+  if (contents && current_feed_.hash.empty()) {
+    auto feed = DeserializeFeedSnapshot(*contents);
+    if (feed && !feed->hash.empty()) {
+      VLOG(1) << "Loaded feed snapshot " << feed->hash;
+      current_feed_.hash = std::move(feed->hash);
+      current_feed_.featured_item = std::move(feed->featured_item);
+      current_feed_.pages = std::move(feed->pages);
+      is_feed_from_snapshot_ = true;
+    }
+  }
+  on_snapshot_loaded_.Signal();
+}
+
+void FeedController::WriteSnapshot() {
+  if (current_feed_.hash.empty())
+    return;
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](const base::FilePath& path, std::string contents) {
+            if (!base::CreateDirectory(path.DirName()) ||
+                !base::ImportantFileWriter::WriteFileAtomically(path,
+                                                                contents)) {
+              VLOG(1) << "Could not write feed snapshot to " << path;
+            }
+          },
+          snapshot_path_, SerializeFeedSnapshot(current_feed_)));
+}
+
 void FeedController::NotifyUpdateDone() {
   // Let any callbacks know that the data is ready.
   on_current_update_complete_->Signal();
@@ -6,14 +6,21 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_TODAY_BROWSER_FEED_CONTROLLER_H_
 #define BRAVE_COMPONENTS_BRAVE_TODAY_BROWSER_FEED_CONTROLLER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/containers/flat_set.h"
+#include "base/files/file_path.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/one_shot_event.h"
 #include "base/scoped_observation.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "brave/components/api_request_helper/api_request_helper.h"
 #include "brave/components/brave_today/browser/channels_controller.h"
 #include "brave/components/brave_today/browser/direct_feed_controller.h"
@@ -23,6 +30,11 @@
 #include "components/prefs/pref_service.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/remote_set.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
 
 namespace history {
 class HistoryService;
@@ -34,6 +46,16 @@ using GetFeedCallback = mojom::BraveNewsController::GetFeedCallback;
 using FeedItems = std::vector<mojom::FeedItemPtr>;
 using GetFeedItemsCallback = base::OnceCallback<void(FeedItems)>;
 
+// Bump whenever mojom::Feed changes, older snapshots are then discarded.
+constexpr uint8_t kFeedSnapshotVersion = 1;
+
+// Exposed for testing
+std::string SerializeFeedSnapshot(const mojom::Feed& feed);
+mojom::FeedPtr DeserializeFeedSnapshot(const std::string& contents);
+// Returns the contents of the snapshot at |path| unless it is too old to be
+// shown.
+absl::optional<std::string> ReadFeedSnapshot(const base::FilePath& path);
+
 class FeedController : public PublishersController::Observer {
  public:
   FeedController(PublishersController* publishers_controller,
@@ -41,7 +63,8 @@ class FeedController : public PublishersController::Observer {
                  ChannelsController* channels_controller,
                  history::HistoryService* history_service,
                  api_request_helper::APIRequestHelper* api_request_helper,
-                 PrefService* prefs);
+                 PrefService* prefs,
+                 const base::FilePath& snapshot_path);
   ~FeedController() override;
   FeedController(const FeedController&) = delete;
   FeedController& operator=(const FeedController&) = delete;
@@ -73,10 +96,21 @@ class FeedController : public PublishersController::Observer {
   void OnPublishersUpdated(PublishersController* publishers) override;
 
  private:
+  // When |only_missing_sources| is set, sources whose items are still cached
+  // are not fetched again and are merged with the newly fetched ones.
+  void UpdateFeed(bool only_missing_sources);
   void FetchCombinedFeed(GetFeedItemsCallback callback);
+  void FetchDirectFeeds(std::vector<mojom::PublisherPtr> publishers,
+                        GetFeedItemsCallback callback);
+  void OnDirectFeedDownloaded(const std::string& publisher_id,
+                              const FeedItems& feed_items);
   void GetOrFetchFeed(base::OnceClosure callback);
   void ResetFeed();
   void NotifyUpdateDone();
+  void LoadSnapshot();
+  void OnSnapshotLoaded(absl::optional<std::string> contents);
+  void WriteSnapshot();
+  void RecordTimeToFirstFeed();
 
   raw_ptr<PrefService> prefs_ = nullptr;
   raw_ptr<PublishersController> publishers_controller_ = nullptr;
@@ -101,6 +135,31 @@ class FeedController : public PublishersController::Observer {
   // determine when we have available updates.
   base::flat_map<std::string, std::string> locale_feed_etags_;
   bool is_update_in_progress_ = false;
+
+  // Items from the last fetch of each combined feed locale and of each direct
+  // feed publisher, so that a change to one source only refetches that
+  // source.
+  base::flat_map<std::string, FeedItems> locale_feed_items_;
+  base::flat_map<std::string, FeedItems> direct_feed_items_;
+  // Direct feeds which are still downloading, possibly after the feed was
+  // built without them.
+  base::flat_set<std::string> pending_direct_feed_ids_;
+  bool is_waiting_for_direct_feeds_ = false;
+  base::OneShotTimer late_direct_feeds_timer_;
+
+  // The last built feed is persisted so that it can be shown at startup
+  // before any fetch completes.
+  base::FilePath snapshot_path_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  base::OneShotEvent on_snapshot_loaded_;
+  // Stays set until a fetched feed replaces the snapshot, failed or empty
+  // fetches keep it.
+  bool is_feed_from_snapshot_ = false;
+
+  base::TimeTicks creation_time_;
+  bool first_feed_served_ = false;
+
+  base::WeakPtrFactory<FeedController> weak_ptr_factory_{this};
 };
 
 }  // namespace brave_news
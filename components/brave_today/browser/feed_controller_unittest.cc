@@ -0,0 +1,78 @@
+// Copyright (c) 2022 The Brave Authors. All rights reserved.
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "brave/components/brave_today/browser/feed_controller.h"
+
+#include <string>
+#include <utility>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/time/time.h"
+#include "brave/components/brave_today/common/brave_news.mojom.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_news {
+
+namespace {
+
+mojom::FeedItemPtr MakeArticle(const std::string& url) {
+  auto metadata = mojom::FeedItemMetadata::New();
+  metadata->url = GURL(url);
+  metadata->title = "Title";
+  metadata->publisher_id = "111";
+  metadata->image = mojom::Image::NewPaddedImageUrl(GURL(url + ".pad"));
+  metadata->score = 12.5;
+  auto article = mojom::Article::New();
+  article->data = std::move(metadata);
+  return mojom::FeedItem::NewArticle(std::move(article));
+}
+
+}  // namespace
+
+TEST(BraveNewsFeedController, SnapshotRoundTrip) {
+  mojom::Feed feed;
+  feed.hash = "1234";
+  feed.featured_item = MakeArticle("https://example.com/featured");
+  auto page = mojom::FeedPage::New();
+  auto page_item = mojom::FeedPageItem::New();
+  page_item->card_type = mojom::CardType::HEADLINE;
+  page_item->items.push_back(MakeArticle("https://example.com/a"));
+  page->items.push_back(std::move(page_item));
+  feed.pages.push_back(std::move(page));
+
+  auto restored = DeserializeFeedSnapshot(SerializeFeedSnapshot(feed));
+  ASSERT_TRUE(restored);
+  EXPECT_TRUE(feed.Equals(*restored));
+}
+
+TEST(BraveNewsFeedController, SnapshotRejectsOtherVersions) {
+  mojom::Feed feed;
+  feed.hash = "1234";
+  std::string contents = SerializeFeedSnapshot(feed);
+  contents[0] = static_cast<char>(kFeedSnapshotVersion + 1);
+  EXPECT_FALSE(DeserializeFeedSnapshot(contents));
+
+  EXPECT_FALSE(DeserializeFeedSnapshot(""));
+  EXPECT_FALSE(DeserializeFeedSnapshot(
+      std::string(1, static_cast<char>(kFeedSnapshotVersion))));
+}
+
+TEST(BraveNewsFeedController, ReadSnapshotSkipsStaleSnapshots) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("feed_snapshot");
+  EXPECT_FALSE(ReadFeedSnapshot(path));
+
+  ASSERT_TRUE(base::WriteFile(path, "snapshot"));
+  EXPECT_EQ("snapshot", ReadFeedSnapshot(path));
+
+  const base::Time last_week = base::Time::Now() - base::Days(7);
+  ASSERT_TRUE(base::TouchFile(path, last_week, last_week));
+  EXPECT_FALSE(ReadFeedSnapshot(path));
+}
+
+}  // namespace brave_news
@@ -11,6 +11,7 @@
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "brave/components/brave_shields/common/class_id_filter.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
@@ -68,9 +69,20 @@ void CosmeticFiltersResources::HiddenClassIdSelectors(
 
 void CosmeticFiltersResources::UrlCosmeticResources(
     const std::string& url,
+    int32_t class_id_filter_version,
     UrlCosmeticResourcesCallback callback) {
   DCHECK(ad_block_service_->GetTaskRunner()->RunsTasksInCurrentSequence());
   auto resources = ad_block_service_->UrlCosmeticResources(url);
+  if (resources && resources->is_dict()) {
+    int version = 0;
+    const brave_shields::ClassIdFilter* filter =
+        ad_block_service_->GetClassIdFilter(&version);
+    auto& dict = resources->GetDict();
+    dict.Set("class_id_filter_version", version);
+    // The filter is tens of KB, only send it when the renderer's is stale.
+    if (filter && version != class_id_filter_version)
+      dict.Set("class_id_filter", base::Value(filter->bytes()));
+  }
   std::move(callback).Run(resources ? std::move(resources.value())
                                     : base::Value());
 }
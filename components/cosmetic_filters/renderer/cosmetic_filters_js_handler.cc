@@ -9,12 +9,14 @@
 
 #include "base/bind.h"
 #include "base/feature_list.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/no_destructor.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/trace_event/trace_event.h"
+#include "brave/components/brave_shields/common/class_id_filter.h"
 #include "brave/components/brave_shields/common/features.h"
 #include "brave/components/content_settings/renderer/brave_content_settings_agent_impl.h"
 #include "brave/components/cosmetic_filters/resources/grit/cosmetic_filters_generated_map.h"
@@ -142,6 +144,75 @@ bool IsVettedSearchEngine(const GURL& url) {
   return false;
 }
 
+// Class and id filter of the browser's generic cosmetic rules, shared by all
+// frames of the process.
+struct ClassIdFilterState {
+  int version = -1;
+  absl::optional<brave_shields::ClassIdFilter> filter;
+};
+
+ClassIdFilterState& GetClassIdFilterState() {
+  static base::NoDestructor<ClassIdFilterState> state;
+  return *state;
+}
+
+// Picks up the filter UrlCosmeticResources sent along with |resources|, if the
+// one this process has is stale.
+void UpdateClassIdFilter(base::Value::Dict* resources) {
+  const absl::optional<int> version =
+      resources->FindInt("class_id_filter_version");
+  if (!version)
+    return;
+
+  auto& state = GetClassIdFilterState();
+  if (*version != state.version) {
+    state.version = *version;
+    const base::Value::BlobStorage* bytes =
+        resources->FindBlob("class_id_filter");
+    state.filter =
+        bytes ? brave_shields::ClassIdFilter::FromBytes(*bytes) : absl::nullopt;
+  }
+  resources->Remove("class_id_filter_version");
+  resources->Remove("class_id_filter");
+}
+
+// Drops the names in |input| that no generic rule is keyed on, and returns
+// false if none are left. |input| is a JSON object with "classes" and "ids".
+bool FilterClassIdCandidates(const std::string& input, std::string* output) {
+  const auto& filter = GetClassIdFilterState().filter;
+  absl::optional<base::Value> input_value;
+  if (filter)
+    input_value = base::JSONReader::Read(input);
+  if (!input_value || !input_value->is_dict()) {
+    *output = input;
+    return true;
+  }
+
+  size_t candidates = 0;
+  for (const bool classes : {true, false}) {
+    const char* key = classes ? "classes" : "ids";
+    const base::Value::List* names = input_value->GetDict().FindList(key);
+    if (!names)
+      continue;
+
+    base::Value::List candidate_names;
+    for (const auto& name : *names) {
+      if (!name.is_string())
+        continue;
+      if (classes ? filter->MayContainClass(name.GetString())
+                  : filter->MayContainId(name.GetString())) {
+        candidate_names.Append(name.GetString());
+      }
+    }
+    candidates += candidate_names.size();
+    input_value->GetDict().Set(key, std::move(candidate_names));
+  }
+
+  if (!candidates)
+    return false;
+  return base::JSONWriter::Write(*input_value, output);
+}
+
 // ID is used in TRACE_ID_WITH_SCOPE(). Must be unique accoss the process.
 int MakeUniquePerfId() {
   static int counter = 0;
@@ -160,6 +231,26 @@ namespace cosmetic_filters {
 // halalz://tracing & halalz://histograms.
 class CosmeticFilterPerfTracker {
  public:
+  ~CosmeticFilterPerfTracker() {
+    const int queries = skipped_queries_ + sent_queries_;
+    if (!queries)
+      return;
+    UMA_HISTOGRAM_PERCENTAGE(
+        "Brave.CosmeticFilters.HiddenClassIdSelectorsSkipped",
+        skipped_queries_ * 100 / queries);
+    UMA_HISTOGRAM_COUNTS_10000(
+        "Brave.CosmeticFilters.HiddenClassIdSelectorsSent", sent_queries_);
+  }
+
+  // Queries for hidden class and id selectors that needed a round trip to the
+  // browser, and those that the class and id filter answered.
+  void OnHiddenClassIdSelectorsSent() { sent_queries_++; }
+  void OnHiddenClassIdSelectorsSkipped() {
+    skipped_queries_++;
+    TRACE_EVENT_INSTANT0(TRACE_CATEGORY, "HiddenClassIdSelectorsSkipped",
+                         TRACE_EVENT_SCOPE_THREAD);
+  }
+
   int OnHandleMutationsBegin() {
     const auto event_id = MakeUniquePerfId();
     TRACE_EVENT_NESTABLE_ASYNC_BEGIN0(
@@ -187,6 +278,10 @@ class CosmeticFilterPerfTracker {
         TRACE_CATEGORY, "QuerySelectors",
         TRACE_ID_WITH_SCOPE("QuerySelectors", event_id));
   }
+
+ private:
+  int sent_queries_ = 0;
+  int skipped_queries_ = 0;
 };
 
 CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
@@ -211,8 +306,18 @@ void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
   if (!EnsureConnected())
     return;
 
+  // Neither case can add any rule, see OnHiddenClassIdSelectors.
+  std::string candidates;
+  if (generichide_ || !FilterClassIdCandidates(input, &candidates)) {
+    if (perf_tracker_)
+      perf_tracker_->OnHiddenClassIdSelectorsSkipped();
+    return;
+  }
+  if (perf_tracker_)
+    perf_tracker_->OnHiddenClassIdSelectorsSent();
+
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      candidates, exceptions_,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
                      base::Unretained(this)));
 }
@@ -367,7 +472,7 @@ bool CosmeticFiltersJSHandler::ProcessURL(
         "Brave.CosmeticFilters.UrlCosmeticResources");
     TRACE_EVENT1("brave.adblock", "UrlCosmeticResources", "url", url_.spec());
     cosmetic_filters_resources_->UrlCosmeticResources(
-        url_.spec(),
+        url_.spec(), GetClassIdFilterState().version,
         base::BindOnce(&CosmeticFiltersJSHandler::OnUrlCosmeticResources,
                        base::Unretained(this), std::move(callback.value())));
   } else {
@@ -376,11 +481,14 @@ bool CosmeticFiltersJSHandler::ProcessURL(
     SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
         "Brave.CosmeticFilters.UrlCosmeticResourcesSync");
     base::Value result;
-    cosmetic_filters_resources_->UrlCosmeticResources(url_.spec(), &result);
+    cosmetic_filters_resources_->UrlCosmeticResources(
+        url_.spec(), GetClassIdFilterState().version, &result);
 
     auto* dict = result.GetIfDict();
-    if (dict)
+    if (dict) {
+      UpdateClassIdFilter(dict);
       resources_dict_ = std::move(*dict);
+    }
   }
 
   return true;
@@ -393,8 +501,10 @@ void CosmeticFiltersJSHandler::OnUrlCosmeticResources(
     return;
 
   auto* dict = result.GetIfDict();
-  if (dict)
+  if (dict) {
+    UpdateClassIdFilter(dict);
     resources_dict_ = std::move(*dict);
+  }
 
   std::move(callback).Run();
 }
@@ -469,6 +469,8 @@ void NTPBackgroundImagesService::OnGetComponentJsonData(
     const std::string& json_string) {
   bi_images_data_ =
       std::make_unique<NTPBackgroundImagesData>(json_string, bi_installed_dir_);
+  // Images of the previous component version are not served anymore.
+  image_cache_.Clear();
 
   for (auto& observer : observer_list_) {
     observer.OnUpdated(bi_images_data_.get());
@@ -523,6 +525,8 @@ void NTPBackgroundImagesService::OnGetSponsoredComponentJsonData(
     return;
   }
 
+  image_cache_.Clear();
+
   for (auto& observer : observer_list_) {
     observer.OnUpdated(is_super_referral ? sr_images_data_.get()
                                          : si_images_data_.get());
@@ -0,0 +1,114 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_image_cache.h"
+
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/task/thread_pool.h"
+
+namespace ntp_background_images {
+
+namespace {
+
+// A single image may not take more than this share of the cache.
+constexpr size_t kMaxEntryShare = 2;
+
+scoped_refptr<base::RefCountedMemory> ReadImageFile(
+    const base::FilePath& image_file) {
+  std::string contents;
+  if (!base::ReadFileToString(image_file, &contents))
+    return nullptr;
+  // The string is moved into the buffer that is handed out, not copied.
+  return base::MakeRefCounted<base::RefCountedString>(std::move(contents));
+}
+
+}  // namespace
+
+NTPImageCache::NTPImageCache(size_t max_bytes)
+    : images_(max_bytes, kMaxEntryShare) {}
+
+NTPImageCache::~NTPImageCache() = default;
+
+void NTPImageCache::GetImage(const base::FilePath& image_file,
+                             GetImageCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (auto* image = images_.Get(image_file)) {
+    RecordLookup(LookupResult::kHit);
+    UMA_HISTOGRAM_TIMES("Brave.NTP.ImageCache.LoadTime", base::TimeDelta());
+    std::move(callback).Run(*image);
+    return;
+  }
+
+  auto pending = pending_reads_.find({image_file, images_.generation()});
+  if (pending != pending_reads_.end()) {
+    RecordLookup(LookupResult::kPending);
+    pending->second.emplace_back(std::move(callback), base::TimeTicks::Now());
+    return;
+  }
+
+  RecordLookup(LookupResult::kMiss);
+  pending_reads_[{image_file, images_.generation()}].emplace_back(
+      std::move(callback), base::TimeTicks::Now());
+  ReadImage(image_file);
+}
+
+void NTPImageCache::Prefetch(const base::FilePath& image_file) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (images_.Peek(image_file) ||
+      pending_reads_.count({image_file, images_.generation()})) {
+    return;
+  }
+
+  pending_reads_.try_emplace({image_file, images_.generation()});
+  ReadImage(image_file);
+}
+
+void NTPImageCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  images_.Clear();
+}
+
+void NTPImageCache::ReadImage(const base::FilePath& image_file) {
+  // A new tab is waiting for the image, or will be shortly.
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&ReadImageFile, image_file),
+      base::BindOnce(&NTPImageCache::OnReadImage, weak_factory_.GetWeakPtr(),
+                     PendingReadKey(image_file, images_.generation())));
+}
+
+void NTPImageCache::OnReadImage(const PendingReadKey& key,
+                                scoped_refptr<base::RefCountedMemory> bytes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto pending = pending_reads_.extract(key);
+  DCHECK(!pending.empty());
+
+  // The file may have changed since the cache was cleared.
+  if (bytes && key.second == images_.generation())
+    images_.Put(key.first, bytes, bytes->size());
+
+  for (auto& [callback, start_time] : pending.mapped()) {
+    UMA_HISTOGRAM_TIMES("Brave.NTP.ImageCache.LoadTime",
+                        base::TimeTicks::Now() - start_time);
+    std::move(callback).Run(bytes);
+  }
+}
+
+void NTPImageCache::RecordLookup(LookupResult result) {
+  if (result == LookupResult::kMiss)
+    misses_++;
+  else
+    hits_++;
+  UMA_HISTOGRAM_ENUMERATION("Brave.NTP.ImageCache.Lookup", result);
+}
+
+}  // namespace ntp_background_images
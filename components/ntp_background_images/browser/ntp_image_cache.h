@@ -0,0 +1,97 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_IMAGE_CACHE_H_
+#define BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_IMAGE_CACHE_H_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "brave/components/sized_lru_cache/sized_lru_cache.h"
+
+namespace ntp_background_images {
+
+// Bounded in-memory cache of the encoded NTP background, sponsored and logo
+// images, so that opening new tabs in a row doesn't read the same multi
+// megabyte files from disk each time. It is owned by NTPBackgroundImagesService
+// and therefore shared by all profiles.
+//
+// Images are handed out as the cached buffer itself rather than a copy, and
+// files that are being read are only read once however many tabs wait for
+// them. Entries are evicted least recently used first once they exceed the
+// byte budget.
+class NTPImageCache {
+ public:
+  // Recorded to Brave.NTP.ImageCache.Lookup. Don't renumber.
+  enum class LookupResult {
+    kMiss = 0,
+    kHit = 1,
+    // The image was already being read, e.g. prefetched.
+    kPending = 2,
+    kMaxValue = kPending,
+  };
+
+  using GetImageCallback =
+      base::OnceCallback<void(scoped_refptr<base::RefCountedMemory> bytes)>;
+
+  static constexpr size_t kDefaultMaxBytes = 16 * 1024 * 1024;
+
+  explicit NTPImageCache(size_t max_bytes = kDefaultMaxBytes);
+  ~NTPImageCache();
+  NTPImageCache(const NTPImageCache&) = delete;
+  NTPImageCache& operator=(const NTPImageCache&) = delete;
+
+  // Runs |callback| with the contents of |image_file|, or null if it can't be
+  // read. Hits run |callback| synchronously.
+  void GetImage(const base::FilePath& image_file, GetImageCallback callback);
+
+  // Starts reading |image_file| into the cache unless it's already there.
+  void Prefetch(const base::FilePath& image_file);
+
+  // Drops the cached images. Reads that are running are still answered, but
+  // their results aren't cached, and later requests read the files again.
+  void Clear();
+
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+  size_t bytes() const { return images_.bytes(); }
+
+ private:
+  // Files being read, along with the generation of |images_| they were
+  // started in.
+  using PendingReadKey = std::pair<base::FilePath, int>;
+
+  void ReadImage(const base::FilePath& image_file);
+  void OnReadImage(const PendingReadKey& key,
+                   scoped_refptr<base::RefCountedMemory> bytes);
+  void RecordLookup(LookupResult result);
+
+  brave::SizedLRUCache<base::FilePath, scoped_refptr<base::RefCountedMemory>>
+      images_;
+
+  // Callbacks waiting for the files being read, along with when each started
+  // waiting. Prefetches don't wait, so their lists start empty.
+  std::map<PendingReadKey,
+           std::vector<std::pair<GetImageCallback, base::TimeTicks>>>
+      pending_reads_;
+
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<NTPImageCache> weak_factory_{this};
+};
+
+}  // namespace ntp_background_images
+
+#endif  // BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_IMAGE_CACHE_H_
@@ -0,0 +1,144 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_image_cache.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ntp_background_images {
+
+class NTPImageCacheTest : public testing::Test {
+ public:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath WriteImage(const std::string& name, size_t size) {
+    const base::FilePath path = temp_dir_.GetPath().AppendASCII(name);
+    EXPECT_TRUE(base::WriteFile(path, std::string(size, 'x')));
+    return path;
+  }
+
+  scoped_refptr<base::RefCountedMemory> GetImage(
+      NTPImageCache* cache,
+      const base::FilePath& image_file) {
+    base::test::TestFuture<scoped_refptr<base::RefCountedMemory>> future;
+    cache->GetImage(image_file, future.GetCallback());
+    return future.Take();
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(NTPImageCacheTest, ServesCachedImage) {
+  NTPImageCache cache;
+  const base::FilePath path = WriteImage("background-1.jpg", 100);
+
+  auto first = GetImage(&cache, path);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(100u, first->size());
+
+  // Changes to the file are not seen once it is cached.
+  ASSERT_TRUE(base::WriteFile(path, "y"));
+  auto second = GetImage(&cache, path);
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(1u, cache.misses());
+  EXPECT_EQ(1u, cache.hits());
+}
+
+TEST_F(NTPImageCacheTest, ReadsOnceForConcurrentRequests) {
+  NTPImageCache cache;
+  const base::FilePath path = WriteImage("background-1.jpg", 100);
+
+  base::test::TestFuture<scoped_refptr<base::RefCountedMemory>> first;
+  base::test::TestFuture<scoped_refptr<base::RefCountedMemory>> second;
+  cache.GetImage(path, first.GetCallback());
+  cache.GetImage(path, second.GetCallback());
+
+  ASSERT_TRUE(first.Get());
+  EXPECT_EQ(first.Get().get(), second.Get().get());
+  EXPECT_EQ(1u, cache.misses());
+  EXPECT_EQ(1u, cache.hits());
+}
+
+TEST_F(NTPImageCacheTest, Prefetch) {
+  NTPImageCache cache;
+  const base::FilePath path = WriteImage("background-1.jpg", 100);
+
+  cache.Prefetch(path);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(100u, cache.bytes());
+
+  EXPECT_TRUE(GetImage(&cache, path));
+  EXPECT_EQ(0u, cache.misses());
+  EXPECT_EQ(1u, cache.hits());
+}
+
+TEST_F(NTPImageCacheTest, MissingFile) {
+  NTPImageCache cache;
+
+  EXPECT_FALSE(
+      GetImage(&cache, temp_dir_.GetPath().AppendASCII("missing.jpg")));
+  EXPECT_EQ(0u, cache.bytes());
+}
+
+TEST_F(NTPImageCacheTest, EvictsLeastRecentlyUsed) {
+  NTPImageCache cache(/*max_bytes=*/100);
+  const base::FilePath first = WriteImage("background-1.jpg", 40);
+  const base::FilePath second = WriteImage("background-2.jpg", 40);
+  const base::FilePath third = WriteImage("background-3.jpg", 40);
+
+  GetImage(&cache, first);
+  GetImage(&cache, second);
+  GetImage(&cache, first);
+  GetImage(&cache, third);
+  EXPECT_EQ(80u, cache.bytes());
+
+  GetImage(&cache, first);
+  EXPECT_EQ(2u, cache.hits());
+  GetImage(&cache, second);
+  EXPECT_EQ(4u, cache.misses());
+}
+
+TEST_F(NTPImageCacheTest, DoesNotCacheLargeImages) {
+  NTPImageCache cache(/*max_bytes=*/100);
+  const base::FilePath path = WriteImage("background-1.jpg", 60);
+
+  EXPECT_TRUE(GetImage(&cache, path));
+  EXPECT_EQ(0u, cache.bytes());
+}
+
+TEST_F(NTPImageCacheTest, ClearDuringRead) {
+  NTPImageCache cache;
+  const base::FilePath path = WriteImage("background-1.jpg", 100);
+
+  // A read that is running when the cache is cleared is still answered, but
+  // its result isn't cached.
+  base::test::TestFuture<scoped_refptr<base::RefCountedMemory>> stale;
+  cache.GetImage(path, stale.GetCallback());
+  cache.Clear();
+  ASSERT_TRUE(stale.Get());
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(0u, cache.bytes());
+
+  // Requests made after clearing don't wait for a read started before.
+  base::test::TestFuture<scoped_refptr<base::RefCountedMemory>> second_stale;
+  cache.GetImage(path, second_stale.GetCallback());
+  cache.Clear();
+  EXPECT_TRUE(GetImage(&cache, path));
+  ASSERT_TRUE(second_stale.Get());
+  EXPECT_EQ(3u, cache.misses());
+  EXPECT_EQ(0u, cache.hits());
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(100u, cache.bytes());
+}
+
+}  // namespace ntp_background_images
@@ -28,6 +28,12 @@ class ViewCounterModel {
   // Returns current campaign index and its bg index.
   std::tuple<size_t, size_t> GetCurrentBrandedImageIndex() const;
 
+  // Whether GetCurrentBrandedImageIndex() can be called.
+  bool HasBrandedImageIndex() const {
+    return current_campaign_index_ <
+           campaigns_current_branded_image_index_.size();
+  }
+
   int current_wallpaper_image_index() const {
     return current_wallpaper_image_index_;
   }
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "brave/components/brave_rewards/common/pref_names.h"
 #include "brave/components/ntp_background_images/browser/features.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_data.h"
+#include "brave/components/ntp_background_images/browser/ntp_image_cache.h"
 #include "brave/components/ntp_background_images/browser/ntp_p3a_helper.h"
 #include "brave/components/ntp_background_images/browser/ntp_sponsored_images_data.h"
 #include "brave/components/ntp_background_images/browser/url_constants.h"
@@ -332,6 +334,47 @@ void ViewCounterService::RegisterPageView() {
   service_->CheckNTPSIComponentUpdateIfNeeded();
   model_.RegisterPageView();
   MaybePrefetchNewTabPageAd();
+  PrefetchWallpaperImages();
+}
+
+void ViewCounterService::PrefetchWallpaperImages() {
+  NTPImageCache* image_cache = service_->image_cache();
+
+  // The background that this page view is about to request, and the next one.
+  auto* data = GetCurrentWallpaperData();
+  if (data && !data->backgrounds.empty() && IsBackgroundWallpaperActive() &&
+      !ShouldShowCustomBackground()) {
+    const size_t count = data->backgrounds.size();
+    const size_t index = model_.current_wallpaper_image_index();
+    image_cache->Prefetch(data->backgrounds[index % count].image_file);
+    image_cache->Prefetch(data->backgrounds[(index + 1) % count].image_file);
+  }
+
+  // The sponsored image that is scheduled to be shown next.
+  auto* branded_data = GetCurrentBrandedWallpaperData();
+  if (!branded_data || !IsBrandedWallpaperActive() ||
+      !model_.HasBrandedImageIndex()) {
+    return;
+  }
+
+  size_t campaign_index;
+  size_t background_index;
+  std::tie(campaign_index, background_index) =
+      model_.GetCurrentBrandedImageIndex();
+  if (campaign_index >= branded_data->campaigns.size()) {
+    return;
+  }
+
+  const auto& backgrounds = branded_data->campaigns[campaign_index].backgrounds;
+  if (background_index >= backgrounds.size()) {
+    return;
+  }
+
+  const SponsoredBackground& background = backgrounds[background_index];
+  image_cache->Prefetch(background.image_file);
+  if (!background.logo.image_file.empty()) {
+    image_cache->Prefetch(background.logo.image_file);
+  }
 }
 
 void ViewCounterService::BrandedWallpaperLogoClicked(
@@ -157,6 +157,9 @@ class ViewCounterService : public KeyedService,
 
   void MaybePrefetchNewTabPageAd();
 
+  // Starts reading the images that the next new tabs are going to show.
+  void PrefetchWallpaperImages();
+
   void UpdateP3AValues() const;
 
   raw_ptr<NTPBackgroundImagesService> service_ = nullptr;
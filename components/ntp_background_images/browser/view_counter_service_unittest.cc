@@ -249,7 +249,8 @@ class NTPBackgroundImagesViewCounterTest : public testing::Test {
   }
 
  protected:
-  base::test::SingleThreadTaskEnvironment task_environment;
+  // Page views prefetch the images on the thread pool.
+  base::test::TaskEnvironment task_environment;
   TestingPrefServiceSimple local_pref_;
   sync_preferences::TestingPrefServiceSyncable prefs_;
   std::unique_ptr<ViewCounterService> view_counter_;
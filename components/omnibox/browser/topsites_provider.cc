@@ -10,6 +10,8 @@
 #include <algorithm>
 #include <string>
 
+#include "base/check.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/components/omnibox/browser/brave_omnibox_prefs.h"
@@ -17,6 +19,14 @@
 #include "components/omnibox/browser/history_provider.h"
 #include "components/prefs/pref_service.h"
 
+namespace {
+
+// Longest substrings of the top sites that are indexed. Longer inputs are
+// looked up by their least common substring of that length.
+constexpr size_t kMaxNgramLength = 3;
+
+}  // namespace
+
 // As from autocomplete_provider.h:
 // Search Secondary Provider (suggestion)                              |  100++
 const int TopSitesProvider::kRelevance = 100;
@@ -24,6 +34,55 @@ const int TopSitesProvider::kRelevance = 100;
 
 TopSitesProvider::TopSitesProvider(AutocompleteProviderClient* client)
     : AutocompleteProvider(AutocompleteProvider::TYPE_SEARCH), client_(client) {
+  // Build the index shared by all providers ahead of the first keystroke.
+  GetNgramIndex();
+}
+
+// static
+const TopSitesProvider::NgramIndex& TopSitesProvider::GetNgramIndex() {
+  static const base::NoDestructor<NgramIndex> index([] {
+    NgramIndex index;
+    for (size_t i = 0; i < top_sites_.size(); ++i) {
+      const std::string& site = top_sites_[i];
+      index[std::string()].push_back(i);
+      for (size_t pos = 0; pos < site.length(); ++pos) {
+        for (size_t length = 1;
+             length <= kMaxNgramLength && pos + length <= site.length();
+             ++length) {
+          std::vector<size_t>& positions = index[site.substr(pos, length)];
+          // A site may contain the same substring more than once.
+          if (positions.empty() || positions.back() != i) {
+            positions.push_back(i);
+          }
+        }
+      }
+    }
+    return index;
+  }());
+  return *index;
+}
+
+// static
+const std::vector<size_t>& TopSitesProvider::GetCandidates(
+    const std::string& input_text) {
+  static const base::NoDestructor<std::vector<size_t>> kNoCandidates;
+
+  const NgramIndex& index = GetNgramIndex();
+  const std::vector<size_t>* candidates = nullptr;
+  const size_t length = std::min(input_text.length(), kMaxNgramLength);
+  for (size_t pos = 0; pos + length <= input_text.length(); ++pos) {
+    const auto iter = index.find(input_text.substr(pos, length));
+    if (iter == index.end()) {
+      return *kNoCandidates;
+    }
+
+    if (!candidates || iter->second.size() < candidates->size()) {
+      candidates = &iter->second;
+    }
+  }
+
+  DCHECK(candidates);
+  return *candidates;
 }
 
 void TopSitesProvider::Start(const AutocompleteInput& input,
@@ -42,10 +101,14 @@ void TopSitesProvider::Start(const AutocompleteInput& input,
   const std::string input_text =
       base::ToLowerASCII(base::UTF16ToUTF8(input.text()));
 
-  for (std::vector<std::string>::const_iterator i = top_sites_.begin();
-       (i != top_sites_.end()) && (matches_.size() < provider_max_matches());
-       ++i) {
-    const std::string &current_site = *i;
+  // Candidates are in the same order as |top_sites_|, so the matches are the
+  // same as when scanning all of them.
+  for (size_t index : GetCandidates(input_text)) {
+    if (matches_.size() >= provider_max_matches()) {
+      break;
+    }
+
+    const std::string &current_site = top_sites_[index];
     size_t foundPos = current_site.find(input_text);
     if (std::string::npos != foundPos) {
       ACMatchClassifications styles =
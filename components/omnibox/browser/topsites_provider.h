@@ -7,9 +7,11 @@
 #define BRAVE_COMPONENTS_OMNIBOX_BROWSER_TOPSITES_PROVIDER_H_
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/gtest_prod_util.h"
 #include "base/memory/raw_ptr.h"
 #include "components/omnibox/browser/autocomplete_match.h"
 #include "components/omnibox/browser/autocomplete_provider.h"
@@ -33,6 +35,19 @@ class TopSitesProvider : public AutocompleteProvider {
 
   static std::vector<std::string> top_sites_;
 
+  // Maps every substring of the top sites of up to |kMaxNgramLength|
+  // characters, including the empty one, to the positions of the sites that
+  // contain it in ascending order.
+  using NgramIndex = std::unordered_map<std::string, std::vector<size_t>>;
+
+  static const NgramIndex& GetNgramIndex();
+
+  // Returns the positions of the sites that may contain |input_text|, in
+  // ascending order. Sites are only guaranteed to contain it if it is no longer
+  // than |kMaxNgramLength|.
+  static const std::vector<size_t>& GetCandidates(
+      const std::string& input_text);
+
   void AddMatch(const std::u16string& match_string,
                 const ACMatchClassifications& styles);
 
@@ -42,6 +57,8 @@ class TopSitesProvider : public AutocompleteProvider {
       const size_t &foundPos);
 
   raw_ptr<AutocompleteProviderClient> client_ = nullptr;
+
+  FRIEND_TEST_ALL_PREFIXES(TopSitesProviderTest, MatchesScan);
 };
 
 #endif  // BRAVE_COMPONENTS_OMNIBOX_BROWSER_TOPSITES_PROVIDER_H_
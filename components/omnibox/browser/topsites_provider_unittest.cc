@@ -5,6 +5,9 @@
 
 #include "brave/components/omnibox/browser/topsites_provider.h"
 
+#include <string>
+#include <vector>
+
 #include "base/strings/utf_string_conversions.h"
 #include "brave/components/omnibox/browser/brave_fake_autocomplete_provider_client.h"
 #include "brave/components/omnibox/browser/brave_omnibox_prefs.h"
@@ -56,3 +59,34 @@ TEST_F(TopSitesProviderTest, NoMatchingWhenPrefIsOff) {
   provider_->Start(CreateAutocompleteInput("dex"), false);
   EXPECT_TRUE(provider_->matches().empty());
 }
+
+// Checks that the matches found through the index are the ones, in the same
+// order, that scanning every site finds.
+TEST_F(TopSitesProviderTest, MatchesScan) {
+  const std::vector<std::string> inputs = {
+      "a",    "g",    "go",    "goo",  "goog",     "google.", "mail.google",
+      ".co",  ".com", "ooo",   "le.co", "wiki",    "pedia",   "o",
+      "m.cn", "zz",   "zzzzz", "tube", "amazon.c", "bay"};
+
+  for (const auto& input : inputs) {
+    SCOPED_TRACE(input);
+
+    std::vector<std::u16string> expected;
+    for (const auto& site : TopSitesProvider::top_sites_) {
+      if (expected.size() >= provider_->provider_max_matches()) {
+        break;
+      }
+      if (site.find(input) != std::string::npos) {
+        expected.push_back(base::ASCIIToUTF16(site));
+      }
+    }
+
+    provider_->Start(CreateAutocompleteInput(input), false);
+
+    std::vector<std::u16string> contents;
+    for (const auto& match : provider_->matches()) {
+      contents.push_back(match.contents);
+    }
+    EXPECT_EQ(expected, contents);
+  }
+}
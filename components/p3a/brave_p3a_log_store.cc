@@ -78,19 +78,33 @@ void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
 
 void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
                                    uint64_t value) {
-  LogEntry& entry = log_[histogram_name];
-  entry.value = value;
+  UpdateValues({{histogram_name, value}});
+}
 
-  if (!entry.sent) {
-    DCHECK(entry.sent_timestamp.is_null());
-    unsent_entries_.insert(histogram_name);
-  }
+void BraveP3ALogStore::UpdateValues(
+    const base::flat_map<std::string, uint64_t>& values) {
+  absl::optional<DictionaryPrefUpdate> update;
+  for (const auto& [histogram_name, value] : values) {
+    auto it = log_.find(histogram_name);
+    // Hot metrics mostly report the bucket they are already in.
+    if (it != log_.end() && it->second.value == value)
+      continue;
 
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, GetPrefName(type_));
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+    LogEntry& entry = log_[histogram_name];
+    entry.value = value;
+
+    if (!entry.sent) {
+      DCHECK(entry.sent_timestamp.is_null());
+      unsent_entries_.insert(histogram_name);
+    }
+
+    // Update the persistent value.
+    if (!update)
+      update.emplace(local_state_, GetPrefName(type_));
+    (*update)->SetPath({histogram_name, kLogValueKey},
+                       base::Value(base::NumberToString(value)));
+    (*update)->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  }
 }
 
 void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
@@ -5,6 +5,7 @@
 
 #include "brave/components/p3a/brave_p3a_service.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -13,9 +14,9 @@
 #include "base/command_line.h"
 #include "base/i18n/timezone.h"
 #include "base/json/json_writer.h"
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/histogram.h"
 #include "base/metrics/histogram_macros.h"
-#include "base/metrics/histogram_samples.h"
-#include "base/metrics/sample_vector.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/no_destructor.h"
 #include "base/notreached.h"
@@ -77,11 +78,42 @@ constexpr uint64_t kDefaultUploadIntervalSeconds = 60;  // 1 minute.
 
 constexpr base::TimeDelta kPostRotationUploadDelay = base::Seconds(30);
 
+// Samples of the same metric recorded within this interval only update the
+// log stores once.
+constexpr base::TimeDelta kHistogramFlushDelay = base::Seconds(1);
+
 bool IsSuspendedMetric(base::StringPiece metric_name,
                        uint64_t value_or_bucket) {
   return value_or_bucket == kSuspendedMetricBucket;
 }
 
+// Finds the bucket |sample| was counted in, the same way
+// |base::SampleVector| does. Returns nullptr for histograms without bucket
+// ranges (i.e. sparse ones).
+const base::BucketRanges* GetBucketForSample(base::HistogramBase* histogram,
+                                             base::HistogramBase::Sample sample,
+                                             size_t* bucket) {
+  const auto type = histogram->GetHistogramType();
+  if (type == base::SPARSE_HISTOGRAM || type == base::DUMMY_HISTOGRAM)
+    return nullptr;
+  const base::BucketRanges* ranges =
+      static_cast<base::Histogram*>(histogram)->bucket_ranges();
+  const size_t bucket_count = ranges->bucket_count();
+  sample = std::clamp(sample, ranges->range(0),
+                      ranges->range(bucket_count) - 1);
+  size_t under = 0;
+  size_t over = bucket_count;
+  while (over - under > 1) {
+    const size_t mid = under + (over - under) / 2;
+    if (ranges->range(mid) <= sample)
+      under = mid;
+    else
+      over = mid;
+  }
+  *bucket = under;
+  return ranges;
+}
+
 base::TimeDelta GetRandomizedUploadInterval(
     base::TimeDelta average_upload_interval) {
   const auto delta = base::Seconds(
@@ -314,9 +346,7 @@ void BraveP3AService::Init(
   }
 
   // Store values that were recorded between calling constructor and |Init()|.
-  for (const auto& entry : histogram_values_) {
-    HandleHistogramChange(std::string(entry.first), entry.second);
-  }
+  HandleHistogramChanges(histogram_values_);
   histogram_values_ = {};
 }
 
@@ -475,81 +505,106 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
                                          base::HistogramBase::Sample sample) {
   DCHECK(histogram_name != nullptr);
 
-  std::unique_ptr<base::HistogramSamples> samples =
-      base::StatisticsRecorder::FindHistogram(histogram_name)->SnapshotDelta();
-
-  // Stop now if there's nothing to do.
-  if (samples->Iterator()->Done())
-    return;
+  base::AutoLock lock(pending_histogram_lock_);
+  auto it = histograms_.find(base::StringPiece(histogram_name));
+  if (it == histograms_.end()) {
+    base::HistogramBase* histogram =
+        base::StatisticsRecorder::FindHistogram(histogram_name);
+    if (!histogram)
+      return;
+    it = histograms_.emplace(histogram_name, histogram).first;
+  }
+  base::HistogramBase* histogram = it->second;
 
+  size_t bucket = 0u;
   // Shortcut for the special values, see |kSuspendedMetricValue|
   // description for details.
   if (IsSuspendedMetric(histogram_name, sample)) {
-    GetUIThreadTaskRunner()->PostTask(
-        FROM_HERE, base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI,
-                                  this, histogram_name, kSuspendedMetricValue,
-                                  kSuspendedMetricBucket));
-    return;
-  }
+    bucket = kSuspendedMetricBucket;
+  } else {
+    // Note that we store only buckets, not actual values.
+    const base::BucketRanges* ranges =
+        GetBucketForSample(histogram, sample, &bucket);
+    if (!ranges) {
+      LOG(ERROR) << "Only linear histograms are supported at the moment!";
+      NOTREACHED();
+      return;
+    }
 
-  // Note that we store only buckets, not actual values.
-  size_t bucket = 0u;
-  const bool ok = samples->Iterator()->GetBucketIndex(&bucket);
-  if (!ok) {
-    LOG(ERROR) << "Only linear histograms are supported at the moment!";
-    NOTREACHED();
-    return;
+    // Special handling of P2A histograms.
+    if (base::StartsWith(histogram_name, "Brave.P2A.",
+                         base::CompareCase::SENSITIVE)) {
+      // We need the bucket count to make proper perturbation.
+      // All P2A metrics should be implemented as linear histograms.
+      const size_t bucket_count = ranges->bucket_count() - 1;
+      VLOG(2) << "P2A metric " << histogram_name << " has bucket count "
+              << bucket_count;
+
+      // Perturb the bucket.
+      bucket = DirectEncodingProtocol::Perturb(bucket_count, bucket);
+    }
   }
 
-  // Special handling of P2A histograms.
-  if (base::StartsWith(histogram_name, "Brave.P2A.",
-                       base::CompareCase::SENSITIVE)) {
-    // We need the bucket count to make proper perturbation.
-    // All P2A metrics should be implemented as linear histograms.
-    base::SampleVector* vector =
-        static_cast<base::SampleVector*>(samples.get());
-    DCHECK(vector);
-    const size_t bucket_count = vector->bucket_ranges()->bucket_count() - 1;
-    VLOG(2) << "P2A metric " << histogram_name << " has bucket count "
-            << bucket_count;
-
-    // Perturb the bucket.
-    bucket = DirectEncodingProtocol::Perturb(bucket_count, bucket);
-  }
+  VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
+          << histogram_name << " Sample = " << sample << " bucket = " << bucket;
+  pending_histogram_values_[histogram->histogram_name()] = bucket;
+  if (histogram_flush_scheduled_)
+    return;
+  histogram_flush_scheduled_ = true;
+  GetUIThreadTaskRunner()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&BraveP3AService::FlushPendingHistogramValues, this),
+      kHistogramFlushDelay);
+}
 
-  GetUIThreadTaskRunner()->PostTask(
-      FROM_HERE, base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI, this,
-                                histogram_name, sample, bucket));
+void BraveP3AService::OnShutdown() {
+  // The delayed flush, if any, finds nothing left to do.
+  FlushPendingHistogramValues();
 }
 
-void BraveP3AService::OnHistogramChangedOnUI(const char* histogram_name,
-                                             base::HistogramBase::Sample sample,
-                                             size_t bucket) {
-  VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
-          << histogram_name << " Sample = " << sample << " bucket = " << bucket;
+void BraveP3AService::FlushPendingHistogramValues() {
+  DCheckCurrentlyOnUIThread();
+  base::flat_map<base::StringPiece, size_t> buckets;
+  {
+    base::AutoLock lock(pending_histogram_lock_);
+    buckets.swap(pending_histogram_values_);
+    histogram_flush_scheduled_ = false;
+  }
+
   if (!initialized_) {
     // Will handle it later when ready.
-    histogram_values_[histogram_name] = bucket;
-  } else {
-    HandleHistogramChange(histogram_name, bucket);
+    for (const auto& [histogram_name, bucket] : buckets)
+      histogram_values_[histogram_name] = bucket;
+    return;
   }
+  HandleHistogramChanges(buckets);
 }
 
-void BraveP3AService::HandleHistogramChange(base::StringPiece histogram_name,
-                                            size_t bucket) {
-  BraveP3ALogStore* log_store = log_stores_[MetricLogType::kTypical].get();
-  std::string histogram_name_str = std::string(histogram_name);
-  if (p3a::kCollectedExpressHistograms.contains(histogram_name) ||
-      (dynamic_metric_log_types_.contains(histogram_name_str) &&
-       dynamic_metric_log_types_[histogram_name_str] ==
-           MetricLogType::kExpress)) {
-    log_store = log_stores_[MetricLogType::kExpress].get();
-  }
-  if (IsSuspendedMetric(histogram_name, bucket)) {
-    log_store->RemoveValueIfExists(std::string(histogram_name));
-    return;
+void BraveP3AService::HandleHistogramChanges(
+    const base::flat_map<base::StringPiece, size_t>& buckets) {
+  base::flat_map<MetricLogType, base::flat_map<std::string, uint64_t>> updates;
+  for (const auto& [histogram_name, bucket] : buckets) {
+    // Dynamic metrics may have been removed since the sample was recorded.
+    if (!IsActualMetric(histogram_name))
+      continue;
+
+    MetricLogType log_type = MetricLogType::kTypical;
+    std::string histogram_name_str = std::string(histogram_name);
+    if (p3a::kCollectedExpressHistograms.contains(histogram_name) ||
+        (dynamic_metric_log_types_.contains(histogram_name_str) &&
+         dynamic_metric_log_types_[histogram_name_str] ==
+             MetricLogType::kExpress)) {
+      log_type = MetricLogType::kExpress;
+    }
+    if (IsSuspendedMetric(histogram_name, bucket)) {
+      log_stores_[log_type]->RemoveValueIfExists(histogram_name_str);
+      continue;
+    }
+    updates[log_type][std::move(histogram_name_str)] = bucket;
   }
-  log_store->UpdateValue(std::string(histogram_name), bucket);
+
+  for (const auto& [log_type, values] : updates)
+    log_stores_[log_type]->UpdateValues(values);
 }
 
 void BraveP3AService::OnLogUploadComplete(int response_code,
@@ -6,6 +6,7 @@
 #ifndef BRAVE_COMPONENTS_P3A_BRAVE_P3A_SERVICE_H_
 #define BRAVE_COMPONENTS_P3A_BRAVE_P3A_SERVICE_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,7 +16,9 @@
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram_base.h"
 #include "base/metrics/statistics_recorder.h"
-#include "base/strings/string_piece_forward.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 #include "base/timer/wall_clock_timer.h"
 #include "brave/components/p3a/brave_p3a_log_store.h"
 #include "brave/components/p3a/metric_log_type.h"
@@ -84,8 +87,13 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // May be accessed from multiple threads, so this is thread-safe.
   bool IsActualMetric(base::StringPiece histogram_name) const override;
 
+  // Hands the pending samples to the log stores right away, so they are not
+  // lost with the delayed flush when the browser shuts down.
+  void OnShutdown();
+
   // Invoked by callbacks registered by our service. Since these callbacks
-  // can fire on any thread, this method reposts everything to UI thread.
+  // can fire on any thread, this method only remembers the latest bucket of
+  // the metric and schedules a batched flush on the UI thread.
   void OnHistogramChanged(const char* histogram_name,
                           uint64_t name_hash,
                           base::HistogramBase::Sample sample);
@@ -105,12 +113,12 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
 
   void StartScheduledUpload(MetricLogType log_type);
 
-  void OnHistogramChangedOnUI(const char* histogram_name,
-                              base::HistogramBase::Sample sample,
-                              size_t bucket);
+  // Hands the buckets coalesced by |OnHistogramChanged| to the log stores.
+  void FlushPendingHistogramValues();
 
-  // Updates or removes a metric from the log.
-  void HandleHistogramChange(base::StringPiece histogram_name, size_t bucket);
+  // Updates or removes metrics from the logs.
+  void HandleHistogramChanges(
+      const base::flat_map<base::StringPiece, size_t>& buckets);
 
   void OnLogUploadComplete(int response_code,
                            int error_code,
@@ -166,6 +174,18 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
       std::unique_ptr<base::StatisticsRecorder::ScopedHistogramSampleObserver>>
       histogram_sample_callbacks_;
 
+  // Samples can be recorded on any thread, these are shared with the UI
+  // thread flush.
+  base::Lock pending_histogram_lock_;
+  // Avoids going through StatisticsRecorder for every sample.
+  base::flat_map<std::string, base::HistogramBase*, std::less<>> histograms_
+      GUARDED_BY(pending_histogram_lock_);
+  // Latest bucket of every metric that changed since the last flush, keyed by
+  // the histogram's own name.
+  base::flat_map<base::StringPiece, size_t> pending_histogram_values_
+      GUARDED_BY(pending_histogram_lock_);
+  bool histogram_flush_scheduled_ GUARDED_BY(pending_histogram_lock_) = false;
+
   // Contains callbacks registered via `RegisterRotationCallback`
   base::RepeatingCallbackList<void(bool is_express)> rotation_callbacks_;
   // Contains callbacks registered via `RegisterMetricSentCallback`
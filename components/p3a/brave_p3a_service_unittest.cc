@@ -284,4 +284,43 @@ TEST_F(P3AServiceTest, ShouldNotSendIfDisabled) {
   EXPECT_EQ(p3a_creative_sent_metrics_.size(), 0U);
 }
 
+TEST_F(P3AServiceTest, CoalescesHistogramSamples) {
+  const std::string histogram_name = GetTestHistogramNames(1, 0)[0];
+
+  for (int i = 1; i <= 5; i++) {
+    base::UmaHistogramExactLinear(histogram_name, i, 8);
+    p3a_service_->OnHistogramChanged(histogram_name.c_str(), 0, i);
+  }
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(local_state_.GetDict("p3a.logs").FindDict(histogram_name));
+
+  // Only the latest bucket makes it to the log store.
+  task_environment_.FastForwardBy(base::Seconds(1));
+  const base::Value::Dict* entry =
+      local_state_.GetDict("p3a.logs").FindDict(histogram_name);
+  ASSERT_TRUE(entry);
+  ASSERT_TRUE(entry->FindString("value"));
+  EXPECT_EQ("5", *entry->FindString("value"));
+}
+
+TEST_F(P3AServiceTest, FlushesHistogramSamplesOnShutdown) {
+  const std::string histogram_name = GetTestHistogramNames(1, 0)[0];
+
+  base::UmaHistogramExactLinear(histogram_name, 3, 8);
+  p3a_service_->OnHistogramChanged(histogram_name.c_str(), 0, 3);
+  p3a_service_->OnShutdown();
+
+  // No need to wait for the delayed flush.
+  const base::Value::Dict* entry =
+      local_state_.GetDict("p3a.logs").FindDict(histogram_name);
+  ASSERT_TRUE(entry);
+  ASSERT_TRUE(entry->FindString("value"));
+  EXPECT_EQ("3", *entry->FindString("value"));
+
+  task_environment_.FastForwardBy(base::Seconds(1));
+  EXPECT_EQ("3", *local_state_.GetDict("p3a.logs")
+                      .FindDict(histogram_name)
+                      ->FindString("value"));
+}
+
 }  // namespace brave
@@ -12,4 +12,7 @@ namespace playlist::features {
 
 BASE_FEATURE(kPlaylist, "Playlist", base::FEATURE_DISABLED_BY_DEFAULT);
 
+const base::FeatureParam<int> kMaxConcurrentMediaFileDownloads{
+    &kPlaylist, "max_concurrent_media_file_downloads", 3};
+
 }  // namespace playlist::features
@@ -7,11 +7,15 @@
 #define BRAVE_COMPONENTS_PLAYLIST_FEATURES_H_
 
 #include "base/feature_list.h"
+#include "base/metrics/field_trial_params.h"
 
 namespace playlist::features {
 
 BASE_DECLARE_FEATURE(kPlaylist);
 
+// The number of playlist items whose media files are downloaded at once.
+extern const base::FeatureParam<int> kMaxConcurrentMediaFileDownloads;
+
 }  // namespace playlist::features
 
 #endif  // BRAVE_COMPONENTS_PLAYLIST_FEATURES_H_
@@ -5,24 +5,41 @@
 
 #include "brave/components/playlist/playlist_media_file_download_manager.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/ranges/algorithm.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "base/values.h"
+#include "brave/components/playlist/features.h"
 #include "brave/components/playlist/playlist_constants.h"
 
 namespace playlist {
 
+namespace {
+
+// Each downloader keeps its own download manager, so don't let the feature
+// param create an unbounded number of them.
+constexpr int kMaxMediaFileDownloaders = 8;
+
+}  // namespace
+
 PlaylistMediaFileDownloadManager::PlaylistMediaFileDownloadManager(
     content::BrowserContext* context,
     Delegate* delegate,
     const base::FilePath& base_dir)
     : base_dir_(base_dir), delegate_(delegate) {
-  // TODO(pilgrim) dynamically set file extensions based on format.
-  media_file_downloader_ = std::make_unique<PlaylistMediaFileDownloader>(
-      this, context, kMediaFileName);
+  const int downloader_count =
+      std::clamp(features::kMaxConcurrentMediaFileDownloads.Get(), 1,
+                 kMaxMediaFileDownloaders);
+  for (int i = 0; i < downloader_count; ++i) {
+    // TODO(pilgrim) dynamically set file extensions based on format.
+    media_file_downloaders_.push_back(
+        std::make_unique<PlaylistMediaFileDownloader>(this, context,
+                                                      kMediaFileName));
+  }
 }
 
 PlaylistMediaFileDownloadManager::~PlaylistMediaFileDownloadManager() = default;
@@ -31,46 +48,61 @@ void PlaylistMediaFileDownloadManager::DownloadMediaFile(
     const PlaylistItemInfo& playlist_item) {
   pending_media_file_creation_jobs_.push(playlist_item);
 
-  // If either media file controller is generating a playlist media file,
-  // delay the next playlist generation. It will be triggered when the current
-  // one is finished.
-  if (!IsCurrentDownloadingInProgress())
-    TryStartingDownloadTask();
+  // If all downloaders are busy, the next download is triggered when one of
+  // them is finished.
+  TryStartingDownloadTask();
 }
 
 void PlaylistMediaFileDownloadManager::CancelDownloadRequest(
     const std::string& id) {
   VLOG(2) << __func__ << " " << id;
 
-  // Cancel if currently downloading item is id.
+  // Cancel if the item is being downloaded.
   // Otherwise, GetNextPlaylistItemTarget() will drop canceled one.
-  if (GetCurrentDownloadingPlaylistItemID() == id) {
-    CancelCurrentDownloadingPlaylistItem();
+  if (auto* downloader = GetDownloaderForItem(id)) {
+    downloader->RequestCancelCurrentPlaylistGeneration();
+    download_progress_.erase(id);
     TryStartingDownloadTask();
-    return;
   }
 }
 
 void PlaylistMediaFileDownloadManager::CancelAllDownloadRequests() {
-  CancelCurrentDownloadingPlaylistItem();
+  for (auto& downloader : media_file_downloaders_)
+    downloader->RequestCancelCurrentPlaylistGeneration();
   pending_media_file_creation_jobs_ = {};
+  download_progress_.clear();
 }
 
-void PlaylistMediaFileDownloadManager::TryStartingDownloadTask() {
-  if (IsCurrentDownloadingInProgress())
-    return;
+PlaylistMediaFileDownloadManager::DownloadProgress
+PlaylistMediaFileDownloadManager::GetDownloadProgress() const {
+  DownloadProgress total;
+  for (const auto& [id, progress] : download_progress_) {
+    total.total_bytes += progress.total_bytes;
+    total.received_bytes += progress.received_bytes;
+  }
+  return total;
+}
 
-  if (pending_media_file_creation_jobs_.empty())
-    return;
+size_t PlaylistMediaFileDownloadManager::GetInProgressDownloadCount() const {
+  return base::ranges::count_if(
+      media_file_downloaders_,
+      [](const auto& downloader) { return downloader->in_progress(); });
+}
 
-  current_item_ = GetNextPlaylistItemTarget();
-  if (!current_item_)
-    return;
+void PlaylistMediaFileDownloadManager::TryStartingDownloadTask() {
+  while (!pending_media_file_creation_jobs_.empty()) {
+    auto* downloader = GetIdleDownloader();
+    if (!downloader)
+      return;
 
-  VLOG(2) << __func__ << ": " << current_item_->title;
+    auto item = GetNextPlaylistItemTarget();
+    if (!item)
+      return;
 
-  media_file_downloader_->DownloadMediaFileForPlaylistItem(*current_item_,
-                                                           base_dir_);
+    VLOG(2) << __func__ << ": " << item->title;
+
+    downloader->DownloadMediaFileForPlaylistItem(*item, base_dir_);
+  }
 }
 
 std::unique_ptr<PlaylistItemInfo>
@@ -86,20 +118,29 @@ PlaylistMediaFileDownloadManager::GetNextPlaylistItemTarget() {
   return nullptr;
 }
 
-std::string
-PlaylistMediaFileDownloadManager::GetCurrentDownloadingPlaylistItemID() const {
-  if (IsCurrentDownloadingInProgress())
-    return media_file_downloader_->current_playlist_id();
-
-  return {};
+PlaylistMediaFileDownloader*
+PlaylistMediaFileDownloadManager::GetIdleDownloader() {
+  auto iter = base::ranges::find_if(
+      media_file_downloaders_,
+      [](const auto& downloader) { return !downloader->in_progress(); });
+  return iter == media_file_downloaders_.end() ? nullptr : iter->get();
 }
 
-void PlaylistMediaFileDownloadManager::CancelCurrentDownloadingPlaylistItem() {
-  media_file_downloader_->RequestCancelCurrentPlaylistGeneration();
+PlaylistMediaFileDownloader*
+PlaylistMediaFileDownloadManager::GetDownloaderForItem(const std::string& id) {
+  auto iter = base::ranges::find_if(
+      media_file_downloaders_, [&id](const auto& downloader) {
+        return downloader->in_progress() &&
+               downloader->current_playlist_id() == id;
+      });
+  return iter == media_file_downloaders_.end() ? nullptr : iter->get();
 }
 
-bool PlaylistMediaFileDownloadManager::IsCurrentDownloadingInProgress() const {
-  return media_file_downloader_->in_progress();
+void PlaylistMediaFileDownloadManager::ScheduleToStartDownloadTask() {
+  base::SequencedTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&PlaylistMediaFileDownloadManager::TryStartingDownloadTask,
+                     weak_factory_.GetWeakPtr()));
 }
 
 void PlaylistMediaFileDownloadManager::OnMediaFileDownloadProgressed(
@@ -108,6 +149,7 @@ void PlaylistMediaFileDownloadManager::OnMediaFileDownloadProgressed(
     int64_t received_bytes,
     int percent_complete,
     base::TimeDelta time_remaining) {
+  download_progress_[id] = {total_bytes, received_bytes};
   delegate_->OnMediaFileDownloadProgressed(id, total_bytes, received_bytes,
                                            percent_complete, time_remaining);
 }
@@ -117,28 +159,21 @@ void PlaylistMediaFileDownloadManager::OnMediaFileReady(
     const std::string& media_file_path) {
   VLOG(2) << __func__ << ": " << id << " is ready.";
 
+  download_progress_.erase(id);
   delegate_->OnMediaFileReady(id, media_file_path);
 
-  current_item_.reset();
-
-  base::SequencedTaskRunnerHandle::Get()->PostTask(
-      FROM_HERE,
-      base::BindOnce(&PlaylistMediaFileDownloadManager::TryStartingDownloadTask,
-                     weak_factory_.GetWeakPtr()));
+  ScheduleToStartDownloadTask();
 }
 
 void PlaylistMediaFileDownloadManager::OnMediaFileGenerationFailed(
     const std::string& id) {
   VLOG(2) << __func__ << ": " << id;
 
+  download_progress_.erase(id);
   delegate_->OnMediaFileGenerationFailed(id);
 
-  CancelCurrentDownloadingPlaylistItem();
-
-  base::SequencedTaskRunnerHandle::Get()->PostTask(
-      FROM_HERE,
-      base::BindOnce(&PlaylistMediaFileDownloadManager::TryStartingDownloadTask,
-                     weak_factory_.GetWeakPtr()));
+  // The downloader resets itself once this returns.
+  ScheduleToStartDownloadTask();
 }
 
 }  // namespace playlist
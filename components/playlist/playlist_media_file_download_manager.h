@@ -8,7 +8,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/containers/queue.h"
 #include "brave/components/playlist/playlist_media_file_downloader.h"
 
@@ -23,9 +25,9 @@ class BrowserContext;
 namespace playlist {
 
 // Download youtube playlist item's audio/video media files.
-// This handles one request at once. So, it has pending queue.
-// And PlaylistMediaFileDownloader does file download task.
-// TODO(simonhong): Download multiple media files simultaneously.
+// Up to features::kMaxConcurrentMediaFileDownloads items are downloaded at
+// once, each by its own PlaylistMediaFileDownloader. Other requests wait in the
+// pending queue.
 class PlaylistMediaFileDownloadManager
     : public PlaylistMediaFileDownloader::Delegate {
  public:
@@ -46,6 +48,12 @@ class PlaylistMediaFileDownloadManager
     virtual ~Delegate() {}
   };
 
+  // Sum of all in progress downloads.
+  struct DownloadProgress {
+    int64_t total_bytes = 0;
+    int64_t received_bytes = 0;
+  };
+
   static constexpr base::FilePath::CharType kMediaFileName[] =
       FILE_PATH_LITERAL("media_file.mp4");
 
@@ -63,6 +71,9 @@ class PlaylistMediaFileDownloadManager
   void CancelDownloadRequest(const std::string& id);
   void CancelAllDownloadRequests();
 
+  DownloadProgress GetDownloadProgress() const;
+  size_t GetInProgressDownloadCount() const;
+
  private:
   // PlaylistMediaFileDownloader::Delegate overrides:
   void OnMediaFileDownloadProgressed(const std::string& id,
@@ -76,17 +87,19 @@ class PlaylistMediaFileDownloadManager
 
   void TryStartingDownloadTask();
   std::unique_ptr<PlaylistItemInfo> GetNextPlaylistItemTarget();
-  std::string GetCurrentDownloadingPlaylistItemID() const;
-  void CancelCurrentDownloadingPlaylistItem();
-  bool IsCurrentDownloadingInProgress() const;
+  PlaylistMediaFileDownloader* GetIdleDownloader();
+  PlaylistMediaFileDownloader* GetDownloaderForItem(const std::string& id);
+  void ScheduleToStartDownloadTask();
 
   const base::FilePath base_dir_;
   raw_ptr<Delegate> delegate_;
   base::queue<PlaylistItemInfo> pending_media_file_creation_jobs_;
 
-  std::unique_ptr<PlaylistItemInfo> current_item_;
+  std::vector<std::unique_ptr<PlaylistMediaFileDownloader>>
+      media_file_downloaders_;
 
-  std::unique_ptr<PlaylistMediaFileDownloader> media_file_downloader_;
+  // Latest progress of each in progress item.
+  base::flat_map<std::string, DownloadProgress> download_progress_;
 
   base::WeakPtrFactory<PlaylistMediaFileDownloadManager> weak_factory_{this};
 };
@@ -17,6 +17,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/task_runner_util.h"
 #include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "brave/components/playlist/playlist_constants.h"
 #include "brave/components/playlist/playlist_types.h"
 #include "build/build_config.h"
@@ -50,6 +51,72 @@ net::NetworkTrafficAnnotationTag GetNetworkTrafficAnnotationTagForURLLoad() {
       })");
 }
 
+constexpr char kResumeStateURLKey[] = "url";
+constexpr char kResumeStateETagKey[] = "etag";
+constexpr char kResumeStateLastModifiedKey[] = "last_modified";
+
+constexpr int kMaxResumeAttempts = 3;
+constexpr base::TimeDelta kResumeRetryDelay = base::Seconds(1);
+
+// Interruptions that leave a partial file a range request can continue.
+bool IsResumableInterruptReason(download::DownloadInterruptReason reason) {
+  switch (reason) {
+    case download::DOWNLOAD_INTERRUPT_REASON_NETWORK_FAILED:
+    case download::DOWNLOAD_INTERRUPT_REASON_NETWORK_TIMEOUT:
+    case download::DOWNLOAD_INTERRUPT_REASON_NETWORK_DISCONNECTED:
+    case download::DOWNLOAD_INTERRUPT_REASON_SERVER_FAILED:
+    case download::DOWNLOAD_INTERRUPT_REASON_SERVER_CONTENT_LENGTH_MISMATCH:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The validators of a partial media file are kept next to it, so that a
+// download started in a later session can continue it.
+base::FilePath GetResumeStatePath(const base::FilePath& media_file_path) {
+  return media_file_path.AddExtensionASCII("resume");
+}
+
+absl::optional<PlaylistMediaFileDownloader::ResumeState> ReadResumeState(
+    const base::FilePath& media_file_path,
+    const GURL& url) {
+  const base::FilePath state_path = GetResumeStatePath(media_file_path);
+  std::string contents;
+  if (!base::ReadFileToString(state_path, &contents))
+    return absl::nullopt;
+
+  absl::optional<PlaylistMediaFileDownloader::ResumeState> state;
+  auto value = base::JSONReader::Read(contents);
+  int64_t offset = 0;
+  if (value && value->is_dict() &&
+      base::GetFileSize(media_file_path, &offset) && offset > 0) {
+    const auto& dict = value->GetDict();
+    const auto* state_url = dict.FindString(kResumeStateURLKey);
+    const auto* etag = dict.FindString(kResumeStateETagKey);
+    const auto* last_modified = dict.FindString(kResumeStateLastModifiedKey);
+    if (state_url && *state_url == url.spec() && etag && last_modified &&
+        (!etag->empty() || !last_modified->empty())) {
+      state = PlaylistMediaFileDownloader::ResumeState{*etag, *last_modified,
+                                                       offset};
+    }
+  }
+
+  if (!state)
+    base::DeleteFile(state_path);
+  return state;
+}
+
+void WriteResumeState(const base::FilePath& media_file_path,
+                      const std::string& contents) {
+  if (!base::WriteFile(GetResumeStatePath(media_file_path), contents))
+    VLOG(2) << __func__ << ": failed to write resume state";
+}
+
+void DeleteResumeState(const base::FilePath& media_file_path) {
+  base::DeleteFile(GetResumeStatePath(media_file_path));
+}
+
 }  // namespace
 
 PlaylistMediaFileDownloader::PlaylistMediaFileDownloader(
@@ -63,13 +130,31 @@ PlaylistMediaFileDownloader::PlaylistMediaFileDownloader(
       media_file_name_(media_file_name) {}
 
 PlaylistMediaFileDownloader::~PlaylistMediaFileDownloader() {
-  ResetDownloadStatus();
-
   if (download_manager_) {
     for (auto& download : download_manager_->TakeInProgressDownloads()) {
       DCHECK(download_item_observation_.IsObservingSource(download.get()));
       download_items_to_be_detached_.push_back(std::move(download));
     }
+  }
+
+  // A download that is still running is interrupted the way the download
+  // system does on shutdown, which keeps the partial file so that the item is
+  // resumed the next time it's downloaded.
+  if (current_item_ && !has_resume_state_) {
+    for (auto& download : download_items_to_be_detached_) {
+      if (download->GetState() == download::DownloadItem::IN_PROGRESS &&
+          download->GetReceivedBytes() > 0) {
+        SaveResumeState(download.get());
+      }
+    }
+  }
+  ResetDownloadStatus();
+
+  if (download_manager_) {
+    for (auto& download : download_items_to_be_detached_) {
+      if (download->GetState() == download::DownloadItem::IN_PROGRESS)
+        download->Cancel(/*user_cancel=*/false);
+    }
 
     while (!download_items_to_be_detached_.empty()) {
       DetachCachedFile(download_items_to_be_detached_.front().get());
@@ -126,6 +211,11 @@ void PlaylistMediaFileDownloader::DetachCachedFile(
           download::DownloadInterruptReason::DOWNLOAD_INTERRUPT_REASON_NONE &&
       item->IsDone()) {
     will_be_detached->MarkAsComplete();
+  } else if (IsResumableInterruptReason(item->GetLastReason()) ||
+             item->GetLastReason() ==
+                 download::DOWNLOAD_INTERRUPT_REASON_USER_SHUTDOWN) {
+    // Dropping the item keeps the partial file for the next range request.
+    DVLOG(2) << __func__ << ": keeping partial file of " << item->GetGuid();
   } else {
     will_be_detached->Remove();
   }
@@ -140,7 +230,7 @@ void PlaylistMediaFileDownloader::DownloadMediaFileForPlaylistItem(
 
   if (item.media_file_cached) {
     DVLOG(2) << __func__ << ": media file is already downloaded";
-    NotifySucceed(current_item_->id, current_item_->media_file_path);
+    NotifySucceed(item.id, item.media_file_path);
     return;
   }
 
@@ -166,28 +256,58 @@ void PlaylistMediaFileDownloader::DownloadMediaFileForPlaylistItem(
 
   if (GURL media_url(current_item_->media_src); media_url.is_valid()) {
     playlist_dir_path_ = base_dir.AppendASCII(current_item_->id);
-    DownloadMediaFile(media_url);
+    StartOrResumeDownload();
   } else {
     DVLOG(2) << __func__ << ": media file is empty";
     NotifyFail(current_item_->id);
   }
 }
 
+void PlaylistMediaFileDownloader::StartOrResumeDownload() {
+  if (!current_item_)
+    return;
+
+  GURL media_url(current_item_->media_src);
+  task_runner()->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&ReadResumeState, GetMediaFilePath(), media_url),
+      base::BindOnce(&PlaylistMediaFileDownloader::OnGetResumeState,
+                     weak_factory_.GetWeakPtr(), current_item_->id,
+                     media_url));
+}
+
+void PlaylistMediaFileDownloader::OnGetResumeState(
+    const std::string& id,
+    const GURL& url,
+    absl::optional<ResumeState> resume_state) {
+  if (!current_item_ || current_item_->id != id) {
+    // Canceled while reading the resume state.
+    return;
+  }
+
+  has_resume_state_ = resume_state.has_value();
+  DownloadMediaFile(url, resume_state);
+}
+
 void PlaylistMediaFileDownloader::OnDownloadCreated(
     download::DownloadItem* item) {
   DVLOG(2) << __func__;
-  DCHECK(current_item_) << "This shouldn't happen as we unobserve the manager "
-                           "when a process for an item is done";
-  DCHECK_EQ(item->GetGuid(), current_item_->id);
-
   DCHECK(!download_item_observation_.IsObservingSource(item));
   download_item_observation_.AddObservation(item);
+
+  if (!current_item_ || item->GetGuid() != current_item_->id) {
+    // The request was canceled before its download was created.
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&PlaylistMediaFileDownloader::CancelDownload,
+                                  weak_factory_.GetWeakPtr(), item->GetGuid()));
+  }
 }
 
 void PlaylistMediaFileDownloader::OnDownloadUpdated(
     download::DownloadItem* item) {
-  if (!current_item_) {
-    // Download could be already finished. This seems to be late async callback.
+  if (!current_item_ || item->GetGuid() != current_item_->id) {
+    // Download could be already finished or canceled. This seems to be late
+    // async callback.
     return;
   }
 
@@ -197,10 +317,14 @@ void PlaylistMediaFileDownloader::OnDownloadUpdated(
                << download::DownloadInterruptReasonToString(
                       item->GetLastReason());
     ScheduleToDetachCachedFile(item);
-    OnMediaFileDownloaded({});
+    if (!MaybeScheduleResume(item))
+      OnMediaFileDownloaded({});
     return;
   }
 
+  if (!has_resume_state_ && item->GetReceivedBytes() > 0)
+    SaveResumeState(item);
+
   base::TimeDelta time_remaining;
   item->TimeRemaining(&time_remaining);
   delegate_->OnMediaFileDownloadProgressed(
@@ -209,7 +333,9 @@ void PlaylistMediaFileDownloader::OnDownloadUpdated(
 
   if (item->IsDone()) {
     ScheduleToDetachCachedFile(item);
-    OnMediaFileDownloaded(playlist_dir_path_.Append(media_file_name_));
+    task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(&DeleteResumeState, GetMediaFilePath()));
+    OnMediaFileDownloaded(GetMediaFilePath());
     return;
   }
 }
@@ -220,13 +346,88 @@ void PlaylistMediaFileDownloader::OnDownloadRemoved(
       << "`item` was removed out of this class. This could cause flaky tests";
 }
 
-void PlaylistMediaFileDownloader::DownloadMediaFile(const GURL& url) {
+bool PlaylistMediaFileDownloader::MaybeScheduleResume(
+    download::DownloadItem* item) {
+  if (resume_attempts_ >= kMaxResumeAttempts)
+    return false;
+
+  const auto reason = item->GetLastReason();
+  if (reason == download::DOWNLOAD_INTERRUPT_REASON_SERVER_NO_RANGE ||
+      reason == download::DOWNLOAD_INTERRUPT_REASON_SERVER_PRECONDITION) {
+    // The server can't continue the partial file. Start over.
+    has_resume_state_ = false;
+    task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(&DeleteResumeState, GetMediaFilePath()));
+  } else if (!IsResumableInterruptReason(reason)) {
+    return false;
+  } else {
+    // Progress updates are throttled, so the interruption can be the first
+    // update that has received bytes.
+    if (!has_resume_state_ && item->GetReceivedBytes() > 0)
+      SaveResumeState(item);
+    if (!has_resume_state_)
+      return false;
+  }
+
+  resume_attempts_++;
+  DVLOG(2) << __func__ << ": retry " << resume_attempts_ << " for "
+           << current_item_->id;
+  base::SequencedTaskRunnerHandle::Get()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&PlaylistMediaFileDownloader::ResumeDownload,
+                     weak_factory_.GetWeakPtr(), current_item_->id),
+      kResumeRetryDelay * resume_attempts_);
+  return true;
+}
+
+void PlaylistMediaFileDownloader::ResumeDownload(const std::string& id) {
+  // Another item may have been requested since the retry was scheduled.
+  if (!current_item_ || current_item_->id != id)
+    return;
+  StartOrResumeDownload();
+}
+
+void PlaylistMediaFileDownloader::SaveResumeState(
+    download::DownloadItem* item) {
+  DCHECK(!has_resume_state_);
+  // Without a validator we can't tell whether the file changed on the server,
+  // so such downloads always start over.
+  if (item->GetETag().empty() && item->GetLastModifiedTime().empty())
+    return;
+
+  base::Value::Dict dict;
+  dict.Set(kResumeStateURLKey, current_item_->media_src);
+  dict.Set(kResumeStateETagKey, item->GetETag());
+  dict.Set(kResumeStateLastModifiedKey, item->GetLastModifiedTime());
+  std::string contents;
+  if (!base::JSONWriter::Write(dict, &contents))
+    return;
+
+  has_resume_state_ = true;
+  task_runner()->PostTask(FROM_HERE, base::BindOnce(&WriteResumeState,
+                                                    GetMediaFilePath(),
+                                                    std::move(contents)));
+}
+
+base::FilePath PlaylistMediaFileDownloader::GetMediaFilePath() const {
+  return playlist_dir_path_.Append(media_file_name_);
+}
+
+void PlaylistMediaFileDownloader::DownloadMediaFile(
+    const GURL& url,
+    const absl::optional<ResumeState>& resume_state) {
   DVLOG(2) << __func__ << ": " << url.spec();
 
-  const base::FilePath file_path = playlist_dir_path_.Append(media_file_name_);
+  const base::FilePath file_path = GetMediaFilePath();
   auto params = std::make_unique<download::DownloadUrlParameters>(
       url, GetNetworkTrafficAnnotationTagForURLLoad());
   params->set_file_path(file_path);
+  if (resume_state) {
+    DVLOG(2) << __func__ << ": resuming at " << resume_state->offset;
+    params->set_offset(resume_state->offset);
+    params->set_etag(resume_state->etag);
+    params->set_last_modified(resume_state->last_modified);
+  }
   params->set_guid(current_item_->id);
   params->set_transient(true);
   params->set_require_safety_checks(false);
@@ -252,14 +453,34 @@ void PlaylistMediaFileDownloader::OnMediaFileDownloaded(base::FilePath path) {
 }
 
 void PlaylistMediaFileDownloader::RequestCancelCurrentPlaylistGeneration() {
+  const std::string id = current_item_ ? current_item_->id : std::string();
   ResetDownloadStatus();
+  // The old download must not keep writing once another item can be
+  // requested.
+  if (!id.empty())
+    CancelDownload(id);
+}
+
+void PlaylistMediaFileDownloader::CancelDownload(const std::string& id) {
+  if (!download_manager_)
+    return;
+
+  download::DownloadItem* item = download_manager_->GetDownloadByGuid(id);
+  if (!item || item->GetState() != download::DownloadItem::IN_PROGRESS)
+    return;
+
+  item->Cancel(/*user_cancel=*/true);
+  ScheduleToDetachCachedFile(item);
 }
 
 base::SequencedTaskRunner* PlaylistMediaFileDownloader::task_runner() {
   if (!task_runner_) {
+    // Resume state written while the browser shuts down has to land, or the
+    // partial file can't be resumed in the next session. Only small files are
+    // touched on this sequence.
     task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
         {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
-         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+         base::TaskShutdownBehavior::BLOCK_SHUTDOWN});
   }
   return task_runner_.get();
 }
@@ -268,6 +489,8 @@ void PlaylistMediaFileDownloader::ResetDownloadStatus() {
   in_progress_ = false;
   current_item_.reset();
   playlist_dir_path_.clear();
+  resume_attempts_ = 0;
+  has_resume_state_ = false;
 }
 
 }  // namespace playlist
@@ -19,6 +19,7 @@
 #include "brave/components/playlist/playlist_types.h"
 #include "components/download/public/common/download_item.h"
 #include "components/download/public/common/simple_download_manager.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace base {
 class FilePath;
@@ -44,6 +45,10 @@ class GURL;
 namespace playlist {
 
 // Handle one Playlist at once.
+// A download that is interrupted by the network, or by destroying the
+// downloader, keeps its partial file. It is resumed with a range request, both
+// right away and when the same item is downloaded again later (e.g. after a
+// restart).
 class PlaylistMediaFileDownloader
     : public download::SimpleDownloadManager::Observer,
       public download::DownloadItem::Observer {
@@ -67,6 +72,13 @@ class PlaylistMediaFileDownloader
     virtual ~Delegate() {}
   };
 
+  // Validators and size of a partially downloaded media file.
+  struct ResumeState {
+    std::string etag;
+    std::string last_modified;
+    int64_t offset = 0;
+  };
+
   PlaylistMediaFileDownloader(Delegate* delegate,
                               content::BrowserContext* context,
                               base::FilePath::StringType media_file_name);
@@ -93,12 +105,27 @@ class PlaylistMediaFileDownloader
 
  private:
   void ResetDownloadStatus();
-  void DownloadMediaFile(const GURL& url);
+  void StartOrResumeDownload();
+  // Resumes the current item unless it is no longer |id|.
+  void ResumeDownload(const std::string& id);
+  void OnGetResumeState(const std::string& id,
+                        const GURL& url,
+                        absl::optional<ResumeState> resume_state);
+  void DownloadMediaFile(const GURL& url,
+                         const absl::optional<ResumeState>& resume_state);
   void OnMediaFileDownloaded(base::FilePath path);
 
+  // Returns true when |item| was interrupted in a way that a later range
+  // request can pick up.
+  bool MaybeScheduleResume(download::DownloadItem* item);
+  void SaveResumeState(download::DownloadItem* item);
+  base::FilePath GetMediaFilePath() const;
+
   void NotifyFail(const std::string& id);
   void NotifySucceed(const std::string& id, const std::string& media_file_path);
 
+  // Cancels the download of |id| if it is still running.
+  void CancelDownload(const std::string& id);
   void ScheduleToDetachCachedFile(download::DownloadItem* item);
   void DetachCachedFile(download::DownloadItem* item);
 
@@ -123,6 +150,10 @@ class PlaylistMediaFileDownloader
   // All below variables are only for playlist creation.
   base::FilePath playlist_dir_path_;
   std::unique_ptr<PlaylistItemInfo> current_item_;
+  // Automatic resumes of the current item after network errors.
+  int resume_attempts_ = 0;
+  // true once the partial file of the current item can be resumed.
+  bool has_resume_state_ = false;
 
   // true when this class is working for playlist now.
   bool in_progress_ = false;
@@ -157,6 +157,8 @@ class PlaylistService : public KeyedService,
   FRIEND_TEST_ALL_PREFIXES(PlaylistServiceUnitTest, CreatePlaylistItem);
   FRIEND_TEST_ALL_PREFIXES(PlaylistServiceUnitTest, MediaDownloadFailed);
   FRIEND_TEST_ALL_PREFIXES(PlaylistServiceUnitTest, ThumbnailFailed);
+  FRIEND_TEST_ALL_PREFIXES(PlaylistServiceUnitTest,
+                           MediaDownloadResumesAfterDisconnect);
   FRIEND_TEST_ALL_PREFIXES(PlaylistServiceUnitTest, MediaRecoverTest);
   FRIEND_TEST_ALL_PREFIXES(PlaylistServiceUnitTest, DeleteItem);
   FRIEND_TEST_ALL_PREFIXES(PlaylistServiceUnitTest, RemoveAndRestoreLocalData);
@@ -0,0 +1,110 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SIZED_LRU_CACHE_SIZED_LRU_CACHE_H_
+#define BRAVE_COMPONENTS_SIZED_LRU_CACHE_SIZED_LRU_CACHE_H_
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/containers/lru_cache.h"
+
+namespace brave {
+
+// In-memory cache bounded by the total size of its values rather than by their
+// count, for caches of blobs that vary a lot in size. The size of a value is
+// given when it is put. Values that would take more than 1/|max_entry_share|
+// of the budget are not kept, so that a single one can't flush everything
+// else. The least recently used values are evicted once the budget is
+// exceeded.
+//
+// Clear() bumps generation(). Callers that fill the cache asynchronously can
+// compare it with the generation their work started in, so that results read
+// before a Clear() aren't added back.
+template <class KeyType, class ValueType>
+class SizedLRUCache {
+ public:
+  SizedLRUCache(size_t max_bytes, size_t max_entry_share)
+      : max_bytes_(max_bytes),
+        max_entry_share_(max_entry_share),
+        entries_(base::LRUCache<KeyType, Entry>::NO_AUTO_EVICT) {
+    DCHECK_GT(max_entry_share_, 0u);
+  }
+  SizedLRUCache(const SizedLRUCache&) = delete;
+  SizedLRUCache& operator=(const SizedLRUCache&) = delete;
+  ~SizedLRUCache() = default;
+
+  // Returns the value of |key| and marks it as the most recently used one, or
+  // nullptr.
+  ValueType* Get(const KeyType& key) {
+    auto it = entries_.Get(key);
+    return it == entries_.end() ? nullptr : &it->second.value;
+  }
+
+  // Like Get(), without changing the use order.
+  const ValueType* Peek(const KeyType& key) const {
+    auto it = entries_.Peek(key);
+    return it == entries_.end() ? nullptr : &it->second.value;
+  }
+
+  // Returns false if a value of |size| bytes wouldn't be kept.
+  bool Fits(size_t size) const { return size <= max_bytes_ / max_entry_share_; }
+
+  // Replaces the value of |key| with |value|, charged as |size| bytes. If it
+  // doesn't fit, the previous value is still removed. Returns the number of
+  // other values evicted to make room.
+  size_t Put(const KeyType& key, ValueType value, size_t size) {
+    Erase(key);
+    if (!Fits(size))
+      return 0;
+
+    bytes_ += size;
+    entries_.Put(key, Entry{std::move(value), size});
+    size_t evicted = 0;
+    while (bytes_ > max_bytes_) {
+      auto oldest = entries_.rbegin();
+      bytes_ -= oldest->second.size;
+      entries_.Erase(oldest);
+      evicted++;
+    }
+    return evicted;
+  }
+
+  void Erase(const KeyType& key) {
+    auto it = entries_.Peek(key);
+    if (it == entries_.end())
+      return;
+    bytes_ -= it->second.size;
+    entries_.Erase(it);
+  }
+
+  void Clear() {
+    entries_.Clear();
+    bytes_ = 0;
+    generation_++;
+  }
+
+  size_t size() const { return entries_.size(); }
+  size_t bytes() const { return bytes_; }
+  int generation() const { return generation_; }
+
+ private:
+  struct Entry {
+    ValueType value;
+    size_t size;
+  };
+
+  const size_t max_bytes_;
+  const size_t max_entry_share_;
+  base::LRUCache<KeyType, Entry> entries_;
+  size_t bytes_ = 0;
+  int generation_ = 0;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMPONENTS_SIZED_LRU_CACHE_SIZED_LRU_CACHE_H_
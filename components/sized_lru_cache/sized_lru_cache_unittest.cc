@@ -0,0 +1,77 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/sized_lru_cache/sized_lru_cache.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave {
+
+using Cache = SizedLRUCache<std::string, std::string>;
+
+TEST(SizedLRUCacheTest, GetAndPeek) {
+  Cache cache(/*max_bytes=*/100, /*max_entry_share=*/2);
+  EXPECT_FALSE(cache.Get("a"));
+
+  EXPECT_EQ(0u, cache.Put("a", "value", 10));
+  ASSERT_TRUE(cache.Get("a"));
+  EXPECT_EQ("value", *cache.Get("a"));
+  ASSERT_TRUE(cache.Peek("a"));
+  EXPECT_EQ("value", *cache.Peek("a"));
+  EXPECT_EQ(10u, cache.bytes());
+
+  EXPECT_EQ(0u, cache.Put("a", "new value", 20));
+  EXPECT_EQ("new value", *cache.Get("a"));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(20u, cache.bytes());
+
+  cache.Erase("a");
+  EXPECT_FALSE(cache.Get("a"));
+  EXPECT_EQ(0u, cache.bytes());
+}
+
+TEST(SizedLRUCacheTest, EvictsLeastRecentlyUsed) {
+  Cache cache(/*max_bytes=*/100, /*max_entry_share=*/2);
+  cache.Put("a", "a", 40);
+  cache.Put("b", "b", 40);
+  // Peek() doesn't count as a use, Get() does.
+  cache.Peek("a");
+  cache.Get("b");
+
+  EXPECT_EQ(1u, cache.Put("c", "c", 40));
+  EXPECT_FALSE(cache.Peek("a"));
+  EXPECT_TRUE(cache.Peek("b"));
+  EXPECT_TRUE(cache.Peek("c"));
+  EXPECT_EQ(80u, cache.bytes());
+}
+
+TEST(SizedLRUCacheTest, DoesNotKeepLargeValues) {
+  Cache cache(/*max_bytes=*/100, /*max_entry_share=*/4);
+  EXPECT_TRUE(cache.Fits(25));
+  EXPECT_FALSE(cache.Fits(26));
+
+  cache.Put("a", "a", 25);
+  cache.Put("b", "b", 10);
+  // The previous value is dropped, nothing else is.
+  EXPECT_EQ(0u, cache.Put("a", "large", 26));
+  EXPECT_FALSE(cache.Peek("a"));
+  EXPECT_TRUE(cache.Peek("b"));
+  EXPECT_EQ(10u, cache.bytes());
+}
+
+TEST(SizedLRUCacheTest, ClearBumpsGeneration) {
+  Cache cache(/*max_bytes=*/100, /*max_entry_share=*/2);
+  cache.Put("a", "a", 10);
+  const int generation = cache.generation();
+
+  cache.Clear();
+  EXPECT_NE(generation, cache.generation());
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.bytes());
+}
+
+}  // namespace brave
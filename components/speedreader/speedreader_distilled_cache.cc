@@ -0,0 +1,262 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_distilled_cache.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/containers/lru_cache.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
+#include "base/time/time.h"
+#include "crypto/sha2.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+namespace {
+
+// A single entry may not take more than this share of a tier.
+constexpr size_t kMaxEntryShare = 4;
+
+}  // namespace
+
+// Owns the entries in the cache dir. Their sizes and use order are kept in
+// memory, so that writes don't have to list the directory. Lives on a
+// blocking sequence.
+class SpeedreaderDistilledCache::DiskStore {
+ public:
+  DiskStore(const base::FilePath& cache_dir, size_t max_bytes)
+      : cache_dir_(cache_dir),
+        max_bytes_(max_bytes),
+        index_(base::LRUCache<std::string, int64_t>::NO_AUTO_EVICT) {}
+  DiskStore(const DiskStore&) = delete;
+  DiskStore& operator=(const DiskStore&) = delete;
+
+  absl::optional<std::string> Read(const std::string& key) {
+    MaybeLoadIndex();
+    const base::FilePath path = cache_dir_.AppendASCII(key);
+    std::string distilled;
+    if (!base::ReadFileToString(path, &distilled)) {
+      Forget(key);
+      return absl::nullopt;
+    }
+    // The modification time keeps the use order across restarts.
+    const base::Time now = base::Time::Now();
+    base::TouchFile(path, now, now);
+    if (index_.Get(key) == index_.end())
+      Remember(key, distilled.size());
+    return distilled;
+  }
+
+  // Returns the number of evicted entries.
+  size_t Write(const std::string& key, const std::string& distilled) {
+    MaybeLoadIndex();
+    if (!base::CreateDirectory(cache_dir_)) {
+      VLOG(1) << "Could not create speedreader cache dir " << cache_dir_;
+      return 0;
+    }
+    if (!base::ImportantFileWriter::WriteFileAtomically(
+            cache_dir_.AppendASCII(key), distilled)) {
+      return 0;
+    }
+    Forget(key);
+    Remember(key, distilled.size());
+
+    // The new entry is the most recently used one, so it is never evicted.
+    size_t evicted = 0;
+    while (total_bytes_ > static_cast<int64_t>(max_bytes_) &&
+           index_.size() > 1) {
+      auto oldest = index_.rbegin();
+      if (base::DeleteFile(cache_dir_.AppendASCII(oldest->first)))
+        evicted++;
+      total_bytes_ -= oldest->second;
+      index_.Erase(oldest);
+    }
+    return evicted;
+  }
+
+  void Clear() {
+    base::DeletePathRecursively(cache_dir_);
+    index_.Clear();
+    total_bytes_ = 0;
+    index_loaded_ = true;
+  }
+
+ private:
+  // Lists the directory once, on first use.
+  void MaybeLoadIndex() {
+    if (index_loaded_)
+      return;
+    index_loaded_ = true;
+
+    std::vector<std::tuple<base::Time, std::string, int64_t>> entries;
+    base::FileEnumerator enumerator(cache_dir_, false,
+                                    base::FileEnumerator::FILES);
+    for (base::FilePath entry = enumerator.Next(); !entry.empty();
+         entry = enumerator.Next()) {
+      const auto info = enumerator.GetInfo();
+      entries.emplace_back(info.GetLastModifiedTime(),
+                           entry.BaseName().MaybeAsASCII(), info.GetSize());
+    }
+    std::sort(entries.begin(), entries.end());
+    for (const auto& [last_used, key, size] : entries) {
+      if (!key.empty())
+        Remember(key, size);
+    }
+  }
+
+  void Remember(const std::string& key, int64_t size) {
+    index_.Put(key, size);
+    total_bytes_ += size;
+  }
+
+  void Forget(const std::string& key) {
+    auto it = index_.Peek(key);
+    if (it == index_.end())
+      return;
+    total_bytes_ -= it->second;
+    index_.Erase(it);
+  }
+
+  const base::FilePath cache_dir_;
+  const size_t max_bytes_;
+  bool index_loaded_ = false;
+  // Entry sizes, most recently used first.
+  base::LRUCache<std::string, int64_t> index_;
+  int64_t total_bytes_ = 0;
+};
+
+SpeedreaderDistilledCache::SpeedreaderDistilledCache(
+    const base::FilePath& cache_dir,
+    size_t max_memory_bytes,
+    size_t max_disk_bytes)
+    : max_disk_bytes_(max_disk_bytes),
+      memory_(max_memory_bytes, kMaxEntryShare) {
+  if (!cache_dir.empty()) {
+    // Lookups hold back the page load, so they can't wait behind idle work.
+    disk_store_ = base::SequenceBound<DiskStore>(
+        base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+             base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN}),
+        cache_dir, max_disk_bytes);
+  }
+}
+
+SpeedreaderDistilledCache::~SpeedreaderDistilledCache() = default;
+
+// static
+std::string SpeedreaderDistilledCache::MakeKey(const GURL& url,
+                                               base::StringPiece validator,
+                                               base::StringPiece settings) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  const std::string key = base::StrCat(
+      {url.ReplaceComponents(replacements).spec(), "\n", validator, "\n",
+       settings});
+  return base::ToLowerASCII(base::HexEncode(crypto::SHA256HashString(key)));
+}
+
+void SpeedreaderDistilledCache::Get(const std::string& key,
+                                    GetCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (const std::string* distilled = memory_.Get(key)) {
+    RecordLookup(LookupResult::kMemoryHit);
+    std::move(callback).Run(*distilled);
+    return;
+  }
+
+  if (!disk_store_) {
+    RecordLookup(LookupResult::kMiss);
+    std::move(callback).Run(absl::nullopt);
+    return;
+  }
+
+  disk_store_.AsyncCall(&DiskStore::Read)
+      .WithArgs(key)
+      .Then(base::BindOnce(&SpeedreaderDistilledCache::OnDiskGet,
+                           weak_factory_.GetWeakPtr(), key,
+                           memory_.generation(), std::move(callback)));
+}
+
+void SpeedreaderDistilledCache::OnDiskGet(
+    const std::string& key,
+    int generation,
+    GetCallback callback,
+    absl::optional<std::string> distilled) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!distilled) {
+    RecordLookup(LookupResult::kMiss);
+    std::move(callback).Run(absl::nullopt);
+    return;
+  }
+  RecordLookup(LookupResult::kDiskHit);
+  if (generation == memory_.generation())
+    PutInMemory(key, *distilled);
+  std::move(callback).Run(std::move(distilled));
+}
+
+void SpeedreaderDistilledCache::Put(const std::string& key,
+                                    std::string distilled) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (disk_store_ && distilled.size() <= max_disk_bytes_ / kMaxEntryShare) {
+    disk_store_.AsyncCall(&DiskStore::Write)
+        .WithArgs(key, distilled)
+        .Then(base::BindOnce(&SpeedreaderDistilledCache::OnDiskPut,
+                             weak_factory_.GetWeakPtr()));
+  }
+  PutInMemory(key, std::move(distilled));
+}
+
+void SpeedreaderDistilledCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  memory_.Clear();
+  // Runs after the reads and writes that are already posted.
+  if (disk_store_)
+    disk_store_.AsyncCall(&DiskStore::Clear);
+}
+
+void SpeedreaderDistilledCache::OnDiskPut(size_t evicted) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!evicted)
+    return;
+  disk_evictions_ += evicted;
+  UMA_HISTOGRAM_COUNTS_100("Brave.Speedreader.DistilledCache.DiskEvictions",
+                           evicted);
+}
+
+void SpeedreaderDistilledCache::PutInMemory(const std::string& key,
+                                            std::string distilled) {
+  const size_t size = distilled.size();
+  memory_evictions_ += memory_.Put(key, std::move(distilled), size);
+}
+
+void SpeedreaderDistilledCache::RecordLookup(LookupResult result) {
+  switch (result) {
+    case LookupResult::kMiss:
+      misses_++;
+      break;
+    case LookupResult::kMemoryHit:
+      memory_hits_++;
+      break;
+    case LookupResult::kDiskHit:
+      disk_hits_++;
+      break;
+  }
+  UMA_HISTOGRAM_ENUMERATION("Brave.Speedreader.DistilledCache.Lookup", result);
+}
+
+}  // namespace speedreader
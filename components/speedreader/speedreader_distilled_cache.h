@@ -0,0 +1,107 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLED_CACHE_H_
+#define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLED_CACHE_H_
+
+#include <string>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/strings/string_piece.h"
+#include "base/threading/sequence_bound.h"
+#include "brave/components/sized_lru_cache/sized_lru_cache.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+class GURL;
+
+namespace speedreader {
+
+// Bounded cache of distilled pages, so that reloads and history navigations
+// of an unchanged article don't run the rewriter again. Entries are keyed by
+// MakeKey() and hold the rewriter output without the content stylesheet.
+//
+// Recently used entries are kept in memory, everything is also written to
+// |cache_dir| unless it is empty (e.g. for off-the-record profiles). Both tiers
+// evict the least recently used entries once they exceed their byte budget.
+class SpeedreaderDistilledCache {
+ public:
+  // Recorded to Brave.Speedreader.DistilledCache.Lookup. Don't renumber.
+  enum class LookupResult {
+    kMiss = 0,
+    kMemoryHit = 1,
+    kDiskHit = 2,
+    kMaxValue = kDiskHit,
+  };
+
+  using GetCallback =
+      base::OnceCallback<void(absl::optional<std::string> distilled)>;
+
+  static constexpr size_t kDefaultMaxMemoryBytes = 8 * 1024 * 1024;
+  static constexpr size_t kDefaultMaxDiskBytes = 64 * 1024 * 1024;
+
+  explicit SpeedreaderDistilledCache(
+      const base::FilePath& cache_dir,
+      size_t max_memory_bytes = kDefaultMaxMemoryBytes,
+      size_t max_disk_bytes = kDefaultMaxDiskBytes);
+  ~SpeedreaderDistilledCache();
+  SpeedreaderDistilledCache(const SpeedreaderDistilledCache&) = delete;
+  SpeedreaderDistilledCache& operator=(const SpeedreaderDistilledCache&) =
+      delete;
+
+  // |validator| identifies the response body, i.e. its ETag, Last-Modified or
+  // a hash of the body. |settings| covers everything the rewriter output
+  // depends on besides the page itself.
+  static std::string MakeKey(const GURL& url,
+                             base::StringPiece validator,
+                             base::StringPiece settings);
+
+  // Memory hits run |callback| synchronously, disk lookups asynchronously.
+  void Get(const std::string& key, GetCallback callback);
+  void Put(const std::string& key, std::string distilled);
+  // Removes all entries, including the ones on disk.
+  void Clear();
+
+  size_t memory_hits() const { return memory_hits_; }
+  size_t disk_hits() const { return disk_hits_; }
+  size_t misses() const { return misses_; }
+  size_t memory_evictions() const { return memory_evictions_; }
+  size_t disk_evictions() const { return disk_evictions_; }
+  size_t memory_bytes() const { return memory_.bytes(); }
+
+ private:
+  class DiskStore;
+
+  void OnDiskGet(const std::string& key,
+                 int generation,
+                 GetCallback callback,
+                 absl::optional<std::string> distilled);
+  void OnDiskPut(size_t evicted);
+  void PutInMemory(const std::string& key, std::string distilled);
+  void RecordLookup(LookupResult result);
+
+  const size_t max_disk_bytes_;
+  // Unset when there is no cache dir.
+  base::SequenceBound<DiskStore> disk_store_;
+
+  // Disk reads started before the last Clear() don't fill it again.
+  brave::SizedLRUCache<std::string, std::string> memory_;
+
+  size_t memory_hits_ = 0;
+  size_t disk_hits_ = 0;
+  size_t misses_ = 0;
+  size_t memory_evictions_ = 0;
+  size_t disk_evictions_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<SpeedreaderDistilledCache> weak_factory_{this};
+};
+
+}  // namespace speedreader
+
+#endif  // BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLED_CACHE_H_
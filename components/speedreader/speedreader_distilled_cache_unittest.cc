@@ -0,0 +1,161 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_distilled_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+namespace {
+
+constexpr char kUrl[] = "https://example.com/article";
+
+}  // namespace
+
+class SpeedreaderDistilledCacheTest : public testing::Test {
+ public:
+  SpeedreaderDistilledCacheTest() = default;
+  ~SpeedreaderDistilledCacheTest() override = default;
+
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  absl::optional<std::string> Get(SpeedreaderDistilledCache* cache,
+                                  const std::string& key) {
+    absl::optional<std::string> result;
+    base::RunLoop run_loop;
+    cache->Get(key, base::BindOnce(
+                        [](absl::optional<std::string>* result,
+                           base::OnceClosure quit,
+                           absl::optional<std::string> distilled) {
+                          *result = std::move(distilled);
+                          std::move(quit).Run();
+                        },
+                        &result, run_loop.QuitClosure()));
+    run_loop.Run();
+    return result;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(SpeedreaderDistilledCacheTest, MakeKey) {
+  const std::string key =
+      SpeedreaderDistilledCache::MakeKey(GURL(kUrl), "etag:1", "dark");
+  EXPECT_EQ(key, SpeedreaderDistilledCache::MakeKey(
+                     GURL(std::string(kUrl) + "#section"), "etag:1", "dark"));
+  EXPECT_NE(key,
+            SpeedreaderDistilledCache::MakeKey(GURL(kUrl), "etag:2", "dark"));
+  EXPECT_NE(key,
+            SpeedreaderDistilledCache::MakeKey(GURL(kUrl), "etag:1", "light"));
+  EXPECT_NE(key, SpeedreaderDistilledCache::MakeKey(
+                     GURL("https://example.com/other"), "etag:1", "dark"));
+}
+
+TEST_F(SpeedreaderDistilledCacheTest, MemoryHitIsSynchronous) {
+  SpeedreaderDistilledCache cache((base::FilePath()));
+  cache.Put("key", "distilled");
+
+  bool called = false;
+  cache.Get("key", base::BindOnce(
+                       [](bool* called, absl::optional<std::string> distilled) {
+                         *called = true;
+                         EXPECT_EQ("distilled", distilled);
+                       },
+                       &called));
+  EXPECT_TRUE(called);
+  EXPECT_EQ(1u, cache.memory_hits());
+
+  EXPECT_FALSE(Get(&cache, "other"));
+  EXPECT_EQ(1u, cache.misses());
+}
+
+TEST_F(SpeedreaderDistilledCacheTest, EvictsLeastRecentlyUsedFromMemory) {
+  SpeedreaderDistilledCache cache(base::FilePath(), 40);
+  cache.Put("a", std::string(10, 'a'));
+  cache.Put("b", std::string(10, 'b'));
+  cache.Put("c", std::string(10, 'c'));
+  // Touch "a" so "b" is the oldest.
+  EXPECT_TRUE(Get(&cache, "a"));
+  cache.Put("d", std::string(10, 'd'));
+  cache.Put("e", std::string(10, 'e'));
+
+  EXPECT_EQ(1u, cache.memory_evictions());
+  EXPECT_EQ(40u, cache.memory_bytes());
+  EXPECT_FALSE(Get(&cache, "b"));
+  EXPECT_TRUE(Get(&cache, "a"));
+
+  // Entries taking more than a quarter of the budget aren't kept in memory.
+  cache.Put("big", std::string(11, 'x'));
+  EXPECT_FALSE(Get(&cache, "big"));
+}
+
+TEST_F(SpeedreaderDistilledCacheTest, DiskTierSurvivesRestart) {
+  {
+    SpeedreaderDistilledCache cache(temp_dir_.GetPath());
+    cache.Put("key", "distilled");
+    task_environment_.RunUntilIdle();
+  }
+
+  SpeedreaderDistilledCache cache(temp_dir_.GetPath());
+  EXPECT_EQ("distilled", Get(&cache, "key"));
+  EXPECT_EQ(1u, cache.disk_hits());
+  // Disk hits are promoted to memory.
+  EXPECT_EQ("distilled", Get(&cache, "key"));
+  EXPECT_EQ(1u, cache.memory_hits());
+}
+
+TEST_F(SpeedreaderDistilledCacheTest, EvictsFromDisk) {
+  SpeedreaderDistilledCache cache(temp_dir_.GetPath(), 1024, 40);
+  cache.Put("a", std::string(10, 'a'));
+  cache.Put("b", std::string(10, 'b'));
+  cache.Put("c", std::string(10, 'c'));
+  cache.Put("d", std::string(10, 'd'));
+  cache.Put("e", std::string(10, 'e'));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(1u, cache.disk_evictions());
+}
+
+TEST_F(SpeedreaderDistilledCacheTest, Clear) {
+  {
+    SpeedreaderDistilledCache cache(temp_dir_.GetPath());
+    cache.Put("key", "distilled");
+    task_environment_.RunUntilIdle();
+  }
+
+  SpeedreaderDistilledCache cache(temp_dir_.GetPath());
+  cache.Put("other", "distilled");
+  // A disk read that is running when the cache is cleared is still answered,
+  // but not kept.
+  absl::optional<std::string> result;
+  cache.Get("key", base::BindOnce(
+                       [](absl::optional<std::string>* result,
+                          absl::optional<std::string> distilled) {
+                         *result = std::move(distilled);
+                       },
+                       &result));
+  cache.Clear();
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ("distilled", result);
+  EXPECT_EQ(0u, cache.memory_bytes());
+
+  EXPECT_FALSE(Get(&cache, "key"));
+  EXPECT_FALSE(Get(&cache, "other"));
+  EXPECT_FALSE(base::PathExists(temp_dir_.GetPath()));
+}
+
+}  // namespace speedreader
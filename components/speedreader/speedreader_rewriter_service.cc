@@ -172,12 +172,37 @@ std::unique_ptr<Rewriter> SpeedreaderRewriterService::MakeRewriter(
     const std::string& font_size,
     const std::string& content_style) {
   auto rewriter = speedreader_->MakeRewriter(url.spec());
+  ConfigureRewriter(rewriter.get(), theme, font_family, font_size,
+                    content_style);
+  return rewriter;
+}
+
+std::unique_ptr<Rewriter> SpeedreaderRewriterService::MakeRewriter(
+    const GURL& url,
+    const std::string& theme,
+    const std::string& font_family,
+    const std::string& font_size,
+    const std::string& content_style,
+    void (*output_sink)(const char*, size_t, void*),
+    void* output_sink_user_data) {
+  auto rewriter = speedreader_->MakeRewriter(url.spec(), output_sink,
+                                             output_sink_user_data);
+  ConfigureRewriter(rewriter.get(), theme, font_family, font_size,
+                    content_style);
+  return rewriter;
+}
+
+void SpeedreaderRewriterService::ConfigureRewriter(
+    Rewriter* rewriter,
+    const std::string& theme,
+    const std::string& font_family,
+    const std::string& font_size,
+    const std::string& content_style) {
   rewriter->SetMinOutLength(speedreader::kSpeedreaderMinOutLengthParam.Get());
   rewriter->SetTheme(theme);
   rewriter->SetFontFamily(font_family);
   rewriter->SetFontSize(font_size);
   rewriter->SetContentStyle(content_style);
-  return rewriter;
 }
 
 const std::string& SpeedreaderRewriterService::GetContentStylesheet() {
@@ -41,12 +41,28 @@ class SpeedreaderRewriterService {
                                          const std::string& font_family,
                                          const std::string& font_size,
                                          const std::string& content_style);
+  // Same as above, but |output_sink| is called with every chunk of distilled
+  // output instead of accumulating it in the rewriter.
+  std::unique_ptr<Rewriter> MakeRewriter(const GURL& url,
+                                         const std::string& theme,
+                                         const std::string& font_family,
+                                         const std::string& font_size,
+                                         const std::string& content_style,
+                                         void (*output_sink)(const char*,
+                                                             size_t,
+                                                             void*),
+                                         void* output_sink_user_data);
   const std::string& GetContentStylesheet();
 
  private:
   void OnFileChanged(const base::FilePath& path, bool error);
   void OnWatcherStarted(base::FilePathWatcher* file_watcher);
   void OnLoadStylesheet(std::string stylesheet);
+  void ConfigureRewriter(Rewriter* rewriter,
+                         const std::string& theme,
+                         const std::string& font_family,
+                         const std::string& font_size,
+                         const std::string& content_style);
 
   scoped_refptr<base::SequencedTaskRunner> watch_task_runner_;
   base::FilePathWatcher* file_watcher_ = nullptr;
@@ -5,14 +5,18 @@
 
 #include "brave/components/speedreader/speedreader_service.h"
 
+#include <memory>
 #include <string>
 
 #include "base/command_line.h"
 #include "base/feature_list.h"
+#include "base/files/file_path.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/strings/strcat.h"
 #include "base/strings/string_util.h"
 #include "brave/components/speedreader/common/features.h"
 #include "brave/components/speedreader/common/speedreader_panel.mojom-shared.h"
+#include "brave/components/speedreader/speedreader_distilled_cache.h"
 #include "brave/components/speedreader/speedreader_pref_names.h"
 #include "brave/components/time_period_storage/weekly_storage.h"
 #include "components/prefs/pref_registry_simple.h"
@@ -79,7 +83,11 @@ void RecordHistograms(PrefService* prefs, bool toggled, bool enabled_now) {
 
 }  // namespace
 
-SpeedreaderService::SpeedreaderService(PrefService* prefs) : prefs_(prefs) {}
+SpeedreaderService::SpeedreaderService(PrefService* prefs,
+                                       const base::FilePath& cache_dir)
+    : prefs_(prefs),
+      distilled_cache_(std::make_unique<SpeedreaderDistilledCache>(cache_dir)) {
+}
 
 SpeedreaderService::~SpeedreaderService() = default;
 
@@ -224,4 +232,13 @@ std::string SpeedreaderService::GetContentStyleName() const {
   }
 }
 
+std::string SpeedreaderService::MakeDistilledCacheKey(
+    const GURL& url,
+    base::StringPiece validator) const {
+  return SpeedreaderDistilledCache::MakeKey(
+      url, validator,
+      base::StrCat({GetThemeName(), "/", GetFontFamilyName(), "/",
+                    GetFontSizeName(), "/", GetContentStyleName()}));
+}
+
 }  // namespace speedreader
@@ -6,25 +6,36 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_SERVICE_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_SERVICE_H_
 
+#include <memory>
 #include <string>
 
 #include "base/memory/raw_ptr.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/speedreader/common/speedreader_panel.mojom.h"
 #include "brave/components/speedreader/speedreader_util.h"
 #include "components/keyed_service/core/keyed_service.h"
 
+class GURL;
 class PrefRegistrySimple;
 class PrefService;
 
+namespace base {
+class FilePath;
+}  // namespace base
+
 namespace speedreader {
 using mojom::ContentStyle;
 using mojom::FontFamily;
 using mojom::FontSize;
 using mojom::Theme;
 
+class SpeedreaderDistilledCache;
+
 class SpeedreaderService : public KeyedService {
  public:
-  explicit SpeedreaderService(PrefService* prefs);
+  // Distilled pages are cached under |cache_dir|, or only in memory if it is
+  // empty.
+  SpeedreaderService(PrefService* prefs, const base::FilePath& cache_dir);
   ~SpeedreaderService() override;
 
   static void RegisterProfilePrefs(PrefRegistrySimple* registry);
@@ -51,11 +62,20 @@ class SpeedreaderService : public KeyedService {
   ContentStyle GetContentStyle() const;
   std::string GetContentStyleName() const;
 
+  SpeedreaderDistilledCache* distilled_cache() {
+    return distilled_cache_.get();
+  }
+  // Key of the distilled |url| response identified by |validator| with the
+  // current reader settings.
+  std::string MakeDistilledCacheKey(const GURL& url,
+                                    base::StringPiece validator) const;
+
   SpeedreaderService(const SpeedreaderService&) = delete;
   SpeedreaderService& operator=(const SpeedreaderService&) = delete;
 
  private:
   raw_ptr<PrefService> prefs_ = nullptr;
+  std::unique_ptr<SpeedreaderDistilledCache> distilled_cache_;
 };
 
 }  // namespace speedreader
@@ -8,7 +8,9 @@
 #include <string>
 #include <utility>
 
+#include "base/strings/strcat.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
+#include "brave/components/speedreader/speedreader_service.h"
 #include "brave/components/speedreader/speedreader_throttle_delegate.h"
 #include "brave/components/speedreader/speedreader_url_loader.h"
 #include "brave/components/speedreader/speedreader_util.h"
@@ -17,11 +19,27 @@
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/system/data_pipe.h"
+#include "net/http/http_response_headers.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
 
 namespace speedreader {
 
+namespace {
+
+// Returns what identifies the response body, or an empty string if only the
+// body itself can.
+std::string GetResponseValidator(const net::HttpResponseHeaders& headers) {
+  std::string value;
+  if (headers.GetNormalizedHeader("ETag", &value) && !value.empty())
+    return base::StrCat({"etag:", value});
+  if (headers.GetNormalizedHeader("Last-Modified", &value) && !value.empty())
+    return base::StrCat({"last-modified:", value});
+  return std::string();
+}
+
+}  // namespace
+
 // static
 std::unique_ptr<SpeedReaderThrottle>
 SpeedReaderThrottle::MaybeCreateThrottleFor(
@@ -73,6 +91,21 @@ void SpeedReaderThrottle::WillProcessResponse(
   VLOG(2) << "Speedreader throttling: " << response_url;
   *defer = true;
 
+  // Consult the distilled cache before sniffing, so that a hit doesn't have to
+  // run the rewriter at all.
+  const bool cacheable =
+      speedreader_service_ &&
+      !response_head->headers->HasHeaderValue("cache-control", "no-store");
+  std::string cache_key;
+  if (cacheable) {
+    const std::string validator =
+        GetResponseValidator(*response_head->headers);
+    if (!validator.empty()) {
+      cache_key =
+          speedreader_service_->MakeDistilledCacheKey(response_url, validator);
+    }
+  }
+
   mojo::PendingRemote<network::mojom::URLLoader> new_remote;
   mojo::PendingReceiver<network::mojom::URLLoaderClient> new_receiver;
   mojo::PendingRemote<network::mojom::URLLoader> source_loader;
@@ -82,7 +115,8 @@ void SpeedReaderThrottle::WillProcessResponse(
   std::tie(new_remote, new_receiver, speedreader_loader) =
       SpeedReaderURLLoader::CreateLoader(
           AsWeakPtr(), std::move(delegate_), response_url, task_runner_,
-          rewriter_service_, speedreader_service_);
+          rewriter_service_, speedreader_service_, cacheable,
+          std::move(cache_key));
   BodySnifferThrottle::InterceptAndStartLoader(
       std::move(source_loader), std::move(source_client_receiver),
       std::move(new_remote), std::move(new_receiver), speedreader_loader);
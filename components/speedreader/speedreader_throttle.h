@@ -25,9 +25,9 @@ class SpeedreaderRewriterService;
 class SpeedreaderService;
 
 // Launches the speedreader distillation pass over a response body, deferring
-// the load until distillation is done.
-// TODO(iefremov): Avoid distilling the same page twice (see comments in
-// blink::URLLoaderThrottle)?
+// the load until distillation is done. Responses that were distilled before
+// with the same validators and reader settings are served from the profile's
+// SpeedreaderDistilledCache instead.
 // TODO(iefremov): Check throttles order?
 // Cargoculted from |MimeSniffingThrottle| -- refactored common functionality
 // between SpeedReader and de-amp urlloader / throttle into
@@ -15,14 +15,22 @@
 #include "base/files/file_util.h"
 #include "base/memory/weak_ptr.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/components/body_sniffer/body_sniffer_throttle.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "brave/components/speedreader/speedreader_distilled_cache.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
 #include "brave/components/speedreader/speedreader_service.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
 #include "brave/components/speedreader/speedreader_throttle_delegate.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
 #include "mojo/public/cpp/bindings/self_owned_receiver.h"
 
 namespace speedreader {
@@ -31,26 +39,124 @@ namespace {
 
 constexpr uint32_t kReadBufferSize = 32768;
 
+// TODO(brave-browser/issues/10372): would be better to pass explicit signal
+// back from rewriter to indicate if content was found
+constexpr size_t kMinDistilledLength = 1024;
+
+#if DCHECK_IS_ON()
+constexpr const char kCollectSwitch[] = "speedreader-collect-test-data";
+#endif
+
+bool ShouldSaveDistilledDataForDebug() {
+#if DCHECK_IS_ON()
+  return base::CommandLine::ForCurrentProcess()->HasSwitch(kCollectSwitch);
+#else
+  return false;
+#endif
+}
+
 void MaybeSaveDistilledDataForDebug(const GURL& url,
                                     const std::string& data,
-                                    const std::string& stylesheet,
-                                    const std::string& transformed) {
+                                    const std::string& result,
+                                    size_t stylesheet_length) {
 #if DCHECK_IS_ON()
-  constexpr const char kCollectSwitch[] = "speedreader-collect-test-data";
-  if (!base::CommandLine::ForCurrentProcess()->HasSwitch(kCollectSwitch))
+  if (!ShouldSaveDistilledDataForDebug())
     return;
   const auto dir = base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
       kCollectSwitch);
   base::CreateDirectory(dir);
   base::WriteFile(dir.AppendASCII("page.url"), url.spec());
   base::WriteFile(dir.AppendASCII("original.html"), data);
-  base::WriteFile(dir.AppendASCII("distilled.html"), transformed);
-  base::WriteFile(dir.AppendASCII("result.html"), stylesheet + transformed);
+  base::WriteFile(dir.AppendASCII("distilled.html"),
+                  base::StringPiece(result).substr(stylesheet_length));
+  base::WriteFile(dir.AppendASCII("result.html"), result);
 #endif
 }
 
 }  // namespace
 
+// Owns the rewriter on the worker sequence. Chunks are written as soon as they
+// are read from the source pipe, so by the time the body is complete only the
+// tail of the document is left to distill. Output is accumulated right after
+// the stylesheet so the result doesn't need another copy.
+class SpeedReaderURLLoader::Distiller {
+ public:
+  Distiller(const GURL& response_url,
+            const std::string& stylesheet,
+            bool hash_body)
+      : response_url_(response_url),
+        stylesheet_length_(stylesheet.length()),
+        output_(stylesheet),
+        save_original_(ShouldSaveDistilledDataForDebug()) {
+    if (hash_body)
+      body_hash_ = crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+  }
+  ~Distiller() = default;
+
+  Distiller(const Distiller&) = delete;
+  Distiller& operator=(const Distiller&) = delete;
+
+  static void OnOutput(const char* chunk, size_t chunk_len, void* user_data) {
+    static_cast<Distiller*>(user_data)->output_.append(chunk, chunk_len);
+  }
+
+  void set_rewriter(std::unique_ptr<Rewriter> rewriter) {
+    rewriter_ = std::move(rewriter);
+  }
+
+  void Write(std::string chunk) {
+    if (body_hash_)
+      body_hash_->Update(chunk.data(), chunk.length());
+    if (failed_)
+      return;
+    base::ElapsedTimer timer;
+    // Error occurred
+    if (rewriter_->Write(chunk.data(), chunk.length()) != 0)
+      failed_ = true;
+    distill_time_ += timer.Elapsed();
+    if (save_original_)
+      original_.append(chunk);
+  }
+
+  // Hex encoded SHA-256 of everything written so far. Can only be called once.
+  std::string GetBodyHash() {
+    DCHECK(body_hash_);
+    std::string hash(crypto::kSHA256Length, 0);
+    body_hash_->Finish(hash.data(), hash.size());
+    body_hash_.reset();
+    return base::ToLowerASCII(base::HexEncode(hash.data(), hash.size()));
+  }
+
+  // Returns the stylesheet followed by the distilled page, or nullopt if the
+  // original body should be served.
+  absl::optional<std::string> End() {
+    if (failed_)
+      return absl::nullopt;
+    base::ElapsedTimer timer;
+    const bool ended = rewriter_->End() == 0;
+    distill_time_ += timer.Elapsed();
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill", distill_time_);
+
+    if (!ended || output_.length() - stylesheet_length_ < kMinDistilledLength)
+      return absl::nullopt;
+    MaybeSaveDistilledDataForDebug(response_url_, original_, output_,
+                                   stylesheet_length_);
+    return std::move(output_);
+  }
+
+ private:
+  const GURL response_url_;
+  const size_t stylesheet_length_;
+  std::string output_;
+  std::unique_ptr<Rewriter> rewriter_;
+  bool failed_ = false;
+  base::TimeDelta distill_time_;
+  std::unique_ptr<crypto::SecureHash> body_hash_;
+
+  const bool save_original_;
+  std::string original_;
+};
+
 // static
 std::tuple<mojo::PendingRemote<network::mojom::URLLoader>,
            mojo::PendingReceiver<network::mojom::URLLoaderClient>,
@@ -61,7 +167,9 @@ SpeedReaderURLLoader::CreateLoader(
     const GURL& response_url,
     scoped_refptr<base::SingleThreadTaskRunner> task_runner,
     SpeedreaderRewriterService* rewriter_service,
-    SpeedreaderService* speedreader_service) {
+    SpeedreaderService* speedreader_service,
+    bool cacheable,
+    std::string cache_key) {
   mojo::PendingRemote<network::mojom::URLLoader> url_loader;
   mojo::PendingRemote<network::mojom::URLLoaderClient> url_loader_client;
   mojo::PendingReceiver<network::mojom::URLLoaderClient>
@@ -71,7 +179,8 @@ SpeedReaderURLLoader::CreateLoader(
   auto loader = base::WrapUnique(new SpeedReaderURLLoader(
       std::move(throttle), std::move(delegate), response_url,
       std::move(url_loader_client), std::move(task_runner), rewriter_service,
-      speedreader_service));
+      speedreader_service, cacheable, std::move(cache_key)));
+  loader->LookupDistilledCache();
   SpeedReaderURLLoader* loader_rawptr = loader.get();
   mojo::MakeSelfOwnedReceiver(std::move(loader),
                               url_loader.InitWithNewPipeAndPassReceiver());
@@ -87,7 +196,9 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
         destination_url_loader_client,
     scoped_refptr<base::SingleThreadTaskRunner> task_runner,
     SpeedreaderRewriterService* rewriter_service,
-    SpeedreaderService* speedreader_service)
+    SpeedreaderService* speedreader_service,
+    bool cacheable,
+    std::string cache_key)
     : body_sniffer::BodySnifferURLLoader(
           throttle,
           response_url,
@@ -96,21 +207,34 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       delegate_(delegate),
       response_url_(response_url),
       rewriter_service_(rewriter_service),
-      speedreader_service_(speedreader_service) {}
+      speedreader_service_(speedreader_service),
+      distiller_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::TaskPriority::USER_BLOCKING, base::MayBlock()})),
+      distiller_(nullptr, base::OnTaskRunnerDeleter(distiller_task_runner_)),
+      cacheable_(cacheable && speedreader_service),
+      cache_key_(std::move(cache_key)) {}
 
 SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
 
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   DCHECK_EQ(State::kLoading, state_);
+  if (loading_start_.is_null())
+    loading_start_ = base::TimeTicks::Now();
+  // Hold the distiller back until the cache has answered.
+  if (!cache_lookup_pending_ && !cached_distilled_)
+    MaybeStartDistiller(buffered_body_);
 
+  const size_t chunk_start = buffered_body_.size();
   if (!BodySnifferURLLoader::CheckBufferedBody(kReadBufferSize)) {
     return;
   }
 
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  if (distiller_ && buffered_body_.size() > chunk_start) {
+    distiller_task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&Distiller::Write, base::Unretained(distiller_.get()),
+                       buffered_body_.substr(chunk_start)));
+  }
 
   body_consumer_watcher_.ArmOrNotify();
 }
@@ -124,61 +248,126 @@ void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
   }
 }
 
+void SpeedReaderURLLoader::MaybeStartDistiller(
+    const std::string& body_so_far) {
+  if (distiller_ || !rewriter_service_ || !speedreader_service_)
+    return;
+  const std::string& stylesheet = rewriter_service_->GetContentStylesheet();
+  stylesheet_length_ = stylesheet.length();
+  distiller_.reset(new Distiller(response_url_, stylesheet,
+                                 cacheable_ && cache_key_.empty()));
+  // |distiller_| isn't used on the worker sequence yet, so it is safe to hand
+  // it the rewriter from here.
+  distiller_->set_rewriter(rewriter_service_->MakeRewriter(
+      response_url_, speedreader_service_->GetThemeName(),
+      speedreader_service_->GetFontFamilyName(),
+      speedreader_service_->GetFontSizeName(),
+      speedreader_service_->GetContentStyleName(), &Distiller::OnOutput,
+      distiller_.get()));
+  // Catch up with whatever was read while the cache was consulted.
+  if (!body_so_far.empty()) {
+    distiller_task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&Distiller::Write, base::Unretained(distiller_.get()),
+                       body_so_far));
+  }
+}
+
+void SpeedReaderURLLoader::LookupDistilledCache() {
+  if (!cacheable_ || cache_key_.empty())
+    return;
+  cache_lookup_pending_ = true;
+  speedreader_service_->distilled_cache()->Get(
+      cache_key_,
+      base::BindOnce(&SpeedReaderURLLoader::OnDistilledCacheLookup,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void SpeedReaderURLLoader::OnDistilledCacheLookup(
+    absl::optional<std::string> distilled) {
+  cache_lookup_pending_ = false;
+  cached_distilled_ = std::move(distilled);
+  if (pending_body_ && state_ == State::kLoading) {
+    std::string body = std::move(*pending_body_);
+    pending_body_.reset();
+    CompleteLoading(std::move(body));
+  }
+}
+
 void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   DCHECK_EQ(State::kLoading, state_);
-  if (!throttle_ || !rewriter_service_) {
+  if (!throttle_ || !rewriter_service_ || !speedreader_service_) {
     Abort();
     return;
   }
 
+  if (cache_lookup_pending_) {
+    pending_body_ = std::move(body);
+    return;
+  }
+
   VLOG(2) << __func__ << " buffered body size = " << body.size();
   bytes_remaining_in_buffer_ = body.size();
 
-  if (bytes_remaining_in_buffer_ > 0) {
-    // Offload heavy distilling to another thread.
-    base::ThreadPool::PostTaskAndReplyWithResult(
-        FROM_HERE, {base::TaskPriority::USER_BLOCKING, base::MayBlock()},
-        base::BindOnce(
-            [](const GURL& response_url, std::string data,
-               std::unique_ptr<Rewriter> rewriter,
-               const std::string& stylesheet) -> auto{
-              SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
-              int written = rewriter->Write(data.c_str(), data.length());
-              // Error occurred
-              if (written != 0) {
-                return data;
-              }
-
-              rewriter->End();
-              const std::string& transformed = rewriter->GetOutput();
-
-              // TODO(brave-browser/issues/10372): would be better to pass
-              // explicit signal back from rewriter to indicate if content was
-              // found
-              if (transformed.length() < 1024) {
-                return data;
-              }
-              MaybeSaveDistilledDataForDebug(response_url, data, stylesheet,
-                                             transformed);
-              return stylesheet + transformed;
-            },
-            response_url_, std::move(body),
-            rewriter_service_->MakeRewriter(
-                response_url_, speedreader_service_->GetThemeName(),
-                speedreader_service_->GetFontFamilyName(),
-                speedreader_service_->GetFontSizeName(),
-                speedreader_service_->GetContentStyleName()),
-            rewriter_service_->GetContentStylesheet()),
-        base::BindOnce(
-            [](base::WeakPtr<SpeedReaderURLLoader> self, std::string result) {
-              if (self) {
-                self->BodySnifferURLLoader::CompleteLoading(std::move(result));
-              }
-            },
-            weak_factory_.GetWeakPtr()));
+  if (bytes_remaining_in_buffer_ == 0) {
+    BodySnifferURLLoader::CompleteLoading(std::move(body));
+    return;
+  }
+
+  if (cached_distilled_) {
+    CompleteLoadingWithResult(base::StrCat(
+        {rewriter_service_->GetContentStylesheet(), *cached_distilled_}));
     return;
   }
-  BodySnifferURLLoader::CompleteLoading(std::move(body));
+
+  MaybeStartDistiller(body);
+  if (cacheable_ && cache_key_.empty()) {
+    // The response has no validators, identify it by its body instead. The
+    // rewriter hasn't ended yet, so a hit still skips the distillation.
+    distiller_task_runner_->PostTaskAndReplyWithResult(
+        FROM_HERE,
+        base::BindOnce(&Distiller::GetBodyHash,
+                       base::Unretained(distiller_.get())),
+        base::BindOnce(&SpeedReaderURLLoader::OnBodyHashed,
+                       weak_factory_.GetWeakPtr(), std::move(body)));
+    return;
+  }
+
+  // The rewriter has already seen the whole body, only the decision and the
+  // flush of its internal state are left.
+  distiller_task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&Distiller::End, base::Unretained(distiller_.get())),
+      base::BindOnce(&SpeedReaderURLLoader::OnDistillComplete,
+                     weak_factory_.GetWeakPtr(), std::move(body)));
+}
+
+void SpeedReaderURLLoader::OnBodyHashed(std::string body,
+                                        std::string body_hash) {
+  cache_key_ = speedreader_service_->MakeDistilledCacheKey(
+      response_url_, base::StrCat({"sha256:", body_hash}));
+  pending_body_ = std::move(body);
+  LookupDistilledCache();
+}
+
+void SpeedReaderURLLoader::OnDistillComplete(
+    std::string body,
+    absl::optional<std::string> distilled) {
+  if (!distilled) {
+    BodySnifferURLLoader::CompleteLoading(std::move(body));
+    return;
+  }
+  if (cacheable_) {
+    speedreader_service_->distilled_cache()->Put(
+        cache_key_, distilled->substr(stylesheet_length_));
+  }
+  CompleteLoadingWithResult(std::move(*distilled));
+}
+
+void SpeedReaderURLLoader::CompleteLoadingWithResult(std::string result) {
+  UMA_HISTOGRAM_TIMES("Brave.Speedreader.TimeToFirstByte",
+                      base::TimeTicks::Now() - loading_start_);
+  BodySnifferURLLoader::CompleteLoading(std::move(result));
 }
 
 void SpeedReaderURLLoader::OnCompleteSending() {
@@ -6,17 +6,21 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 
+#include <memory>
 #include <string>
 #include <tuple>
 
 #include "base/memory/raw_ptr.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/time/time.h"
 #include "brave/components/body_sniffer/body_sniffer_url_loader.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
 namespace body_sniffer {
@@ -30,7 +34,8 @@ class SpeedreaderService;
 class SpeedReaderThrottle;
 class SpeedreaderThrottleDelegate;
 
-// Loads the whole response body and tries to Speedreader-distill it.
+// Streams the response body into a Speedreader rewriter and serves either the
+// distilled page or, if distilling fails, the original body.
 // Cargoculted from |`SniffingURLLoader|.
 // Note that common functionality between this class and DeAmp has
 // been moved to component/sniffer
@@ -41,8 +46,9 @@ class SpeedreaderThrottleDelegate;
 //               finished (= OnComplete() is called). When body is provided, the
 //               state is changed to kLoading. Otherwise the state goes to
 //               kCompleted.
-// kLoading: Receives the body from the source loader and distills the page.
-//            The received body is kept in this loader until distilling
+// kLoading: Receives the body from the source loader and feeds every chunk to
+//            the rewriter on a worker sequence as it arrives. The received
+//            body is also kept in this loader as a fallback until distilling
 //            is finished. When all body has been received and distilling is
 //            done, this loader will dispatch queued messages like
 //            OnStartLoadingResponseBody() to the destination
@@ -67,7 +73,9 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
                const GURL& response_url,
                scoped_refptr<base::SingleThreadTaskRunner> task_runner,
                SpeedreaderRewriterService* rewriter_service,
-               SpeedreaderService* speedreader_service);
+               SpeedreaderService* speedreader_service,
+               bool cacheable,
+               std::string cache_key);
 
  private:
   SpeedReaderURLLoader(
@@ -78,13 +86,27 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
           destination_url_loader_client,
       scoped_refptr<base::SingleThreadTaskRunner> task_runner,
       SpeedreaderRewriterService* rewriter_service,
-      SpeedreaderService* speedreader_service);
+      SpeedreaderService* speedreader_service,
+      bool cacheable,
+      std::string cache_key);
 
   void OnBodyReadable(MojoResult) override;
   void OnBodyWritable(MojoResult) override;
 
   void CompleteLoading(std::string body) override;
   void OnCompleteSending() override;
+
+  void MaybeStartDistiller(const std::string& body_so_far);
+  void OnDistillComplete(std::string body,
+                         absl::optional<std::string> distilled);
+  void CompleteLoadingWithResult(std::string result);
+
+  void LookupDistilledCache();
+  void OnDistilledCacheLookup(absl::optional<std::string> distilled);
+  void OnBodyHashed(std::string body, std::string body_hash);
+
+  class Distiller;
+
   base::WeakPtr<SpeedreaderThrottleDelegate> delegate_;
 
   GURL response_url_;
@@ -93,6 +115,24 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
   raw_ptr<SpeedreaderRewriterService> rewriter_service_ = nullptr;
   raw_ptr<SpeedreaderService> speedreader_service_ = nullptr;
 
+  // Lives on |distiller_task_runner_|, created when the first chunk of the
+  // body arrives.
+  scoped_refptr<base::SequencedTaskRunner> distiller_task_runner_;
+  std::unique_ptr<Distiller, base::OnTaskRunnerDeleter> distiller_;
+  base::TimeTicks loading_start_;
+  size_t stylesheet_length_ = 0;
+
+  // Whether the distilled page may be stored in the profile's cache.
+  const bool cacheable_;
+  // Identifies the distilled page in the cache. Taken from the response
+  // validators, or from the body hash once the body is complete if there are
+  // none.
+  std::string cache_key_;
+  bool cache_lookup_pending_ = false;
+  absl::optional<std::string> cached_distilled_;
+  // The complete body, kept while the cache lookup is still in flight.
+  absl::optional<std::string> pending_body_;
+
   base::WeakPtrFactory<SpeedReaderURLLoader> weak_factory_{this};
 };
 
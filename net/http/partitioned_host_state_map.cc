@@ -5,47 +5,68 @@
 
 #include "brave/net/http/partitioned_host_state_map.h"
 
-#include <utility>
+#include <algorithm>
 
-#include "base/strings/strcat.h"
 #include "crypto/sha2.h"
 #include "net/base/network_isolation_key.h"
 
 namespace net {
 
-PartitionedHostStateMapBase::PartitionedHostStateMapBase() = default;
+namespace {
+
+constexpr size_t kHalfSHA256HashLength = crypto::kSHA256Length / 2;
+
+}  // namespace
+
+PartitionedHostStateMapBase::PartitionedHostStateMapBase() {
+  key_buffer_.reserve(crypto::kSHA256Length);
+}
+
 PartitionedHostStateMapBase::~PartitionedHostStateMapBase() = default;
 
-base::AutoReset<absl::optional<std::string>>
+base::AutoReset<PartitionedHostStateMapBase::PartitionHash>
 PartitionedHostStateMapBase::SetScopedPartitionHash(
-    absl::optional<std::string> partition_hash) {
+    const absl::optional<std::string>& partition_hash) {
   CHECK(!partition_hash || partition_hash->empty() ||
         partition_hash->size() == crypto::kSHA256Length);
-  return base::AutoReset<absl::optional<std::string>>(
-      &partition_hash_, std::move(partition_hash));
+  PartitionHash new_partition_hash;
+  if (partition_hash) {
+    if (partition_hash->empty()) {
+      new_partition_hash.state = PartitionHash::State::kInvalid;
+    } else {
+      new_partition_hash.state = PartitionHash::State::kValid;
+      std::copy(partition_hash->begin(), partition_hash->end(),
+                new_partition_hash.bytes.begin());
+    }
+  }
+  return base::AutoReset<PartitionHash>(&partition_hash_, new_partition_hash);
 }
 
 bool PartitionedHostStateMapBase::HasPartitionHash() const {
-  return partition_hash_.has_value();
+  return partition_hash_.state != PartitionHash::State::kUnpartitioned;
 }
 
 bool PartitionedHostStateMapBase::IsPartitionHashValid() const {
-  return partition_hash_ && !partition_hash_->empty();
+  return partition_hash_.state == PartitionHash::State::kValid;
 }
 
-std::string PartitionedHostStateMapBase::GetKeyWithPartitionHash(
+const std::string& PartitionedHostStateMapBase::GetKeyWithPartitionHash(
     const std::string& k) const {
   CHECK(IsPartitionHashValid());
-  if (k == *partition_hash_) {
+  const base::StringPiece half_key = GetHalfKey(k);
+  if (base::StringPiece(partition_hash_.bytes.data(),
+                        partition_hash_.bytes.size()) == k) {
     return k;
   }
-  return base::StrCat({GetHalfKey(k), GetHalfKey(*partition_hash_)});
+  // Both halves fit into the reserved capacity, so this doesn't allocate.
+  key_buffer_.assign(half_key.data(), half_key.size());
+  key_buffer_.append(partition_hash_.bytes.data(), kHalfSHA256HashLength);
+  return key_buffer_;
 }
 
 // static
 base::StringPiece PartitionedHostStateMapBase::GetHalfKey(base::StringPiece k) {
   CHECK_EQ(k.size(), crypto::kSHA256Length);
-  const size_t kHalfSHA256HashLength = crypto::kSHA256Length / 2;
   return k.substr(0, kHalfSHA256HashLength);
 }
 
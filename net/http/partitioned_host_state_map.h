@@ -6,19 +6,40 @@
 #ifndef BRAVE_NET_HTTP_PARTITIONED_HOST_STATE_MAP_H_
 #define BRAVE_NET_HTTP_PARTITIONED_HOST_STATE_MAP_H_
 
+#include <array>
 #include <string>
 
 #include "base/auto_reset.h"
 #include "base/ranges/algorithm.h"
 #include "base/strings/string_piece.h"
+#include "crypto/sha2.h"
 #include "net/base/net_export.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace net {
 
 // Implements partitioning support for structures in TransportSecurityState.
+//
+// HSTS is checked on every request, so lookups don't allocate: the partition
+// hash is kept inline and partitioned keys are composed in a reused buffer of
+// the fixed key size. The underlying map stays keyed by std::string because
+// upstream iterates it with std::map<std::string, ...> iterators.
 class NET_EXPORT PartitionedHostStateMapBase {
  public:
+  // Inline copy of the scoped partition hash.
+  struct PartitionHash {
+    enum class State {
+      // No partitioning, keys are used as is.
+      kUnpartitioned,
+      // Invalid/opaque partition, i.e. shouldn't be stored.
+      kInvalid,
+      kValid,
+    };
+
+    State state = State::kUnpartitioned;
+    std::array<char, crypto::kSHA256Length> bytes = {};
+  };
+
   PartitionedHostStateMapBase();
   ~PartitionedHostStateMapBase();
 
@@ -26,27 +47,27 @@ class NET_EXPORT PartitionedHostStateMapBase {
   PartitionedHostStateMapBase& operator=(const PartitionedHostStateMapBase&) =
       delete;
 
-  // Stores scoped partition hash for use in subsequent calls.
-  base::AutoReset<absl::optional<std::string>> SetScopedPartitionHash(
-      absl::optional<std::string> partition_hash);
-  // Returns true if |partition_hash_| is set. The value may be empty.
+  // Stores scoped partition hash for use in subsequent calls. nullopt means
+  // unpartitioned, an empty string an invalid partition.
+  base::AutoReset<PartitionHash> SetScopedPartitionHash(
+      const absl::optional<std::string>& partition_hash);
+  // Returns true if |partition_hash_| is set. The value may be invalid.
   bool HasPartitionHash() const;
   // Returns true if |partition_hash_| contains a non empty valid hash.
   bool IsPartitionHashValid() const;
   // Creates a host hash by concatenating first 16 bytes (half of SHA256) from
-  // |k| and first 16 bytes from |partition_hash_|.
+  // |k| and first 16 bytes from |partition_hash_|. The result is only valid
+  // until the next call.
   // CHECKs if |partition_hash_| is not valid.
-  std::string GetKeyWithPartitionHash(const std::string& k) const;
+  const std::string& GetKeyWithPartitionHash(const std::string& k) const;
 
   // Returns first 16 bytes from |k|.
   static base::StringPiece GetHalfKey(base::StringPiece k);
 
  private:
-  // Partition hash can be of these values:
-  //   nullopt - unpartitioned;
-  //   empty string - invalid/opaque partition, i.e. shouldn't be stored;
-  //   non empty string - valid partition.
-  absl::optional<std::string> partition_hash_;
+  PartitionHash partition_hash_;
+  // Storage for GetKeyWithPartitionHash(), reserved for a full key once.
+  mutable std::string key_buffer_;
 };
 
 // Allows data partitioning using half key from PartitionHash. The class mimics
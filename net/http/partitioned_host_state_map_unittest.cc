@@ -8,6 +8,8 @@
 #include <map>
 #include <string>
 
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
 #include "crypto/sha2.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -139,4 +141,33 @@ TEST(PartitionedHostStateMapTest, MultiplePartitions) {
   EXPECT_EQ(map.find(HashHost("key2"))->second, "12");
 }
 
+// Partitioned keys used to be composed with base::StrCat. Persisted state
+// depends on them, so the inline composition has to produce the same keys.
+TEST(PartitionedHostStateMapTest, KeysMatchStrCatComposition) {
+  PartitionedMap map;
+  std::map<std::string, std::string> expected;
+  for (int partition = 0; partition < 3; ++partition) {
+    const std::string partition_hash =
+        HashHost(base::StrCat({"partition", base::NumberToString(partition)}));
+    auto auto_reset_partition_hash = map.SetScopedPartitionHash(partition_hash);
+    for (int host = 0; host < 10; ++host) {
+      const std::string host_hash =
+          HashHost(base::StrCat({"host", base::NumberToString(host)}));
+      const std::string value = base::StrCat(
+          {base::NumberToString(partition), base::NumberToString(host)});
+      map[host_hash] = value;
+      expected[base::StrCat({PartitionedMap::GetHalfKey(host_hash),
+                             PartitionedMap::GetHalfKey(partition_hash)})] =
+          value;
+    }
+    // Lookups in between inserts must not disturb the composed keys.
+    EXPECT_EQ(map.find(HashHost("host0"))->second,
+              base::StrCat({base::NumberToString(partition), "0"}));
+    EXPECT_EQ(map.find(HashHost("host10")), map.end());
+  }
+
+  EXPECT_EQ(std::map<std::string, std::string>(map.begin(), map.end()),
+            expected);
+}
+
 }  // namespace net
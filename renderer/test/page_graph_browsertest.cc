@@ -0,0 +1,121 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+
+#include "base/path_service.h"
+#include "base/test/scoped_feature_list.h"
+#include "brave/components/brave_page_graph/common/features.h"
+#include "brave/components/constants/brave_paths.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/test/base/in_process_browser_test.h"
+#include "chrome/test/base/ui_test_utils.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/test/browser_test.h"
+#include "content/public/test/browser_test_utils.h"
+#include "content/public/test/test_devtools_protocol_client.h"
+#include "net/test/embedded_test_server/embedded_test_server.h"
+#include "url/gurl.h"
+
+namespace {
+
+constexpr char kDomMutationsPage[] = "/page_graph/dom_mutations.html";
+
+// Counts the edges of |edge_type| written to |graphml|.
+size_t CountEdges(const std::string& graphml, const std::string& edge_type) {
+  const std::string data = ">" + edge_type + "</data>";
+  size_t count = 0;
+  for (size_t pos = graphml.find(data); pos != std::string::npos;
+       pos = graphml.find(data, pos + data.size())) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+class PageGraphBrowserTest : public InProcessBrowserTest,
+                             public content::TestDevToolsProtocolClient,
+                             public ::testing::WithParamInterface<bool> {
+ public:
+  PageGraphBrowserTest() {
+    brave::RegisterPathProvider();
+    base::FilePath test_data_dir;
+    base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
+    embedded_test_server()->ServeFilesFromDirectory(test_data_dir);
+  }
+
+  ~PageGraphBrowserTest() override = default;
+
+  bool IsPageGraphEnabled() { return GetParam(); }
+
+  void SetUp() override {
+    if (IsPageGraphEnabled()) {
+      scoped_feature_list_.InitAndEnableFeature(
+          brave_page_graph::features::kPageGraph);
+    }
+    InProcessBrowserTest::SetUp();
+  }
+
+  void SetUpOnMainThread() override {
+    InProcessBrowserTest::SetUpOnMainThread();
+    ASSERT_TRUE(embedded_test_server()->Start());
+  }
+
+  void TearDownOnMainThread() override {
+    DetachProtocolClient();
+    InProcessBrowserTest::TearDownOnMainThread();
+  }
+
+  content::WebContents* web_contents() {
+    return browser()->tab_strip_model()->GetActiveWebContents();
+  }
+
+  content::RenderFrameHost* primary_main_frame() {
+    return web_contents()->GetPrimaryMainFrame();
+  }
+
+  std::string GeneratePageGraph() {
+    AttachToWebContents(web_contents());
+    const base::Value::Dict* result =
+        SendCommandSync("Page.generatePageGraph");
+    if (!result)
+      return std::string();
+    const std::string* data = result->FindString("data");
+    return data ? *data : std::string();
+  }
+
+ protected:
+  base::test::ScopedFeatureList scoped_feature_list_;
+};
+
+IN_PROC_BROWSER_TEST_P(PageGraphBrowserTest, DomMutations) {
+  constexpr int kRounds = 100;
+
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(
+      browser(), embedded_test_server()->GetURL(kDomMutationsPage)));
+  ASSERT_TRUE(content::ExecJs(primary_main_frame(),
+                              content::JsReplace("runDomMutations($1)",
+                                                 kRounds)));
+  if (!IsPageGraphEnabled())
+    return;
+
+  const std::string graphml = GeneratePageGraph();
+  ASSERT_FALSE(graphml.empty());
+  // Every round creates an element, inserts it and sets its attributes, and
+  // every other round removes it again.
+  EXPECT_GE(CountEdges(graphml, "create node"), static_cast<size_t>(kRounds));
+  EXPECT_GE(CountEdges(graphml, "insert node"), static_cast<size_t>(kRounds));
+  EXPECT_GE(CountEdges(graphml, "set attribute"),
+            static_cast<size_t>(kRounds));
+  EXPECT_GE(CountEdges(graphml, "remove node"),
+            static_cast<size_t>(kRounds / 2));
+}
+
+INSTANTIATE_TEST_SUITE_P(PageGraphBrowserTest,
+                         PageGraphBrowserTest,
+                         ::testing::Bool());
@@ -28,11 +28,9 @@ ItemDesc EdgeAttributeSet::GetItemDesc() const {
   return EdgeAttribute::GetItemDesc() + " [" + GetName() + "=" + value_ + "]";
 }
 
-void EdgeAttributeSet::AddGraphMLAttributes(xmlDocPtr doc,
-                                            xmlNodePtr parent_node) const {
-  EdgeAttribute::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefValue)
-      ->AddValueNode(doc, parent_node, value_);
+void EdgeAttributeSet::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  EdgeAttribute::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefValue)->AddValueNode(writer, value_);
 }
 
 bool EdgeAttributeSet::IsEdgeAttributeSet() const {
@@ -25,11 +25,9 @@ ItemName EdgeTextChange::GetItemDesc() const {
   return GraphEdge::GetItemDesc() + " [" + text_ + "]";
 }
 
-void EdgeTextChange::AddGraphMLAttributes(xmlDocPtr doc,
-                                          xmlNodePtr parent_node) const {
-  GraphEdge::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefValue)
-      ->AddValueNode(doc, parent_node, text_);
+void EdgeTextChange::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  GraphEdge::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefValue)->AddValueNode(writer, text_);
 }
 
 bool EdgeTextChange::IsEdgeTextChange() const {
@@ -18,8 +18,7 @@ class EdgeJS : public GraphEdge {
   EdgeJS(GraphItemContext* context, GraphNode* out_node, GraphNode* in_node);
   ~EdgeJS() override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   virtual const MethodName& GetMethodName() const = 0;
   bool IsEdgeJS() const override;
@@ -30,11 +30,9 @@ ItemDesc EdgeJSResult::GetItemDesc() const {
   return GetItemName() + " [result: " + result_ + "]";
 }
 
-void EdgeJSResult::AddGraphMLAttributes(xmlDocPtr doc,
-                                        xmlNodePtr parent_node) const {
-  EdgeJS::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefValue)
-      ->AddValueNode(doc, parent_node, result_);
+void EdgeJSResult::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  EdgeJS::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefValue)->AddValueNode(writer, result_);
 }
 
 const std::string& EdgeJSResult::GetResult() const {
@@ -36,8 +36,7 @@ class EdgeRequestResponse : public EdgeRequest {
 
   ItemName GetItemName() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   bool IsEdgeRequestResponse() const override;
 
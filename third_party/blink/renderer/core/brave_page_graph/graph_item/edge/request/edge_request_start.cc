@@ -36,11 +36,10 @@ ItemDesc EdgeRequestStart::GetItemDesc() const {
   return EdgeRequest::GetItemDesc() + " [" + resource_type_ + "]";
 }
 
-void EdgeRequestStart::AddGraphMLAttributes(xmlDocPtr doc,
-                                            xmlNodePtr parent_node) const {
-  EdgeRequest::AddGraphMLAttributes(doc, parent_node);
+void EdgeRequestStart::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  EdgeRequest::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefResourceType)
-      ->AddValueNode(doc, parent_node, resource_type_);
+      ->AddValueNode(writer, resource_type_);
 }
 
 bool EdgeRequestStart::IsEdgeRequestStart() const {
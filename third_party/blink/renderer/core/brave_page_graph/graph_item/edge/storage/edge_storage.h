@@ -27,8 +27,7 @@ class EdgeStorage : public GraphEdge {
 
   ItemName GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   bool IsEdgeStorage() const override;
 
@@ -30,11 +30,9 @@ ItemDesc EdgeStorageReadResult::GetItemDesc() const {
   return EdgeStorage::GetItemDesc() + " [value: " + value_ + "]";
 }
 
-void EdgeStorageReadResult::AddGraphMLAttributes(xmlDocPtr doc,
-                                                 xmlNodePtr parent_node) const {
-  EdgeStorage::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefValue)
-      ->AddValueNode(doc, parent_node, value_);
+void EdgeStorageReadResult::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  EdgeStorage::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefValue)->AddValueNode(writer, value_);
 }
 
 bool EdgeStorageReadResult::IsEdgeStorageReadResult() const {
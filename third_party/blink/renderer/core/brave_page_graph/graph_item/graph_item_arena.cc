@@ -0,0 +1,46 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/graph_item_arena.h"
+
+#include <algorithm>
+
+#include "base/bits.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/graph_item.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+// Fits a few hundred items, the largest ones take around 200 bytes.
+constexpr size_t kBlockSize = 64 * 1024;
+
+}  // namespace
+
+GraphItemArena::GraphItemArena() = default;
+
+GraphItemArena::~GraphItemArena() {
+  for (auto it = items_.rbegin(); it != items_.rend(); ++it) {
+    (*it)->~GraphItem();
+  }
+}
+
+void* GraphItemArena::Allocate(size_t size) {
+  size = base::bits::AlignUp(size, alignof(std::max_align_t));
+  if (static_cast<size_t>(end_ - next_) < size) {
+    // The remainder of the current block is wasted, items are small enough
+    // that this is never much.
+    const size_t block_size = std::max(size, kBlockSize);
+    // Not value-initialized, unlike std::make_unique<char[]>().
+    blocks_.push_back(std::unique_ptr<char[]>(new char[block_size]));
+    next_ = blocks_.back().get();
+    end_ = next_ + block_size;
+  }
+  void* memory = next_;
+  next_ += size;
+  return memory;
+}
+
+}  // namespace brave_page_graph
@@ -0,0 +1,56 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_ARENA_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace brave_page_graph {
+
+class GraphItem;
+
+// Owns the items of a page graph. Items are carved out of large blocks instead
+// of being allocated one by one, and since graph items live as long as the
+// graph, they're only destroyed together with the arena.
+class GraphItemArena {
+ public:
+  GraphItemArena();
+  ~GraphItemArena();
+
+  GraphItemArena(const GraphItemArena&) = delete;
+  GraphItemArena& operator=(const GraphItemArena&) = delete;
+
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    static_assert(std::is_base_of<GraphItem, T>::value,
+                  "GraphItemArena only holds graph items");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned graph items aren't supported");
+    T* item = new (Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    items_.push_back(item);
+    return item;
+  }
+
+  size_t size() const { return items_.size(); }
+
+ private:
+  void* Allocate(size_t size);
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* next_ = nullptr;
+  char* end_ = nullptr;
+  // In creation order, destroyed in reverse.
+  std::vector<GraphItem*> items_;
+};
+
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_ARENA_H_
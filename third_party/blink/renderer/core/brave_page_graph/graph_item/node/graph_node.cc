@@ -6,6 +6,7 @@
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/node/graph_node.h"
 
 #include "base/strings/string_number_conversions.h"
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/graph_edge.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
 
@@ -27,23 +28,21 @@ GraphMLId GraphNode::GetGraphMLId() const {
   return "n" + base::NumberToString(GetId());
 }
 
-void GraphNode::AddGraphMLTag(xmlDocPtr doc, xmlNodePtr parent_node) const {
-  xmlNodePtr new_node =
-      xmlNewChild(parent_node, nullptr, BAD_CAST "node", nullptr);
-  xmlSetProp(new_node, BAD_CAST "id", BAD_CAST GetGraphMLId().c_str());
-  AddGraphMLAttributes(doc, new_node);
+void GraphNode::AddGraphMLTag(GraphMLWriter* writer) const {
+  writer->StartElement("node");
+  writer->AddIdAttribute("id", 'n', GetId());
+  AddGraphMLAttributes(writer);
+  writer->EndElement();
 }
 
-void GraphNode::AddGraphMLAttributes(xmlDocPtr doc,
-                                     xmlNodePtr parent_node) const {
-  GraphItem::AddGraphMLAttributes(doc, parent_node);
+void GraphNode::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  GraphItem::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefNodeType)
-      ->AddValueNode(doc, parent_node, GetItemName());
+      ->AddValueNode(writer, GetItemName());
   GraphMLAttrDefForType(kGraphMLAttrDefPageGraphNodeId)
-      ->AddValueNode(doc, parent_node, GetId());
+      ->AddValueNode(writer, GetId());
   GraphMLAttrDefForType(kGraphMLAttrDefPageGraphNodeTimestamp)
-      ->AddValueNode(doc, parent_node,
-                     GetTimeDeltaSincePageStart().InMilliseconds());
+      ->AddValueNode(writer, GetTimeDeltaSincePageStart().InMilliseconds());
 }
 
 bool GraphNode::IsNode() const {
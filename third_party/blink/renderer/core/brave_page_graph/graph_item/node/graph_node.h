@@ -26,9 +26,8 @@ class GraphNode : public GraphItem {
   virtual void AddOutEdge(const GraphEdge* out_edge);
 
   GraphMLId GetGraphMLId() const override;
-  void AddGraphMLTag(xmlDocPtr doc, xmlNodePtr parent_node) const override;
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLTag(GraphMLWriter* writer) const override;
+  void AddGraphMLAttributes(GraphMLWriter* writer) const override;
 
   bool IsNode() const override;
 
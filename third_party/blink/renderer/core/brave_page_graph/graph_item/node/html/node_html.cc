@@ -36,13 +36,12 @@ ItemDesc NodeHTML::GetItemDesc() const {
   return builder.str();
 }
 
-void NodeHTML::AddGraphMLAttributes(xmlDocPtr doc,
-                                    xmlNodePtr parent_node) const {
-  GraphNode::AddGraphMLAttributes(doc, parent_node);
+void NodeHTML::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  GraphNode::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefNodeId)
-      ->AddValueNode(doc, parent_node, dom_node_id_);
+      ->AddValueNode(writer, dom_node_id_);
   GraphMLAttrDefForType(kGraphMLAttrDefIsDeleted)
-      ->AddValueNode(doc, parent_node, is_deleted_);
+      ->AddValueNode(writer, is_deleted_);
 }
 
 void NodeHTML::AddInEdge(const GraphEdge* in_edge) {
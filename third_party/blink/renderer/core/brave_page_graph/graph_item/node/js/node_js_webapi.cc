@@ -26,11 +26,10 @@ ItemDesc NodeJSWebAPI::GetItemDesc() const {
   return GraphNode::GetItemDesc() + " [" + method_name_ + "]";
 }
 
-void NodeJSWebAPI::AddGraphMLAttributes(xmlDocPtr doc,
-                                        xmlNodePtr parent_node) const {
-  NodeJS::AddGraphMLAttributes(doc, parent_node);
+void NodeJSWebAPI::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  NodeJS::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefMethodName)
-      ->AddValueNode(doc, parent_node, method_name_);
+      ->AddValueNode(writer, method_name_);
 }
 
 bool NodeJSWebAPI::IsNodeJSWebAPI() const {
@@ -27,11 +27,9 @@ ItemDesc NodeResource::GetItemDesc() const {
   return GraphNode::GetItemDesc() + " [" + url_ + "]";
 }
 
-void NodeResource::AddGraphMLAttributes(xmlDocPtr doc,
-                                        xmlNodePtr parent_node) const {
-  GraphNode::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefURL)
-      ->AddValueNode(doc, parent_node, url_);
+void NodeResource::AddGraphMLAttributes(GraphMLWriter* writer) const {
+  GraphNode::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefURL)->AddValueNode(writer, url_);
 }
 
 bool NodeResource::IsNodeResource() const {
@@ -5,15 +5,13 @@
 
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
 
-#include <libxml/entities.h>
-#include <libxml/tree.h>
-
 #include <map>
 #include <string>
 #include <vector>
 
 #include "base/no_destructor.h"
 #include "base/strings/string_number_conversions.h"
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
 
 namespace brave_page_graph {
@@ -25,98 +23,87 @@ uint32_t graphml_index = 0;
 GraphMLAttr::GraphMLAttr(const GraphMLAttrForType for_value,
                          const std::string& name,
                          const GraphMLAttrType type)
-    : id_(++graphml_index), for_(for_value), name_(name), type_(type) {}
-
-GraphMLId GraphMLAttr::GetGraphMLId() const {
-  return "d" + base::NumberToString(id_);
-}
-
-void GraphMLAttr::AddDefinitionNode(xmlNodePtr parent_node) const {
-  xmlNodePtr new_node =
-      xmlNewChild(parent_node, nullptr, BAD_CAST "key", nullptr);
-  xmlSetProp(new_node, BAD_CAST "id", BAD_CAST GetGraphMLId().c_str());
-  xmlSetProp(new_node, BAD_CAST "for",
-             BAD_CAST GraphMLForTypeToString(for_).c_str());
-  xmlSetProp(new_node, BAD_CAST "attr.name", BAD_CAST name_.c_str());
-  xmlSetProp(new_node, BAD_CAST "attr.type",
-             BAD_CAST GraphMLAttrTypeToString(type_).c_str());
+    : id_(++graphml_index),
+      for_(for_value),
+      name_(name),
+      type_(type),
+      graphml_id_("d" + base::NumberToString(id_)) {}
+
+void GraphMLAttr::AddDefinitionNode(GraphMLWriter* writer) const {
+  writer->StartElement("key");
+  writer->AddAttribute("id", GetGraphMLId());
+  writer->AddAttribute("for", GraphMLForTypeToString(for_));
+  writer->AddAttribute("attr.name", name_);
+  writer->AddAttribute("attr.type", GraphMLAttrTypeToString(type_));
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
-                               const char* value) const {
-  AddValueNode(doc, parent_node, std::string(value));
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer, const char* value) const {
+  CHECK(type_ == kGraphMLAttrTypeString);
+  StartDataElement(writer);
+  // String values used to be entity encoded before they were added to the
+  // tree, everything else was added as is.
+  writer->AddEncodedText(value);
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer,
                                const std::string& value) const {
   CHECK(type_ == kGraphMLAttrTypeString);
-  xmlChar* encoded_content =
-      xmlEncodeEntitiesReentrant(doc, BAD_CAST value.c_str());
-  xmlNodePtr new_node =
-      xmlNewChild(parent_node, nullptr, BAD_CAST "data", encoded_content);
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
-  xmlFree(encoded_content);
+  StartDataElement(writer);
+  writer->AddEncodedText(value);
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
-                               const int value) const {
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer, const int value) const {
   CHECK(type_ == kGraphMLAttrTypeInt);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  StartDataElement(writer);
+  writer->AddNumberText(value);
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
-                               const bool value) const {
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer, const bool value) const {
   CHECK(type_ == kGraphMLAttrTypeBoolean);
-  xmlNodePtr new_node = xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                                        BAD_CAST(value ? "true" : "false"));
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  StartDataElement(writer);
+  writer->AddText(value ? "true" : "false");
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer,
                                const int64_t value) const {
   CHECK(type_ == kGraphMLAttrTypeString);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  StartDataElement(writer);
+  writer->AddNumberText(value);
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer,
                                const uint64_t value) const {
   CHECK(type_ == kGraphMLAttrTypeString);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  StartDataElement(writer);
+  writer->AddUnsignedNumberText(value);
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer,
                                const double value) const {
   CHECK(type_ == kGraphMLAttrTypeDouble);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  StartDataElement(writer);
+  writer->AddText(base::NumberToString(value));
+  writer->EndElement();
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter* writer,
                                const base::TimeDelta value) const {
   CHECK(type_ == kGraphMLAttrTypeInt);
-  xmlNodePtr new_node = xmlNewTextChild(
-      parent_node, nullptr, BAD_CAST "data",
-      BAD_CAST base::NumberToString(value.InMilliseconds()).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  StartDataElement(writer);
+  writer->AddNumberText(value.InMilliseconds());
+  writer->EndElement();
+}
+
+void GraphMLAttr::StartDataElement(GraphMLWriter* writer) const {
+  writer->StartElement("data");
+  writer->AddAttribute("key", GetGraphMLId());
 }
 
 const GraphMLAttrs& GetGraphMLAttrs() {
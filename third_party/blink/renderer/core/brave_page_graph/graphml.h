@@ -6,7 +6,6 @@
 #ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPHML_H_
 #define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPHML_H_
 
-#include <libxml/tree.h>
 #include <string>
 #include <vector>
 
@@ -16,44 +15,34 @@
 
 namespace brave_page_graph {
 
+class GraphMLWriter;
+
 class GraphMLAttr {
  public:
   GraphMLAttr(const GraphMLAttrForType for_value,
               const std::string& name,
               const GraphMLAttrType type = kGraphMLAttrTypeString);
 
-  GraphMLId GetGraphMLId() const;
-  void AddDefinitionNode(xmlNodePtr parent_node) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const char* value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const std::string& value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const int value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const bool value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const int64_t value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const uint64_t value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const double value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const base::TimeDelta value) const;
+  const GraphMLId& GetGraphMLId() const { return graphml_id_; }
+  void AddDefinitionNode(GraphMLWriter* writer) const;
+  void AddValueNode(GraphMLWriter* writer, const char* value) const;
+  void AddValueNode(GraphMLWriter* writer, const std::string& value) const;
+  void AddValueNode(GraphMLWriter* writer, const int value) const;
+  void AddValueNode(GraphMLWriter* writer, const bool value) const;
+  void AddValueNode(GraphMLWriter* writer, const int64_t value) const;
+  void AddValueNode(GraphMLWriter* writer, const uint64_t value) const;
+  void AddValueNode(GraphMLWriter* writer, const double value) const;
+  void AddValueNode(GraphMLWriter* writer, const base::TimeDelta value) const;
 
  protected:
+  // Leaves the element open for the value to be added.
+  void StartDataElement(GraphMLWriter* writer) const;
+
   const uint64_t id_;
   const GraphMLAttrForType for_;
   const std::string name_;
   const GraphMLAttrType type_;
+  const GraphMLId graphml_id_;
 };
 
 using GraphMLAttrs = base::flat_map<GraphMLAttrDef, const GraphMLAttr*>;
@@ -5,8 +5,6 @@
 
 #include "brave/third_party/blink/renderer/core/brave_page_graph/page_graph.h"
 
-#include <libxml/tree.h>
-
 #include <signal.h>
 #include <climits>
 #include <iostream>
@@ -21,6 +19,8 @@
 #include "base/json/json_string_value_serializer.h"
 #include "base/no_destructor.h"
 #include "brave/components/brave_page_graph/common/features.h"
+#include "brave/components/brave_page_graph/common/binary_graph.h"
+#include "brave/components/brave_page_graph/common/graphml_writer.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/attribute/edge_attribute_delete.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/attribute/edge_attribute_set.h"
@@ -157,6 +157,7 @@ using brave_page_graph::EdgeStorageSet;
 using brave_page_graph::EdgeStructure;
 using brave_page_graph::EdgeTextChange;
 using brave_page_graph::GraphItem;
+using brave_page_graph::GraphItemArena;
 using brave_page_graph::GraphItemId;
 using brave_page_graph::ItemName;
 using brave_page_graph::NodeActor;
@@ -866,10 +867,11 @@ GraphItemId PageGraph::GetNextGraphItemId() {
   return ++id_counter_;
 }
 
-void PageGraph::AddGraphItem(std::unique_ptr<GraphItem> graph_item) {
-  GraphItem* item = graph_item.get();
-  graph_items_.push_back(std::move(graph_item));
+GraphItemArena& PageGraph::GetGraphItemArena() {
+  return graph_items_;
+}
 
+void PageGraph::AddGraphItem(GraphItem* item) {
   if (auto* graph_node = DynamicTo<GraphNode>(item)) {
     nodes_.push_back(graph_node);
     if (auto* element_node = DynamicTo<NodeHTMLElement>(graph_node)) {
@@ -956,68 +958,61 @@ void PageGraph::GenerateReportForNode(const blink::DOMNodeId node_id,
 }
 
 String PageGraph::ToGraphML() const {
-  xmlDocPtr graphml_doc = xmlNewDoc(BAD_CAST "1.0");
-  xmlNodePtr graphml_root_node = xmlNewNode(nullptr, BAD_CAST "graphml");
-  xmlDocSetRootElement(graphml_doc, graphml_root_node);
-
-  xmlNewNs(graphml_root_node, BAD_CAST "http://graphml.graphdrawing.org/xmlns",
-           nullptr);
-  xmlNsPtr xsi_ns = xmlNewNs(
-      graphml_root_node, BAD_CAST "http://www.w3.org/2001/XMLSchema-instance",
-      BAD_CAST "xsi");
-  xmlNewNsProp(graphml_root_node, xsi_ns, BAD_CAST "schemaLocation",
-               BAD_CAST
-               "http://graphml.graphdrawing.org/xmlns "
-               "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
-
-  xmlNodePtr desc_container_node =
-      xmlNewChild(graphml_root_node, nullptr, BAD_CAST "desc", nullptr);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "version",
-                  BAD_CAST kPageGraphVersion);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "about",
-                  BAD_CAST kPageGraphUrl);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "is_root",
-                  BAD_CAST(IsRootFrame() ? "true" : "false"));
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "frame_id",
-                  BAD_CAST frame_id_.c_str());
-
-  xmlNodePtr time_container_node =
-      xmlNewChild(desc_container_node, nullptr, BAD_CAST "time", nullptr);
-
-  xmlNewTextChild(time_container_node, nullptr, BAD_CAST "start",
-                  BAD_CAST base::NumberToString(0).c_str());
+  // Items take a few hundred bytes each, reserving for that avoids most of the
+  // regrowth on large graphs.
+  GraphMLTextWriter writer((nodes_.size() + edges_.size()) * 256);
+  WriteGraphML(&writer);
+
+  const std::string graphml = writer.Finish();
+  auto graphml_string = String::FromUTF8(graphml.data(), graphml.size());
+  DCHECK(!graphml_string.empty());
+  return graphml_string;
+}
+
+std::string PageGraph::ToBinary(bool compress) const {
+  BinaryGraphWriter writer(compress);
+  WriteGraphML(&writer);
+  return writer.Finish();
+}
 
+void PageGraph::WriteGraphML(GraphMLWriter* writer) const {
+  writer->StartElement("graphml");
+  writer->AddAttribute("xmlns", "http://graphml.graphdrawing.org/xmlns");
+  writer->AddAttribute("xmlns:xsi",
+                       "http://www.w3.org/2001/XMLSchema-instance");
+  writer->AddAttribute(
+      "xsi:schemaLocation",
+      "http://graphml.graphdrawing.org/xmlns "
+      "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
+
+  writer->StartElement("desc");
+  writer->AddTextElement("version", kPageGraphVersion);
+  writer->AddTextElement("about", kPageGraphUrl);
+  writer->AddTextElement("is_root", IsRootFrame() ? "true" : "false");
+  writer->AddTextElement("frame_id", frame_id_);
+
+  writer->StartElement("time");
+  writer->AddTextElement("start", base::NumberToString(0));
   const base::TimeDelta end_time = base::TimeTicks::Now() - start_;
-  xmlNewTextChild(
-      time_container_node, nullptr, BAD_CAST "end",
-      BAD_CAST base::NumberToString(end_time.InMilliseconds()).c_str());
+  writer->AddTextElement("end",
+                         base::NumberToString(end_time.InMilliseconds()));
+  writer->EndElement();  // time
+  writer->EndElement();  // desc
 
   for (const auto& graphml_attr : brave_page_graph::GetGraphMLAttrs()) {
-    graphml_attr.second->AddDefinitionNode(graphml_root_node);
+    graphml_attr.second->AddDefinitionNode(writer);
   }
 
-  xmlNodePtr graph_node =
-      xmlNewChild(graphml_root_node, nullptr, BAD_CAST "graph", nullptr);
-  xmlSetProp(graph_node, BAD_CAST "id", BAD_CAST "G");
-  xmlSetProp(graph_node, BAD_CAST "edgedefault", BAD_CAST "directed");
+  writer->StartElement("graph");
+  writer->AddAttribute("id", "G");
+  writer->AddAttribute("edgedefault", "directed");
 
   for (const auto* node : nodes_) {
-    node->AddGraphMLTag(graphml_doc, graph_node);
+    node->AddGraphMLTag(writer);
   }
   for (const auto* edge : edges_) {
-    edge->AddGraphMLTag(graphml_doc, graph_node);
+    edge->AddGraphMLTag(writer);
   }
-
-  xmlChar* xml_string;
-  int size;
-  xmlDocDumpMemoryEnc(graphml_doc, &xml_string, &size, "UTF-8");
-  auto graphml_string = String::FromUTF8(xml_string, size);
-  DCHECK(!graphml_string.empty());
-
-  xmlFree(xml_string);
-  xmlFree(graphml_doc);
-
-  return graphml_string;
 }
 
 NodeHTML* PageGraph::GetHTMLNode(const DOMNodeId node_id) const {
@@ -7,12 +7,14 @@
 #define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_PAGE_GRAPH_H_
 
 #include <map>
-#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "base/strings/string_piece.h"
 #include "base/time/time.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/blink_probe_types.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/graph_item_arena.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/page_graph_context.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/requests/request_tracker.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/scripts/script_tracker.h"
@@ -37,6 +39,7 @@ class UnguessableToken;
 namespace brave_page_graph {
 
 class GraphEdge;
+class GraphMLWriter;
 class GraphNode;
 class NodeActor;
 class NodeAdFilter;
@@ -222,12 +225,16 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   // PageGraphContext:
   base::TimeTicks GetGraphStartTime() const override;
   brave_page_graph::GraphItemId GetNextGraphItemId() override;
-  void AddGraphItem(
-      std::unique_ptr<brave_page_graph::GraphItem> graph_item) override;
+  brave_page_graph::GraphItemArena& GetGraphItemArena() override;
+  void AddGraphItem(brave_page_graph::GraphItem* graph_item) override;
 
   void GenerateReportForNode(const blink::DOMNodeId node_id,
                              blink::protocol::Array<String>& report);
   String ToGraphML() const;
+  // Compact recording of the graph, see BinaryGraphWriter. It's turned into
+  // the same GraphML as ToGraphML() by the page_graph_to_graphml tool. Empty if
+  // the recording couldn't be compressed.
+  std::string ToBinary(bool compress) const;
 
  private:
 #define PAGE_GRAPH_USING_DECL(type) using type = brave_page_graph::type
@@ -239,7 +246,8 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   PAGE_GRAPH_USING_DECL(FingerprintingRule);
   PAGE_GRAPH_USING_DECL(GraphEdge);
   PAGE_GRAPH_USING_DECL(GraphItemId);
-  PAGE_GRAPH_USING_DECL(GraphItemUniquePtrList);
+  PAGE_GRAPH_USING_DECL(GraphItemArena);
+  PAGE_GRAPH_USING_DECL(GraphMLWriter);
   PAGE_GRAPH_USING_DECL(GraphNode);
   PAGE_GRAPH_USING_DECL(InspectorId);
   PAGE_GRAPH_USING_DECL(MethodName);
@@ -278,6 +286,8 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
     NodeExtensions* extensions_node;
   };
 
+  void WriteGraphML(GraphMLWriter* writer) const;
+
   NodeHTML* GetHTMLNode(const blink::DOMNodeId node_id) const;
   NodeHTMLElement* GetHTMLElementNode(const blink::DOMNodeId node_id) const;
   NodeHTMLText* GetHTMLTextNode(const blink::DOMNodeId node_id) const;
@@ -439,10 +449,9 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   // the graph's construction if needed.
   GraphItemId id_counter_ = 0;
 
-  // These vectors own all of the items that are shared and indexed across
-  // the rest of the graph.  All the other pointers (the weak pointers)
-  // do not own their data.
-  GraphItemUniquePtrList graph_items_;
+  // Owns all of the items that are shared and indexed across the rest of the
+  // graph.  All the other pointers (the weak pointers) do not own their data.
+  GraphItemArena graph_items_;
   EdgeList edges_;
   NodeList nodes_;
 
@@ -458,30 +467,36 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   base::flat_map<blink::UntracedMember<blink::Node>, bool>
       currently_constructed_nodes_;
 
+  // Lookup tables keyed by strings don't copy them, the keys point into the
+  // nodes they map to, which never move or go away before the graph.
+  template <typename T>
+  using NodesByString =
+      std::unordered_map<base::StringPiece, T*, base::StringPieceHash>;
+
   // Index structure for looking up HTML nodes.
   // This map does not own the references.
-  std::map<blink::DOMNodeId, NodeHTMLElement*> element_nodes_;
-  std::map<blink::DOMNodeId, NodeHTMLText*> text_nodes_;
+  std::unordered_map<blink::DOMNodeId, NodeHTMLElement*> element_nodes_;
+  std::unordered_map<blink::DOMNodeId, NodeHTMLText*> text_nodes_;
 
   // Makes sure we don't have more than one node in the graph representing
   // a single URL (not required for correctness, but keeps things tidier
   // and makes some kinds of queries nicer).
-  std::map<RequestURL, NodeResource*> resource_nodes_;
+  NodesByString<NodeResource> resource_nodes_;
 
   // Index structure for looking up binding nodes.
   // This map does not own the references.
-  std::map<Binding, NodeBinding*> binding_nodes_;
+  std::unordered_map<Binding, NodeBinding*> binding_nodes_;
   // Index structure for storing and looking up webapi nodes.
   // This map does not own the references.
-  std::map<MethodName, NodeJSWebAPI*> js_webapi_nodes_;
+  NodesByString<NodeJSWebAPI> js_webapi_nodes_;
   // Index structure for storing and looking up nodes representing built
   // in JS funcs and methods. This map does not own the references.
-  std::map<MethodName, NodeJSBuiltin*> js_builtin_nodes_;
+  NodesByString<NodeJSBuiltin> js_builtin_nodes_;
 
   // Index structure for looking up filter nodes.
   // These maps do not own the references.
-  std::map<std::string, NodeAdFilter*> ad_filter_nodes_;
-  std::map<std::string, NodeTrackerFilter*> tracker_filter_nodes_;
+  NodesByString<NodeAdFilter> ad_filter_nodes_;
+  NodesByString<NodeTrackerFilter> tracker_filter_nodes_;
   std::map<FingerprintingRule, NodeFingerprintingFilter*>
       fingerprinting_filter_nodes_;
 